@@ -25,14 +25,47 @@ For a copy of the GNU General Public License see file COPYING.
 #include "oalsfxpp.h"
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <limits>
+#include <mutex>
 #include <new>
+#include <system_error>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
 
+// Define OALSFXPP_NO_SIMD to use the portable mixing kernels only.
+#if !defined(OALSFXPP_NO_SIMD) && \
+	(defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define OALSFXPP_X86_SIMD
+#endif
+
+#ifdef OALSFXPP_X86_SIMD
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include <immintrin.h>
+#endif
+
+// Enables the instruction set for a function (GCC and Clang only; MSVC doesn't need it).
+#if defined(__GNUC__) || defined(__clang__)
+#define OALSFXPP_TARGET(x) __attribute__((target(x)))
+#else
+#define OALSFXPP_TARGET(x)
+#endif
+
+
 namespace oalsfxpp
 {
 
@@ -48,6 +81,27 @@ constexpr auto max_effects = 4;
 
 constexpr auto max_effect_channels = 4;
 
+constexpr auto min_sources = 1;
+constexpr auto max_sources = 256;
+
+constexpr auto min_block_size = 16;
+constexpr auto max_block_size = 16'384;
+
+constexpr auto min_workers = 0;
+constexpr auto max_workers = 16;
+
+constexpr auto min_scheduler_workers = 0;
+constexpr auto max_scheduler_workers = 255;
+
+constexpr auto max_scheduled_events = 256;
+
+// The states of the new effect types per effect slot waiting for the mixing (without the pooling).
+constexpr auto max_pending_effect_states = 8;
+
+constexpr auto max_distortion_oversampling_factor = 8;
+
+constexpr auto max_filter_cascade_stages = 4;
+
 constexpr auto min_sampling_rate = 8'000;
 constexpr auto max_sampling_rate = 8'000'000;
 
@@ -61,13 +115,6 @@ constexpr auto silence_threshold_gain = 0.000'01F; // -100dB
 constexpr auto max_ambi_order = 3;
 constexpr auto max_ambi_coeffs = (max_ambi_order + 1) * (max_ambi_order + 1);
 
-// Size for temporary storage of buffer data, in ALfloats. Larger values need
-// more memory, while smaller values may need more iterations. The value needs
-// to be a sensible size, however, as it constrains the max stepping value used
-// for mixing, as well as the maximum number of samples per mixing iteration.
-constexpr auto max_sample_buffer_size = 2048;
-
-
 enum class ChannelId
 {
 	none,
@@ -112,13 +159,437 @@ enum class ActiveFilters
 }; // ActiveFilters
 
 
+// Marks a call which must be real-time safe (see RtChecks).
+//
+// The scopes nest; a violation is attributed to the innermost call.
+class RtScope
+{
+public:
+	explicit RtScope(
+		const char* const call_site,
+		const char* const effect_state = nullptr)
+#ifdef OALSFXPP_RT_CHECKS
+		:
+		previous_call_site_{call_site_},
+		previous_effect_state_{effect_state_}
+	{
+		call_site_ = call_site;
+
+		if (effect_state)
+		{
+			effect_state_ = effect_state;
+		}
+	}
+#else
+	{
+		static_cast<void>(call_site);
+		static_cast<void>(effect_state);
+	}
+#endif
+
+	RtScope(
+		const RtScope& that) = delete;
+
+	RtScope& operator=(
+		const RtScope& that) = delete;
+
+#ifdef OALSFXPP_RT_CHECKS
+	~RtScope()
+	{
+		call_site_ = previous_call_site_;
+		effect_state_ = previous_effect_state_;
+	}
+#endif
+
+
+	// Reports the violation if the current thread is within a real-time safe call.
+	static void check(
+		const RtChecks::ViolationType type,
+		const std::size_t size)
+	{
+#ifdef OALSFXPP_RT_CHECKS
+		if (!call_site_ || is_reporting_)
+		{
+			return;
+		}
+
+		// The handler may allocate (e.g. to log the violation).
+		is_reporting_ = true;
+
+		const auto violation = RtChecks::Violation{type, call_site_, effect_state_, size};
+
+		violation_handler_(violation, violation_handler_user_data_);
+
+		is_reporting_ = false;
+#else
+		static_cast<void>(type);
+		static_cast<void>(size);
+#endif
+	}
+
+
+#ifdef OALSFXPP_RT_CHECKS
+	static RtChecks::ViolationHandler violation_handler_;
+	static void* violation_handler_user_data_;
+
+
+	static void default_violation_handler(
+		const RtChecks::Violation& violation,
+		void* const user_data)
+	{
+		static_cast<void>(user_data);
+
+		const char* type_name;
+
+		switch (violation.type_)
+		{
+		case RtChecks::ViolationType::allocation:
+			type_name = "Allocation";
+			break;
+
+		case RtChecks::ViolationType::deallocation:
+			type_name = "Deallocation";
+			break;
+
+		case RtChecks::ViolationType::blocking_call:
+		default:
+			type_name = "Blocking call";
+			break;
+		}
+
+		std::fprintf(
+			stderr,
+			"oalsfxpp: %s (%zu bytes) in %s (effect state: %s).\n",
+			type_name,
+			violation.size_,
+			violation.call_site_,
+			violation.effect_state_ ? violation.effect_state_ : "none");
+
+		std::abort();
+	}
+
+
+private:
+	static thread_local const char* call_site_;
+	static thread_local const char* effect_state_;
+	static thread_local bool is_reporting_;
+
+
+	const char* previous_call_site_;
+	const char* previous_effect_state_;
+#endif
+}; // RtScope
+
+
+#ifdef OALSFXPP_RT_CHECKS
+RtChecks::ViolationHandler RtScope::violation_handler_ = RtScope::default_violation_handler;
+void* RtScope::violation_handler_user_data_ = nullptr;
+thread_local const char* RtScope::call_site_ = nullptr;
+thread_local const char* RtScope::effect_state_ = nullptr;
+thread_local bool RtScope::is_reporting_ = false;
+#endif
+
+
+// The buffers and effect states of an instance laid out in one block.
+//
+// The memory is handed out sequentially and released all at once with the block.
+// The allocations which don't fit into the block are passed to the memory resource.
+class Arena
+{
+public:
+	// The alignment of the allocations (i.e. a cache line size).
+	static constexpr auto alignment = std::size_t{64};
+
+
+	explicit Arena(
+		MemoryResource& memory_resource)
+		:
+		memory_resource_{&memory_resource},
+		data_{},
+		size_{},
+		used_size_{},
+		measured_size_{}
+	{
+	}
+
+	Arena(
+		const Arena& that) = delete;
+
+	Arena& operator=(
+		const Arena& that) = delete;
+
+	~Arena()
+	{
+		uninitialize();
+	}
+
+
+	// Allocates the block.
+	//
+	// Returns true on success or false otherwise.
+	bool initialize(
+		const std::size_t size)
+	{
+		uninitialize();
+
+		if (size == 0)
+		{
+			return true;
+		}
+
+		data_ = static_cast<unsigned char*>(memory_resource_->allocate(size, alignment));
+
+		if (!data_)
+		{
+			return false;
+		}
+
+		size_ = size;
+
+		return true;
+	}
+
+	void uninitialize()
+	{
+		if (data_)
+		{
+			memory_resource_->deallocate(data_, size_, alignment);
+		}
+
+		data_ = nullptr;
+		size_ = 0;
+		used_size_ = 0;
+	}
+
+	std::size_t get_size() const
+	{
+		return size_;
+	}
+
+	// Starts to count the size of the allocations.
+	void begin_measure()
+	{
+		measured_size_ = 0;
+	}
+
+	// Gets the size of the allocations since "begin_measure" (in bytes).
+	std::size_t get_measured_size() const
+	{
+		return measured_size_;
+	}
+
+	// Allocates the memory from the arena or from the default resource
+	// if there is no arena.
+	//
+	// Returns the memory or null on error.
+	static void* allocate(
+		Arena* const arena,
+		const std::size_t size,
+		const std::size_t value_alignment)
+	{
+		RtScope::check(RtChecks::ViolationType::allocation, size);
+
+		const auto aligned_size = align_size(size);
+		const auto block_alignment = std::max(alignment, value_alignment);
+
+		if (!arena)
+		{
+			return MemoryResource::get_default()->allocate(aligned_size, block_alignment);
+		}
+
+		arena->measured_size_ += aligned_size;
+
+		if (value_alignment <= alignment && aligned_size <= arena->size_ - arena->used_size_)
+		{
+			const auto result = arena->data_ + arena->used_size_;
+			arena->used_size_ += aligned_size;
+			return result;
+		}
+
+		return arena->memory_resource_->allocate(aligned_size, block_alignment);
+	}
+
+	// Frees the memory allocated by "allocate".
+	static void deallocate(
+		Arena* const arena,
+		void* const pointer,
+		const std::size_t size,
+		const std::size_t value_alignment)
+	{
+		if (!pointer)
+		{
+			return;
+		}
+
+		RtScope::check(RtChecks::ViolationType::deallocation, size);
+
+		const auto aligned_size = align_size(size);
+		const auto block_alignment = std::max(alignment, value_alignment);
+
+		if (!arena)
+		{
+			MemoryResource::get_default()->deallocate(pointer, aligned_size, block_alignment);
+			return;
+		}
+
+		const auto byte_pointer = static_cast<unsigned char*>(pointer);
+
+		if (byte_pointer >= arena->data_ && byte_pointer < arena->data_ + arena->size_)
+		{
+			// Released with the block.
+			return;
+		}
+
+		arena->memory_resource_->deallocate(pointer, aligned_size, block_alignment);
+	}
+
+	// Gets the arena of the current thread's allocations.
+	static Arena* get_current()
+	{
+		return current_;
+	}
+
+
+private:
+	friend class ArenaScope;
+
+
+	static thread_local Arena* current_;
+
+
+	MemoryResource* memory_resource_;
+	unsigned char* data_;
+	std::size_t size_;
+	std::size_t used_size_;
+	std::size_t measured_size_;
+
+
+	static std::size_t align_size(
+		const std::size_t size)
+	{
+		return (size + alignment - 1) & ~(alignment - 1);
+	}
+}; // Arena
+
+
+constexpr std::size_t Arena::alignment;
+thread_local Arena* Arena::current_ = nullptr;
+
+
+// Makes the arena current for the thread's allocations within the scope.
+class ArenaScope
+{
+public:
+	explicit ArenaScope(
+		Arena& arena)
+		:
+		previous_arena_{Arena::current_}
+	{
+		Arena::current_ = &arena;
+	}
+
+	ArenaScope(
+		const ArenaScope& that) = delete;
+
+	ArenaScope& operator=(
+		const ArenaScope& that) = delete;
+
+	~ArenaScope()
+	{
+		Arena::current_ = previous_arena_;
+	}
+
+
+private:
+	Arena* previous_arena_;
+}; // ArenaScope
+
+
+// An allocator of the standard containers bound to the arena
+// which was current on construction.
+template<typename T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+
+	ArenaAllocator() noexcept
+		:
+		arena_{Arena::get_current()}
+	{
+	}
+
+	template<typename U>
+	ArenaAllocator(
+		const ArenaAllocator<U>& that) noexcept
+		:
+		arena_{that.get_arena()}
+	{
+	}
+
+
+	T* allocate(
+		const std::size_t count)
+	{
+		const auto result = Arena::allocate(arena_, count * sizeof(T), alignof(T));
+
+		if (!result)
+		{
+			throw std::bad_alloc{};
+		}
+
+		return static_cast<T*>(result);
+	}
+
+	void deallocate(
+		T* const pointer,
+		const std::size_t count) noexcept
+	{
+		Arena::deallocate(arena_, pointer, count * sizeof(T), alignof(T));
+	}
+
+	Arena* get_arena() const noexcept
+	{
+		return arena_;
+	}
+
+
+private:
+	Arena* arena_;
+}; // ArenaAllocator
+
+template<typename T, typename U>
+bool operator==(
+	const ArenaAllocator<T>& a,
+	const ArenaAllocator<U>& b) noexcept
+{
+	return a.get_arena() == b.get_arena();
+}
+
+template<typename T, typename U>
+bool operator!=(
+	const ArenaAllocator<T>& a,
+	const ArenaAllocator<U>& b) noexcept
+{
+	return !(a == b);
+}
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+
 using AmbiCoeffs = std::array<float, max_ambi_coeffs>;
 using Gains = std::array<float, max_channels>;
 using WetGains = std::array<float, max_effects>;
 using ChannelConfig = std::array<float, max_ambi_coeffs>;
-using SampleBuffer = std::array<float, max_sample_buffer_size>;
-using SampleBuffers = std::vector<SampleBuffer>;
-using EffectSampleBuffer = std::vector<float>;
+// Temporary storage of buffer data sized to the block size.
+using SampleBuffer = ArenaVector<float>;
+using SampleBuffers = ArenaVector<SampleBuffer>;
+using EffectSampleBuffer = ArenaVector<float>;
 
 
 namespace detail
@@ -216,6 +687,67 @@ constexpr float Math::pi_2;
 constexpr float Math::tau;
 
 
+// A recursive quadrature oscillator.
+//
+// Rotates a phasor by a fixed angle each sample, so the sinus is produced
+// without calling the transcendental functions. The phasor is kept in double
+// precision, so the phase error stays negligible over long periods; the
+// amplitude drift should be corrected from time to time (see "normalize").
+struct QuadratureOscillator
+{
+	double sin_;
+	double cos_;
+	double step_sin_;
+	double step_cos_;
+
+
+	void reset()
+	{
+		sin_ = 0.0;
+		cos_ = 1.0;
+	}
+
+	// Sets the angle (in radians) to rotate by each sample.
+	void set_step(
+		const double step)
+	{
+		step_sin_ = std::sin(step);
+		step_cos_ = std::cos(step);
+	}
+
+	// Sets the current angle (in radians).
+	void set_phase(
+		const double phase)
+	{
+		sin_ = std::sin(phase);
+		cos_ = std::cos(phase);
+	}
+
+	float get_sin() const
+	{
+		return static_cast<float>(sin_);
+	}
+
+	void advance()
+	{
+		const auto new_sin = (sin_ * step_cos_) + (cos_ * step_sin_);
+		const auto new_cos = (cos_ * step_cos_) - (sin_ * step_sin_);
+
+		sin_ = new_sin;
+		cos_ = new_cos;
+	}
+
+	// Corrects the drift of the amplitude.
+	void normalize()
+	{
+		const auto gain = 1.5 - (0.5 * ((sin_ * sin_) + (cos_ * cos_)));
+
+		sin_ *= gain;
+		cos_ *= gain;
+	}
+}; // QuadratureOscillator
+
+
 struct Mat4F
 {
 	using Items = float[4][4];
@@ -817,15 +1349,121 @@ constexpr ChannelPanning Panning::x6_1_panning[6];
 constexpr ChannelPanning Panning::x7_1_panning[6];
 
 
-// Filters implementation is based on the "Cookbook formulae for audio
-// EQ biquad filter coefficients" by Robert Bristow-Johnson
-// http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
-//
-// Implementation note: For the shelf filters, the specified gain is for the
-// reference frequency, which is the centerpoint of the transition band. This
-// better matches EFX filter design. To set the gain for the shelf itself, use
-// the square root of the desired linear gain (or halve the dB gain).
-struct FilterState
+#ifdef OALSFXPP_X86_SIMD
+
+// The instruction sets of the CPU usable by the kernels.
+struct CpuFeatures
+{
+	bool has_sse2_;
+	bool has_avx_;
+	bool has_avx2_fma_;
+	bool has_avx512f_;
+
+
+	static CpuFeatures detect()
+	{
+		auto result = CpuFeatures{};
+
+		unsigned int registers[4];
+
+		query(0, registers);
+
+		const auto max_leaf = registers[0];
+
+		if (max_leaf < 1)
+		{
+			return result;
+		}
+
+		query(1, registers);
+
+		result.has_sse2_ = (registers[3] & (1U << 26)) != 0;
+
+		const auto has_fma = (registers[2] & (1U << 12)) != 0;
+		const auto has_os_xsave = (registers[2] & (1U << 27)) != 0;
+		const auto has_avx = (registers[2] & (1U << 28)) != 0;
+
+		if (!has_os_xsave || !has_avx)
+		{
+			return result;
+		}
+
+		// The wide registers are usable only if the OS saves them.
+		const auto xcr0 = get_xcr0();
+		const auto are_ymm_saved = (xcr0 & 0x06U) == 0x06U;
+		const auto are_zmm_saved = (xcr0 & 0xE6U) == 0xE6U;
+
+		result.has_avx_ = are_ymm_saved;
+
+		if (max_leaf < 7)
+		{
+			return result;
+		}
+
+		query(7, registers);
+
+		const auto has_avx2 = (registers[1] & (1U << 5)) != 0;
+		const auto has_avx512f = (registers[1] & (1U << 16)) != 0;
+
+		result.has_avx2_fma_ = are_ymm_saved && has_avx2 && has_fma;
+		result.has_avx512f_ = are_zmm_saved && has_avx512f;
+
+		return result;
+	}
+
+	// Returns the features detected once for the process.
+	static const CpuFeatures& get()
+	{
+		static const auto cpu_features = detect();
+
+		return cpu_features;
+	}
+
+
+private:
+	static void query(
+		const unsigned int leaf,
+		unsigned int (&registers)[4])
+	{
+#ifdef _MSC_VER
+		int values[4];
+		__cpuidex(values, static_cast<int>(leaf), 0);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			registers[i] = static_cast<unsigned int>(values[i]);
+		}
+#else
+		__cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+	}
+
+	static std::uint64_t get_xcr0()
+	{
+#ifdef _MSC_VER
+		return _xgetbv(0);
+#else
+		unsigned int eax;
+		unsigned int edx;
+		__asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+		return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+	}
+}; // CpuFeatures
+
+#endif // OALSFXPP_X86_SIMD
+
+
+// Filters implementation is based on the "Cookbook formulae for audio
+// EQ biquad filter coefficients" by Robert Bristow-Johnson
+// http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
+//
+// Implementation note: For the shelf filters, the specified gain is for the
+// reference frequency, which is the centerpoint of the transition band. This
+// better matches EFX filter design. To set the gain for the shelf itself, use
+// the square root of the desired linear gain (or halve the dB gain).
+struct FilterState
 {
 	float x_[2]; // History of two last input samples
 	float y_[2]; // History of two last output samples
@@ -1090,548 +1728,1686 @@ struct FilterState
 	}
 }; // FilterState
 
-struct Source
-{
-	struct Send
-	{
-		struct Channel
-		{
-			FilterState low_pass_;
-			FilterState high_pass_;
-			Gains current_gains_;
-			Gains target_gains_;
 
+template<int TChannelCount>
+struct FilterBank;
 
-			void reset()
-			{
-				low_pass_.reset();
-				high_pass_.reset();
 
-				current_gains_.fill(0.0F);
-				target_gains_.fill(0.0F);
-			}
-		}; // Channel
+// Filter bank kernels.
+struct FilterBankKernels
+{
+	using Process4Func = void (*)(
+		FilterBank<4>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples);
 
-		using Channels = std::array<Channel, max_channels>;
+	using Process8Func = void (*)(
+		FilterBank<8>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples);
 
+	using ProcessCascade4Func = void (*)(
+		FilterBank<4>* const* filter_banks,
+		const int stage_count,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples);
 
-		SendProps props_;
-		SendProps deferred_props_;
 
-		ActiveFilters filter_type_;
-		Channels channels_;
-		SampleBuffers* buffers_;
-		int channel_count_;
-	}; // Send
+	Process4Func process4_;
+	Process8Func process8_;
+	ProcessCascade4Func process_cascade4_;
+}; // FilterBankKernels
 
-	using Sends = std::vector<Send>;
 
+// A bank of biquad filters (see FilterState) with one filter per channel.
+//
+// The states are laid out as a structure of arrays, so the kernels step
+// all channels through the recurrence at once (one channel per SIMD lane).
+template<int TChannelCount>
+struct FilterBank
+{
+	static_assert(TChannelCount == 4 || TChannelCount == 8, "Unsupported channel count.");
 
-	Send direct_;
-	Sends auxes_;
-	bool are_props_changed_;
 
+	using Lanes = std::array<float, TChannelCount>;
 
-	void initialize(
-		const int effect_count)
-	{
-		direct_.props_.set_defaults();
-		direct_.deferred_props_.set_defaults();
 
-		auxes_.clear();
-		auxes_.resize(effect_count);
+	Lanes x_[2]; // History of two last input samples
+	Lanes y_[2]; // History of two last output samples
 
-		for (auto& aux : auxes_)
-		{
-			aux.props_.set_defaults();
-			aux.deferred_props_.set_defaults();
-		}
+	// Transfer function coefficients "b"
+	Lanes b0_;
+	Lanes b1_;
+	Lanes b2_;
 
-		are_props_changed_ = true;
-	}
-}; // Source
+	// Transfer function coefficients "a" (a0 is pre-applied)
+	Lanes a1_;
+	Lanes a2_;
 
 
-// ==========================================================================
-// EffectProps
+	void reset()
+	{
+		clear();
 
-constexpr int EffectProps::Chorus::waveform_sinusoid;
-constexpr int EffectProps::Chorus::waveform_triangle;
+		b0_.fill(0.0F);
+		b1_.fill(0.0F);
+		b2_.fill(0.0F);
 
-constexpr int EffectProps::Chorus::min_waveform;
-constexpr int EffectProps::Chorus::max_waveform;
-constexpr int EffectProps::Chorus::default_waveform;
+		a1_.fill(0.0F);
+		a2_.fill(0.0F);
+	}
 
-constexpr int EffectProps::Chorus::min_phase;
-constexpr int EffectProps::Chorus::max_phase;
-constexpr int EffectProps::Chorus::default_phase;
+	void clear()
+	{
+		x_[0].fill(0.0F);
+		x_[1].fill(0.0F);
+		y_[0].fill(0.0F);
+		y_[1].fill(0.0F);
+	}
 
-constexpr float EffectProps::Chorus::min_rate;
-constexpr float EffectProps::Chorus::max_rate;
-constexpr float EffectProps::Chorus::default_rate;
+	// Sets the coefficients of all filters.
+	void copy_params(
+		const FilterState& filter_state)
+	{
+		b0_.fill(filter_state.b0_);
+		b1_.fill(filter_state.b1_);
+		b2_.fill(filter_state.b2_);
+		a1_.fill(filter_state.a1_);
+		a2_.fill(filter_state.a2_);
+	}
 
-constexpr float EffectProps::Chorus::min_depth;
-constexpr float EffectProps::Chorus::max_depth;
-constexpr float EffectProps::Chorus::default_depth;
+	// Filters the samples of the first channels.
+	//
+	// Note: The target samples may be the source ones.
+	void process(
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples);
 
-constexpr float EffectProps::Chorus::min_feedback;
-constexpr float EffectProps::Chorus::max_feedback;
-constexpr float EffectProps::Chorus::default_feedback;
+	void process_pass_through(
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples)
+	{
+		for (int c = 0; c < channel_count; ++c)
+		{
+			const auto samples = src_samples[c];
 
-constexpr float EffectProps::Chorus::min_delay;
-constexpr float EffectProps::Chorus::max_delay;
-constexpr float EffectProps::Chorus::default_delay;
+			if (sample_count >= 2)
+			{
+				x_[1][c] = samples[sample_count - 2];
+				x_[0][c] = samples[sample_count - 1];
+				y_[1][c] = samples[sample_count - 2];
+				y_[0][c] = samples[sample_count - 1];
+			}
+			else if (sample_count == 1)
+			{
+				x_[1][c] = x_[0][c];
+				x_[0][c] = samples[0];
+				y_[1][c] = y_[0][c];
+				y_[0][c] = samples[0];
+			}
+		}
+	}
+}; // FilterBank
 
-constexpr bool EffectProps::Compressor::min_on_off;
-constexpr bool EffectProps::Compressor::max_on_off;
-constexpr bool EffectProps::Compressor::default_on_off;
 
-constexpr float EffectProps::Dedicated::min_gain;
-constexpr float EffectProps::Dedicated::max_gain;
-constexpr float EffectProps::Dedicated::default_gain;
+struct ScalarFilterBankKernels
+{
+	template<int TChannelCount>
+	static void process(
+		FilterBank<TChannelCount>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		for (int c = 0; c < channel_count; ++c)
+		{
+			const auto b0 = filter_bank.b0_[c];
+			const auto b1 = filter_bank.b1_[c];
+			const auto b2 = filter_bank.b2_[c];
+			const auto a1 = filter_bank.a1_[c];
+			const auto a2 = filter_bank.a2_[c];
 
-constexpr float EffectProps::Distortion::min_edge;
-constexpr float EffectProps::Distortion::max_edge;
-constexpr float EffectProps::Distortion::default_edge;
+			auto x1 = filter_bank.x_[0][c];
+			auto x2 = filter_bank.x_[1][c];
+			auto y1 = filter_bank.y_[0][c];
+			auto y2 = filter_bank.y_[1][c];
 
-constexpr float EffectProps::Distortion::min_gain;
-constexpr float EffectProps::Distortion::max_gain;
-constexpr float EffectProps::Distortion::default_gain;
+			const auto src = src_samples[c];
+			const auto dst = dst_samples[c];
 
-constexpr float EffectProps::Distortion::min_low_pass_cutoff;
-constexpr float EffectProps::Distortion::max_low_pass_cutoff;
-constexpr float EffectProps::Distortion::default_low_pass_cutoff;
+			for (int i = 0; i < sample_count; ++i)
+			{
+				const auto x = src[i];
+				const auto y = (b0 * x) + (b1 * x1) + (b2 * x2) - (a1 * y1) - (a2 * y2);
 
-constexpr float EffectProps::Distortion::min_eq_center;
-constexpr float EffectProps::Distortion::max_eq_center;
-constexpr float EffectProps::Distortion::default_eq_center;
+				x2 = x1;
+				x1 = x;
+				y2 = y1;
+				y1 = y;
 
-constexpr float EffectProps::Distortion::min_eq_bandwidth;
-constexpr float EffectProps::Distortion::max_eq_bandwidth;
-constexpr float EffectProps::Distortion::default_eq_bandwidth;
+				dst[i] = y;
+			}
 
-constexpr float EffectProps::Echo::min_delay;
-constexpr float EffectProps::Echo::max_delay;
-constexpr float EffectProps::Echo::default_delay;
+			filter_bank.x_[0][c] = x1;
+			filter_bank.x_[1][c] = x2;
+			filter_bank.y_[0][c] = y1;
+			filter_bank.y_[1][c] = y2;
+		}
+	}
 
-constexpr float EffectProps::Echo::min_lr_delay;
-constexpr float EffectProps::Echo::max_lr_delay;
-constexpr float EffectProps::Echo::default_lr_delay;
+	static void process_cascade4(
+		FilterBank<4>* const* filter_banks,
+		const int stage_count,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		if (stage_count == 0)
+		{
+			copy_samples(channel_count, sample_count, src_samples, dst_samples);
+			return;
+		}
 
-constexpr float EffectProps::Echo::min_damping;
-constexpr float EffectProps::Echo::max_damping;
-constexpr float EffectProps::Echo::default_damping;
+		for (int c = 0; c < channel_count; ++c)
+		{
+			float b0[max_filter_cascade_stages];
+			float b1[max_filter_cascade_stages];
+			float b2[max_filter_cascade_stages];
+			float a1[max_filter_cascade_stages];
+			float a2[max_filter_cascade_stages];
 
-constexpr float EffectProps::Echo::min_feedback;
-constexpr float EffectProps::Echo::max_feedback;
-constexpr float EffectProps::Echo::default_feedback;
+			float x1[max_filter_cascade_stages];
+			float x2[max_filter_cascade_stages];
+			float y1[max_filter_cascade_stages];
+			float y2[max_filter_cascade_stages];
 
-constexpr float EffectProps::Echo::min_spread;
-constexpr float EffectProps::Echo::max_spread;
-constexpr float EffectProps::Echo::default_spread;
+			for (int s = 0; s < stage_count; ++s)
+			{
+				const auto& filter_bank = *filter_banks[s];
+
+				b0[s] = filter_bank.b0_[c];
+				b1[s] = filter_bank.b1_[c];
+				b2[s] = filter_bank.b2_[c];
+				a1[s] = filter_bank.a1_[c];
+				a2[s] = filter_bank.a2_[c];
+
+				x1[s] = filter_bank.x_[0][c];
+				x2[s] = filter_bank.x_[1][c];
+				y1[s] = filter_bank.y_[0][c];
+				y2[s] = filter_bank.y_[1][c];
+			}
 
-constexpr float EffectProps::Equalizer::min_low_gain;
-constexpr float EffectProps::Equalizer::max_low_gain;
-constexpr float EffectProps::Equalizer::default_low_gain;
+			const auto src = src_samples[c];
+			const auto dst = dst_samples[c];
 
-constexpr float EffectProps::Equalizer::min_low_cutoff;
-constexpr float EffectProps::Equalizer::max_low_cutoff;
-constexpr float EffectProps::Equalizer::default_low_cutoff;
+			for (int i = 0; i < sample_count; ++i)
+			{
+				auto x = src[i];
 
-constexpr float EffectProps::Equalizer::min_mid1_gain;
-constexpr float EffectProps::Equalizer::max_mid1_gain;
-constexpr float EffectProps::Equalizer::default_mid1_gain;
+				for (int s = 0; s < stage_count; ++s)
+				{
+					const auto y = (b0[s] * x) + (b1[s] * x1[s]) + (b2[s] * x2[s]) - (a1[s] * y1[s]) - (a2[s] * y2[s]);
 
-constexpr float EffectProps::Equalizer::min_mid1_center;
-constexpr float EffectProps::Equalizer::max_mid1_center;
-constexpr float EffectProps::Equalizer::default_mid1_center;
+					x2[s] = x1[s];
+					x1[s] = x;
+					y2[s] = y1[s];
+					y1[s] = y;
 
-constexpr float EffectProps::Equalizer::min_mid1_width;
-constexpr float EffectProps::Equalizer::max_mid1_width;
-constexpr float EffectProps::Equalizer::default_mid1_width;
+					x = y;
+				}
 
-constexpr float EffectProps::Equalizer::min_mid2_gain;
-constexpr float EffectProps::Equalizer::max_mid2_gain;
-constexpr float EffectProps::Equalizer::default_mid2_gain;
+				dst[i] = x;
+			}
 
-constexpr float EffectProps::Equalizer::min_mid2_center;
-constexpr float EffectProps::Equalizer::max_mid2_center;
-constexpr float EffectProps::Equalizer::default_mid2_center;
+			for (int s = 0; s < stage_count; ++s)
+			{
+				auto& filter_bank = *filter_banks[s];
 
-constexpr float EffectProps::Equalizer::min_mid2_width;
-constexpr float EffectProps::Equalizer::max_mid2_width;
-constexpr float EffectProps::Equalizer::default_mid2_width;
+				filter_bank.x_[0][c] = x1[s];
+				filter_bank.x_[1][c] = x2[s];
+				filter_bank.y_[0][c] = y1[s];
+				filter_bank.y_[1][c] = y2[s];
+			}
+		}
+	}
 
-constexpr float EffectProps::Equalizer::min_high_gain;
-constexpr float EffectProps::Equalizer::max_high_gain;
-constexpr float EffectProps::Equalizer::default_high_gain;
+	static void copy_samples(
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		for (int c = 0; c < channel_count; ++c)
+		{
+			if (src_samples[c] != dst_samples[c])
+			{
+				std::copy_n(src_samples[c], sample_count, dst_samples[c]);
+			}
+		}
+	}
+}; // ScalarFilterBankKernels
 
-constexpr float EffectProps::Equalizer::min_high_cutoff;
-constexpr float EffectProps::Equalizer::max_high_cutoff;
-constexpr float EffectProps::Equalizer::default_high_cutoff;
 
-constexpr int EffectProps::Flanger::waveform_sinusoid;
-constexpr int EffectProps::Flanger::waveform_triangle;
+#ifdef OALSFXPP_X86_SIMD
 
-constexpr int EffectProps::Flanger::min_waveform;
-constexpr int EffectProps::Flanger::max_waveform;
-constexpr int EffectProps::Flanger::default_waveform;
+// Steps four channels at once through blocks of four samples transposed into the lanes.
+//
+// Note: The recurrence is evaluated in the same order as the scalar one,
+// so the results are identical.
+struct Sse2FilterBankKernels
+{
+	OALSFXPP_TARGET("sse2")
+	static void process4(
+		FilterBank<4>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		process_quad(filter_bank, 0, channel_count, sample_count, src_samples, dst_samples);
+	}
 
-constexpr int EffectProps::Flanger::min_phase;
-constexpr int EffectProps::Flanger::max_phase;
-constexpr int EffectProps::Flanger::default_phase;
+	OALSFXPP_TARGET("sse2")
+	static void process8(
+		FilterBank<8>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		process_quad(filter_bank, 0, std::min(channel_count, 4), sample_count, src_samples, dst_samples);
 
-constexpr float EffectProps::Flanger::min_rate;
-constexpr float EffectProps::Flanger::max_rate;
-constexpr float EffectProps::Flanger::default_rate;
+		if (channel_count > 4)
+		{
+			process_quad(filter_bank, 4, channel_count - 4, sample_count, src_samples + 4, dst_samples + 4);
+		}
+	}
 
-constexpr float EffectProps::Flanger::min_depth;
-constexpr float EffectProps::Flanger::max_depth;
-constexpr float EffectProps::Flanger::default_depth;
+	OALSFXPP_TARGET("sse2")
+	static void process_cascade4(
+		FilterBank<4>* const* filter_banks,
+		const int stage_count,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		switch (stage_count)
+		{
+			case 1:
+				process_cascade_quad<1>(filter_banks, channel_count, sample_count, src_samples, dst_samples);
+				break;
 
-constexpr float EffectProps::Flanger::min_feedback;
-constexpr float EffectProps::Flanger::max_feedback;
-constexpr float EffectProps::Flanger::default_feedback;
+			case 2:
+				process_cascade_quad<2>(filter_banks, channel_count, sample_count, src_samples, dst_samples);
+				break;
 
-constexpr float EffectProps::Flanger::min_delay;
-constexpr float EffectProps::Flanger::max_delay;
-constexpr float EffectProps::Flanger::default_delay;
+			case 3:
+				process_cascade_quad<3>(filter_banks, channel_count, sample_count, src_samples, dst_samples);
+				break;
 
-constexpr float EffectProps::Reverb::min_density;
-constexpr float EffectProps::Reverb::max_density;
-constexpr float EffectProps::Reverb::default_density;
+			case 4:
+				process_cascade_quad<4>(filter_banks, channel_count, sample_count, src_samples, dst_samples);
+				break;
 
-constexpr float EffectProps::Reverb::min_diffusion;
-constexpr float EffectProps::Reverb::max_diffusion;
-constexpr float EffectProps::Reverb::default_diffusion;
+			default:
+				ScalarFilterBankKernels::copy_samples(channel_count, sample_count, src_samples, dst_samples);
+				break;
+		}
+	}
 
-constexpr float EffectProps::Reverb::min_gain;
-constexpr float EffectProps::Reverb::max_gain;
-constexpr float EffectProps::Reverb::default_gain;
+	// Loads up to four samples of up to four channels, one sample per row.
+	OALSFXPP_TARGET("sse2")
+	static void load_block(
+		const float* const* src_samples,
+		const int channel_count,
+		const int offset,
+		const int sample_count,
+		__m128 (&block)[4])
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			if (c >= channel_count)
+			{
+				block[c] = _mm_setzero_ps();
+			}
+			else if (sample_count == 4)
+			{
+				block[c] = _mm_loadu_ps(src_samples[c] + offset);
+			}
+			else
+			{
+				float samples[4] = {};
+				std::copy_n(src_samples[c] + offset, sample_count, samples);
+				block[c] = _mm_loadu_ps(samples);
+			}
+		}
 
-constexpr float EffectProps::Reverb::min_gain_hf;
-constexpr float EffectProps::Reverb::max_gain_hf;
-constexpr float EffectProps::Reverb::default_gain_hf;
+		_MM_TRANSPOSE4_PS(block[0], block[1], block[2], block[3]);
+	}
 
-constexpr float EffectProps::Reverb::min_gain_lf;
-constexpr float EffectProps::Reverb::max_gain_lf;
-constexpr float EffectProps::Reverb::default_gain_lf;
+	// Stores the block loaded by "load_block".
+	OALSFXPP_TARGET("sse2")
+	static void store_block(
+		__m128 (&block)[4],
+		const int channel_count,
+		const int offset,
+		const int sample_count,
+		float* const* dst_samples)
+	{
+		_MM_TRANSPOSE4_PS(block[0], block[1], block[2], block[3]);
 
-constexpr float EffectProps::Reverb::min_decay_time;
-constexpr float EffectProps::Reverb::max_decay_time;
-constexpr float EffectProps::Reverb::default_decay_time;
+		for (int c = 0; c < channel_count; ++c)
+		{
+			if (sample_count == 4)
+			{
+				_mm_storeu_ps(dst_samples[c] + offset, block[c]);
+			}
+			else
+			{
+				float samples[4];
+				_mm_storeu_ps(samples, block[c]);
+				std::copy_n(samples, sample_count, dst_samples[c] + offset);
+			}
+		}
+	}
 
-constexpr float EffectProps::Reverb::min_decay_hf_ratio;
-constexpr float EffectProps::Reverb::max_decay_hf_ratio;
-constexpr float EffectProps::Reverb::default_decay_hf_ratio;
 
-constexpr float EffectProps::Reverb::min_decay_lf_ratio;
-constexpr float EffectProps::Reverb::max_decay_lf_ratio;
-constexpr float EffectProps::Reverb::default_decay_lf_ratio;
+private:
+	template<int TChannelCount>
+	OALSFXPP_TARGET("sse2")
+	static void process_quad(
+		FilterBank<TChannelCount>& filter_bank,
+		const int lane,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		const auto b0 = _mm_loadu_ps(&filter_bank.b0_[lane]);
+		const auto b1 = _mm_loadu_ps(&filter_bank.b1_[lane]);
+		const auto b2 = _mm_loadu_ps(&filter_bank.b2_[lane]);
+		const auto a1 = _mm_loadu_ps(&filter_bank.a1_[lane]);
+		const auto a2 = _mm_loadu_ps(&filter_bank.a2_[lane]);
 
-constexpr float EffectProps::Reverb::min_reflections_gain;
-constexpr float EffectProps::Reverb::max_reflections_gain;
-constexpr float EffectProps::Reverb::default_reflections_gain;
+		auto x1 = _mm_loadu_ps(&filter_bank.x_[0][lane]);
+		auto x2 = _mm_loadu_ps(&filter_bank.x_[1][lane]);
+		auto y1 = _mm_loadu_ps(&filter_bank.y_[0][lane]);
+		auto y2 = _mm_loadu_ps(&filter_bank.y_[1][lane]);
 
-constexpr float EffectProps::Reverb::min_reflections_delay;
-constexpr float EffectProps::Reverb::max_reflections_delay;
-constexpr float EffectProps::Reverb::default_reflections_delay;
+		for (int i = 0; i < sample_count; i += 4)
+		{
+			const auto count = std::min(4, sample_count - i);
 
-constexpr float EffectProps::Reverb::min_reflections_pan_xyz;
-constexpr float EffectProps::Reverb::max_reflections_pan_xyz;
-constexpr float EffectProps::Reverb::default_reflections_pan_xyz;
+			__m128 block[4];
 
-constexpr float EffectProps::Reverb::min_late_reverb_gain;
-constexpr float EffectProps::Reverb::max_late_reverb_gain;
-constexpr float EffectProps::Reverb::default_late_reverb_gain;
+			load_block(src_samples, channel_count, i, count, block);
 
-constexpr float EffectProps::Reverb::min_late_reverb_delay;
-constexpr float EffectProps::Reverb::max_late_reverb_delay;
-constexpr float EffectProps::Reverb::default_late_reverb_delay;
+			for (int k = 0; k < count; ++k)
+			{
+				const auto x = block[k];
 
-constexpr float EffectProps::Reverb::min_late_reverb_pan_xyz;
-constexpr float EffectProps::Reverb::max_late_reverb_pan_xyz;
-constexpr float EffectProps::Reverb::default_late_reverb_pan_xyz;
+				const auto y = _mm_sub_ps(
+					_mm_sub_ps(
+						_mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, x), _mm_mul_ps(b1, x1)), _mm_mul_ps(b2, x2)),
+						_mm_mul_ps(a1, y1)),
+					_mm_mul_ps(a2, y2));
 
-constexpr float EffectProps::Reverb::min_echo_time;
-constexpr float EffectProps::Reverb::max_echo_time;
-constexpr float EffectProps::Reverb::default_echo_time;
+				x2 = x1;
+				x1 = x;
+				y2 = y1;
+				y1 = y;
 
-constexpr float EffectProps::Reverb::min_echo_depth;
-constexpr float EffectProps::Reverb::max_echo_depth;
-constexpr float EffectProps::Reverb::default_echo_depth;
+				block[k] = y;
+			}
 
-constexpr float EffectProps::Reverb::min_modulation_time;
-constexpr float EffectProps::Reverb::max_modulation_time;
-constexpr float EffectProps::Reverb::default_modulation_time;
+			store_block(block, channel_count, i, count, dst_samples);
+		}
 
-constexpr float EffectProps::Reverb::min_modulation_depth;
-constexpr float EffectProps::Reverb::max_modulation_depth;
-constexpr float EffectProps::Reverb::default_modulation_depth;
+		_mm_storeu_ps(&filter_bank.x_[0][lane], x1);
+		_mm_storeu_ps(&filter_bank.x_[1][lane], x2);
+		_mm_storeu_ps(&filter_bank.y_[0][lane], y1);
+		_mm_storeu_ps(&filter_bank.y_[1][lane], y2);
+	}
 
-constexpr float EffectProps::Reverb::min_air_absorption_gain_hf;
-constexpr float EffectProps::Reverb::max_air_absorption_gain_hf;
-constexpr float EffectProps::Reverb::default_air_absorption_gain_hf;
+	// Runs each sample through all stages before the next one, so the states
+	// of the stages stay in registers and only the last stage is stored.
+	template<int TStageCount>
+	OALSFXPP_TARGET("sse2")
+	static void process_cascade_quad(
+		FilterBank<4>* const* filter_banks,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		__m128 b0[TStageCount];
+		__m128 b1[TStageCount];
+		__m128 b2[TStageCount];
+		__m128 a1[TStageCount];
+		__m128 a2[TStageCount];
 
-constexpr float EffectProps::Reverb::min_hf_reference;
-constexpr float EffectProps::Reverb::max_hf_reference;
-constexpr float EffectProps::Reverb::default_hf_reference;
+		__m128 x1[TStageCount];
+		__m128 x2[TStageCount];
+		__m128 y1[TStageCount];
+		__m128 y2[TStageCount];
 
-constexpr float EffectProps::Reverb::min_lf_reference;
-constexpr float EffectProps::Reverb::max_lf_reference;
-constexpr float EffectProps::Reverb::default_lf_reference;
+		for (int s = 0; s < TStageCount; ++s)
+		{
+			const auto& filter_bank = *filter_banks[s];
 
-constexpr float EffectProps::Reverb::min_room_rolloff_factor;
-constexpr float EffectProps::Reverb::max_room_rolloff_factor;
-constexpr float EffectProps::Reverb::default_room_rolloff_factor;
+			b0[s] = _mm_loadu_ps(filter_bank.b0_.data());
+			b1[s] = _mm_loadu_ps(filter_bank.b1_.data());
+			b2[s] = _mm_loadu_ps(filter_bank.b2_.data());
+			a1[s] = _mm_loadu_ps(filter_bank.a1_.data());
+			a2[s] = _mm_loadu_ps(filter_bank.a2_.data());
 
-constexpr bool EffectProps::Reverb::min_decay_hf_limit;
-constexpr bool EffectProps::Reverb::max_decay_hf_limit;
-constexpr bool EffectProps::Reverb::default_decay_hf_limit;
+			x1[s] = _mm_loadu_ps(filter_bank.x_[0].data());
+			x2[s] = _mm_loadu_ps(filter_bank.x_[1].data());
+			y1[s] = _mm_loadu_ps(filter_bank.y_[0].data());
+			y2[s] = _mm_loadu_ps(filter_bank.y_[1].data());
+		}
 
-constexpr float EffectProps::RingModulator::min_frequency;
-constexpr float EffectProps::RingModulator::max_frequency;
-constexpr float EffectProps::RingModulator::default_frequency;
+		for (int i = 0; i < sample_count; i += 4)
+		{
+			const auto count = std::min(4, sample_count - i);
 
-constexpr float EffectProps::RingModulator::min_high_pass_cutoff;
-constexpr float EffectProps::RingModulator::max_high_pass_cutoff;
-constexpr float EffectProps::RingModulator::default_high_pass_cutoff;
+			__m128 block[4];
 
-constexpr int EffectProps::RingModulator::waveform_sinusoid;
-constexpr int EffectProps::RingModulator::waveform_sawtooth;
-constexpr int EffectProps::RingModulator::waveform_square;
+			load_block(src_samples, channel_count, i, count, block);
 
-constexpr int EffectProps::RingModulator::min_waveform;
-constexpr int EffectProps::RingModulator::max_waveform;
-constexpr int EffectProps::RingModulator::default_waveform;
+			for (int k = 0; k < count; ++k)
+			{
+				auto x = block[k];
 
+				for (int s = 0; s < TStageCount; ++s)
+				{
+					const auto y = _mm_sub_ps(
+						_mm_sub_ps(
+							_mm_add_ps(
+								_mm_add_ps(_mm_mul_ps(b0[s], x), _mm_mul_ps(b1[s], x1[s])),
+								_mm_mul_ps(b2[s], x2[s])),
+							_mm_mul_ps(a1[s], y1[s])),
+						_mm_mul_ps(a2[s], y2[s]));
+
+					x2[s] = x1[s];
+					x1[s] = x;
+					y2[s] = y1[s];
+					y1[s] = y;
+
+					x = y;
+				}
 
-void EffectProps::Chorus::set_defaults()
-{
-	waveform_ = default_waveform;
-	phase_ = default_phase;
-	rate_ = default_rate;
-	depth_ = default_depth;
-	feedback_ = default_feedback;
-	delay_ = default_delay;
-}
+				block[k] = x;
+			}
 
-void EffectProps::Chorus::normalize()
-{
-	Math::clamp_i(waveform_, min_waveform, max_waveform);
-	Math::clamp_i(phase_, min_phase, max_phase);
-	Math::clamp_i(rate_, min_rate, max_rate);
-	Math::clamp_i(depth_, min_depth, max_depth);
-	Math::clamp_i(feedback_, min_feedback, max_feedback);
-	Math::clamp_i(delay_, min_delay, max_delay);
-}
+			store_block(block, channel_count, i, count, dst_samples);
+		}
 
-bool EffectProps::Chorus::are_equal(
-	const Chorus& a,
-	const Chorus& b)
-{
-	return
-		a.waveform_ == b.waveform_ &&
-		a.phase_ == b.phase_ &&
-		a.rate_ == b.rate_ &&
-		a.depth_ == b.depth_ &&
-		a.feedback_ == b.feedback_ &&
-		a.delay_ == b.delay_;
-}
+		for (int s = 0; s < TStageCount; ++s)
+		{
+			auto& filter_bank = *filter_banks[s];
 
-void EffectProps::Compressor::set_defaults()
-{
-	on_off_ = default_on_off;
-}
+			_mm_storeu_ps(filter_bank.x_[0].data(), x1[s]);
+			_mm_storeu_ps(filter_bank.x_[1].data(), x2[s]);
+			_mm_storeu_ps(filter_bank.y_[0].data(), y1[s]);
+			_mm_storeu_ps(filter_bank.y_[1].data(), y2[s]);
+		}
+	}
+}; // Sse2FilterBankKernels
 
-void EffectProps::Compressor::normalize()
-{
-}
 
-bool EffectProps::Compressor::are_equal(
-	const Compressor& a,
-	const Compressor& b)
+// Steps eight channels at once; the blocks are transposed in halves.
+//
+// Note: No FMA to keep the results identical to the scalar ones.
+struct AvxFilterBankKernels
 {
-	return
-		a.on_off_ == b.on_off_;
-}
+	OALSFXPP_TARGET("avx")
+	static void process8(
+		FilterBank<8>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		if (channel_count <= 4)
+		{
+			Sse2FilterBankKernels::process8(filter_bank, channel_count, sample_count, src_samples, dst_samples);
+			return;
+		}
 
-void EffectProps::Dedicated::set_defaults()
-{
-	gain_ = default_gain;
-}
+		const auto b0 = _mm256_loadu_ps(filter_bank.b0_.data());
+		const auto b1 = _mm256_loadu_ps(filter_bank.b1_.data());
+		const auto b2 = _mm256_loadu_ps(filter_bank.b2_.data());
+		const auto a1 = _mm256_loadu_ps(filter_bank.a1_.data());
+		const auto a2 = _mm256_loadu_ps(filter_bank.a2_.data());
 
-void EffectProps::Dedicated::normalize()
-{
-	Math::clamp_i(gain_, min_gain, max_gain);
-}
+		auto x1 = _mm256_loadu_ps(filter_bank.x_[0].data());
+		auto x2 = _mm256_loadu_ps(filter_bank.x_[1].data());
+		auto y1 = _mm256_loadu_ps(filter_bank.y_[0].data());
+		auto y2 = _mm256_loadu_ps(filter_bank.y_[1].data());
 
-bool EffectProps::Dedicated::are_equal(
-	const Dedicated& a,
-	const Dedicated& b)
-{
-	return
-		a.gain_ == b.gain_;
-}
+		for (int i = 0; i < sample_count; i += 4)
+		{
+			const auto count = std::min(4, sample_count - i);
 
-void EffectProps::Distortion::set_defaults()
-{
-	edge_ = default_edge;
-	gain_ = default_gain;
-	low_pass_cutoff_ = default_low_pass_cutoff;
-	eq_center_ = default_eq_center;
-	eq_bandwidth_ = default_eq_bandwidth;
-}
+			__m128 low_block[4];
+			__m128 high_block[4];
 
-void EffectProps::Distortion::normalize()
-{
-	Math::clamp_i(edge_, min_edge, max_edge);
-	Math::clamp_i(gain_, min_gain, max_gain);
-	Math::clamp_i(low_pass_cutoff_, min_low_pass_cutoff, max_low_pass_cutoff);
-	Math::clamp_i(eq_center_, min_eq_center, max_eq_center);
-	Math::clamp_i(eq_bandwidth_, min_eq_bandwidth, max_eq_bandwidth);
-}
+			Sse2FilterBankKernels::load_block(src_samples, 4, i, count, low_block);
+			Sse2FilterBankKernels::load_block(src_samples + 4, channel_count - 4, i, count, high_block);
 
-bool EffectProps::Distortion::are_equal(
-	const Distortion& a,
-	const Distortion& b)
-{
-	return
-		a.edge_ == b.edge_ &&
-		a.gain_ == b.gain_ &&
-		a.low_pass_cutoff_ == b.low_pass_cutoff_ &&
-		a.eq_center_ == b.eq_center_ &&
-		a.eq_bandwidth_ == b.eq_bandwidth_;
-}
+			for (int k = 0; k < count; ++k)
+			{
+				const auto x = _mm256_insertf128_ps(_mm256_castps128_ps256(low_block[k]), high_block[k], 1);
+
+				const auto y = _mm256_sub_ps(
+					_mm256_sub_ps(
+						_mm256_add_ps(
+							_mm256_add_ps(_mm256_mul_ps(b0, x), _mm256_mul_ps(b1, x1)),
+							_mm256_mul_ps(b2, x2)),
+						_mm256_mul_ps(a1, y1)),
+					_mm256_mul_ps(a2, y2));
+
+				x2 = x1;
+				x1 = x;
+				y2 = y1;
+				y1 = y;
+
+				low_block[k] = _mm256_castps256_ps128(y);
+				high_block[k] = _mm256_extractf128_ps(y, 1);
+			}
 
-void EffectProps::Echo::set_defaults()
+			Sse2FilterBankKernels::store_block(low_block, 4, i, count, dst_samples);
+			Sse2FilterBankKernels::store_block(high_block, channel_count - 4, i, count, dst_samples + 4);
+		}
+
+		_mm256_storeu_ps(filter_bank.x_[0].data(), x1);
+		_mm256_storeu_ps(filter_bank.x_[1].data(), x2);
+		_mm256_storeu_ps(filter_bank.y_[0].data(), y1);
+		_mm256_storeu_ps(filter_bank.y_[1].data(), y2);
+	}
+}; // AvxFilterBankKernels
+
+#endif // OALSFXPP_X86_SIMD
+
+
+struct FilterBankHelpers
 {
-	delay_ = default_delay;
-	lr_delay_ = default_lr_delay;
-	damping_ = default_damping;
-	feedback_ = default_feedback;
-	spread_ = default_spread;
-}
+	// Selects the filter bank kernels for the CPU.
+	//
+	// Note: The kernels are selected once for all instances.
+	static void initialize()
+	{
+		static const auto is_initialized = select_kernels();
 
-void EffectProps::Echo::normalize()
+		static_cast<void>(is_initialized);
+	}
+
+	static void process(
+		FilterBank<4>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		kernels_.process4_(filter_bank, channel_count, sample_count, src_samples, dst_samples);
+	}
+
+	static void process(
+		FilterBank<8>& filter_bank,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		kernels_.process8_(filter_bank, channel_count, sample_count, src_samples, dst_samples);
+	}
+
+	// Filters the samples through the banks one after another.
+	//
+	// Note: The target samples may be the source ones.
+	static void process_cascade(
+		FilterBank<4>* const* filter_banks,
+		const int stage_count,
+		const int channel_count,
+		const int sample_count,
+		const float* const* src_samples,
+		float* const* dst_samples)
+	{
+		assert(stage_count >= 0 && stage_count <= max_filter_cascade_stages);
+
+		kernels_.process_cascade4_(filter_banks, stage_count, channel_count, sample_count, src_samples, dst_samples);
+	}
+
+
+private:
+	static FilterBankKernels kernels_;
+
+
+	static bool select_kernels()
+	{
+#ifdef OALSFXPP_X86_SIMD
+		const auto& cpu_features = CpuFeatures::get();
+
+		if (cpu_features.has_sse2_)
+		{
+			kernels_ = FilterBankKernels
+			{
+				Sse2FilterBankKernels::process4,
+				Sse2FilterBankKernels::process8,
+				Sse2FilterBankKernels::process_cascade4,
+			};
+		}
+
+		if (cpu_features.has_sse2_ && cpu_features.has_avx_)
+		{
+			kernels_.process8_ = AvxFilterBankKernels::process8;
+		}
+#endif
+
+		return true;
+	}
+}; // FilterBankHelpers
+
+
+FilterBankKernels FilterBankHelpers::kernels_ = FilterBankKernels
 {
-	Math::clamp_i(delay_, min_delay, max_delay);
-	Math::clamp_i(lr_delay_, min_lr_delay, max_lr_delay);
-	Math::clamp_i(damping_, min_damping, max_damping);
-	Math::clamp_i(feedback_, min_feedback, max_feedback);
-	Math::clamp_i(spread_, min_spread, max_spread);
-}
+	ScalarFilterBankKernels::process<4>,
+	ScalarFilterBankKernels::process<8>,
+	ScalarFilterBankKernels::process_cascade4,
+};
 
-bool EffectProps::Echo::are_equal(
-	const Echo& a,
-	const Echo& b)
+
+template<int TChannelCount>
+void FilterBank<TChannelCount>::process(
+	const int channel_count,
+	const int sample_count,
+	const float* const* src_samples,
+	float* const* dst_samples)
 {
-	return
-		a.delay_ == b.delay_ &&
-		a.lr_delay_ == b.lr_delay_ &&
-		a.damping_ == b.damping_ &&
-		a.feedback_ == b.feedback_ &&
-		a.spread_ == b.spread_;
+	FilterBankHelpers::process(*this, channel_count, sample_count, src_samples, dst_samples);
 }
 
-void EffectProps::Equalizer::set_defaults()
+// Distorts the samples with three chained stages of a rational waveshaper
+// "(1 + k) * x / (1 + k * |x|)", where "k" is the edge coefficient.
+//
+// The original chain negates the second stage; the waveshaper is an odd function,
+// so the sign is flipped at the last stage instead.
+struct WaveshaperKernels
 {
-	low_cutoff_ = default_low_cutoff;
-	low_gain_ = default_high_gain;
-	mid1_center_ = default_mid1_center;
-	mid1_gain_ = default_mid1_gain;
-	mid1_width_ = default_mid1_width;
-	mid2_center_ = default_mid2_center;
-	mid2_gain_ = default_mid2_gain;
-	mid2_width_ = default_mid2_width;
-	high_cutoff_ = default_high_cutoff;
-	high_gain_ = default_high_gain;
-}
+	using ProcessFunc = void (*)(
+		const float edge_coeff,
+		const int sample_count,
+		float* samples);
 
-void EffectProps::Equalizer::normalize()
+
+	ProcessFunc process_;
+}; // WaveshaperKernels
+
+
+struct ScalarWaveshaperKernels
 {
-	Math::clamp_i(low_cutoff_, min_low_cutoff, max_low_cutoff);
-	Math::clamp_i(low_gain_, min_low_gain, max_low_gain);
-	Math::clamp_i(mid1_center_, min_mid1_center, max_mid1_center);
-	Math::clamp_i(mid1_gain_, min_mid1_gain, max_mid1_gain);
-	Math::clamp_i(mid1_width_, min_mid1_width, max_mid1_width);
-	Math::clamp_i(mid2_center_, min_mid2_center, max_mid2_center);
-	Math::clamp_i(mid2_gain_, min_mid2_gain, max_mid2_gain);
-	Math::clamp_i(mid2_width_, min_mid2_width, max_mid2_width);
-	Math::clamp_i(high_cutoff_, min_high_cutoff, max_high_cutoff);
-	Math::clamp_i(high_gain_, min_high_gain, max_high_gain);
-}
+	static void process(
+		const float edge_coeff,
+		const int sample_count,
+		float* samples)
+	{
+		const auto gain = 1.0F + edge_coeff;
 
-bool EffectProps::Equalizer::are_equal(
-	const Equalizer& a,
-	const Equalizer& b)
+		for (int i = 0; i < sample_count; ++i)
+		{
+			auto sample = samples[i];
+
+			sample = gain * sample / (1.0F + (edge_coeff * std::abs(sample)));
+			sample = gain * sample / (1.0F + (edge_coeff * std::abs(sample)));
+			sample = gain * sample / (1.0F + (edge_coeff * std::abs(sample)));
+
+			samples[i] = -sample;
+		}
+	}
+}; // ScalarWaveshaperKernels
+
+
+#ifdef OALSFXPP_X86_SIMD
+
+// Replaces the divisions with reciprocal estimates refined by one Newton-Raphson step
+// (about 22 bits of precision; the denominators are at least one).
+//
+// The remainder is processed as a padded vector, so all samples get the same precision.
+struct Sse2WaveshaperKernels
 {
-	return
-		a.low_cutoff_ == b.low_cutoff_ &&
-		a.low_gain_ == b.low_gain_ &&
-		a.mid1_center_ == b.mid1_center_ &&
-		a.mid1_gain_ == b.mid1_gain_ &&
-		a.mid1_width_ == b.mid1_width_ &&
-		a.mid2_center_ == b.mid2_center_ &&
-		a.mid2_gain_ == b.mid2_gain_ &&
-		a.mid2_width_ == b.mid2_width_ &&
-		a.high_cutoff_ == b.high_cutoff_ &&
-		a.high_gain_ == b.high_gain_;
-}
+	OALSFXPP_TARGET("sse2")
+	static void process(
+		const float edge_coeff,
+		const int sample_count,
+		float* samples)
+	{
+		const auto coeff = _mm_set1_ps(edge_coeff);
+		const auto gain = _mm_set1_ps(1.0F + edge_coeff);
+		const auto negative_gain = _mm_set1_ps(-(1.0F + edge_coeff));
 
-void EffectProps::Flanger::set_defaults()
+		auto i = 0;
+
+		for ( ; (i + 4) <= sample_count; i += 4)
+		{
+			_mm_storeu_ps(&samples[i], process_vector(coeff, gain, negative_gain, _mm_loadu_ps(&samples[i])));
+		}
+
+		if (i < sample_count)
+		{
+			float remainder[4] = {};
+
+			std::copy(&samples[i], &samples[sample_count], remainder);
+			_mm_storeu_ps(remainder, process_vector(coeff, gain, negative_gain, _mm_loadu_ps(remainder)));
+			std::copy_n(remainder, sample_count - i, &samples[i]);
+		}
+	}
+
+
+private:
+	OALSFXPP_TARGET("sse2")
+	static __m128 shape(
+		const __m128 coeff,
+		const __m128 gain,
+		const __m128 x)
+	{
+		const auto one = _mm_set1_ps(1.0F);
+		const auto two = _mm_set1_ps(2.0F);
+		const auto abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+		const auto d = _mm_add_ps(one, _mm_mul_ps(coeff, _mm_and_ps(x, abs_mask)));
+		const auto r0 = _mm_rcp_ps(d);
+		const auto r1 = _mm_mul_ps(r0, _mm_sub_ps(two, _mm_mul_ps(d, r0)));
+
+		return _mm_mul_ps(_mm_mul_ps(gain, x), r1);
+	}
+
+	OALSFXPP_TARGET("sse2")
+	static __m128 process_vector(
+		const __m128 coeff,
+		const __m128 gain,
+		const __m128 negative_gain,
+		const __m128 x)
+	{
+		return shape(coeff, negative_gain, shape(coeff, gain, shape(coeff, gain, x)));
+	}
+}; // Sse2WaveshaperKernels
+
+
+// Same as the SSE2 kernel with eight samples at once.
+//
+// Note: No FMA to keep the results identical to the SSE2 ones.
+struct AvxWaveshaperKernels
 {
-	waveform_ = default_waveform;
-	phase_ = default_phase;
-	rate_ = default_rate;
-	depth_ = default_depth;
-	feedback_ = default_feedback;
-	delay_ = default_delay;
-}
+	OALSFXPP_TARGET("avx")
+	static void process(
+		const float edge_coeff,
+		const int sample_count,
+		float* samples)
+	{
+		const auto coeff = _mm256_set1_ps(edge_coeff);
+		const auto gain = _mm256_set1_ps(1.0F + edge_coeff);
+		const auto negative_gain = _mm256_set1_ps(-(1.0F + edge_coeff));
 
-void EffectProps::Flanger::normalize()
+		auto i = 0;
+
+		for ( ; (i + 8) <= sample_count; i += 8)
+		{
+			const auto x = _mm256_loadu_ps(&samples[i]);
+
+			_mm256_storeu_ps(&samples[i], shape(coeff, negative_gain, shape(coeff, gain, shape(coeff, gain, x))));
+		}
+
+		if (i < sample_count)
+		{
+			Sse2WaveshaperKernels::process(edge_coeff, sample_count - i, &samples[i]);
+		}
+	}
+
+
+private:
+	OALSFXPP_TARGET("avx")
+	static __m256 shape(
+		const __m256 coeff,
+		const __m256 gain,
+		const __m256 x)
+	{
+		const auto one = _mm256_set1_ps(1.0F);
+		const auto two = _mm256_set1_ps(2.0F);
+		const auto abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+		const auto d = _mm256_add_ps(one, _mm256_mul_ps(coeff, _mm256_and_ps(x, abs_mask)));
+		const auto r0 = _mm256_rcp_ps(d);
+		const auto r1 = _mm256_mul_ps(r0, _mm256_sub_ps(two, _mm256_mul_ps(d, r0)));
+
+		return _mm256_mul_ps(_mm256_mul_ps(gain, x), r1);
+	}
+}; // AvxWaveshaperKernels
+
+#endif // OALSFXPP_X86_SIMD
+
+
+struct WaveshaperHelpers
 {
-	Math::clamp_i(waveform_, min_waveform, max_waveform);
-	Math::clamp_i(phase_, min_phase, max_phase);
-	Math::clamp_i(rate_, min_rate, max_rate);
-	Math::clamp_i(depth_, min_depth, max_depth);
-	Math::clamp_i(feedback_, min_feedback, max_feedback);
-	Math::clamp_i(delay_, min_delay, max_delay);
-}
+	// Selects the waveshaper kernels for the CPU.
+	//
+	// Note: The kernels are selected once for all instances.
+	static void initialize()
+	{
+		static const auto is_initialized = select_kernels();
 
-bool EffectProps::Flanger::are_equal(
-	const Flanger& a,
-	const Flanger& b)
+		static_cast<void>(is_initialized);
+	}
+
+	static void process(
+		const float edge_coeff,
+		const int sample_count,
+		float* samples)
+	{
+		kernels_.process_(edge_coeff, sample_count, samples);
+	}
+
+
+private:
+	static WaveshaperKernels kernels_;
+
+
+	static bool select_kernels()
+	{
+#ifdef OALSFXPP_X86_SIMD
+		const auto& cpu_features = CpuFeatures::get();
+
+		if (cpu_features.has_sse2_)
+		{
+			kernels_ = WaveshaperKernels{Sse2WaveshaperKernels::process};
+		}
+
+		if (cpu_features.has_sse2_ && cpu_features.has_avx_)
+		{
+			kernels_ = WaveshaperKernels{AvxWaveshaperKernels::process};
+		}
+#endif
+
+		return true;
+	}
+}; // WaveshaperHelpers
+
+
+WaveshaperKernels WaveshaperHelpers::kernels_ = WaveshaperKernels
 {
-	return
-		a.waveform_ == b.waveform_ &&
-		a.phase_ == b.phase_ &&
-		a.rate_ == b.rate_ &&
-		a.depth_ == b.depth_ &&
-		a.feedback_ == b.feedback_ &&
-		a.delay_ == b.delay_;
-}
+	ScalarWaveshaperKernels::process,
+};
 
-void EffectProps::Reverb::set_defaults()
+
+// A wait-free handoff of the latest value from a single producer to a single consumer.
+//
+// The producer writes to its own buffer and swaps it with the middle one on publishing.
+// The consumer swaps its own buffer with the middle one if a newer value was published.
+template<typename T>
+class TripleBuffer
 {
-	density_ = default_density;
-	diffusion_ = default_diffusion;
-	gain_ = default_gain;
-	gain_hf_ = default_gain_hf;
-	gain_lf_ = default_gain_lf;
-	decay_time_ = default_decay_time;
-	decay_hf_ratio_ = default_decay_hf_ratio;
-	decay_lf_ratio_ = default_decay_lf_ratio;
-	reflections_gain_ = default_reflections_gain;
-	reflections_delay_ = default_reflections_delay;
-	reflections_pan_.fill(default_reflections_pan_xyz);
-	late_reverb_gain_ = default_late_reverb_gain;
-	late_reverb_delay_ = default_late_reverb_delay;
-	late_reverb_pan_.fill(default_late_reverb_pan_xyz);
-	echo_time_ = default_echo_time;
-	echo_depth_ = default_echo_depth;
-	modulation_time_ = default_modulation_time;
-	modulation_depth_ = default_modulation_depth;
+public:
+	TripleBuffer()
+		:
+		values_{},
+		middle_index_{1},
+		back_index_{0},
+		front_index_{2}
+	{
+	}
+
+	TripleBuffer(
+		const TripleBuffer& that) = delete;
+
+	TripleBuffer& operator=(
+		const TripleBuffer& that) = delete;
+
+
+	// Gets the producer's value to write.
+	T& get_back()
+	{
+		return values_[back_index_];
+	}
+
+	// Publishes the producer's value.
+	void publish()
+	{
+		back_index_ = middle_index_.exchange(back_index_ | dirty_flag, std::memory_order_acq_rel) & index_mask;
+	}
+
+	// Takes the latest published value if any.
+	//
+	// Returns true if there is a new value or false otherwise.
+	bool update()
+	{
+		if ((middle_index_.load(std::memory_order_relaxed) & dirty_flag) == 0)
+		{
+			return false;
+		}
+
+		front_index_ = middle_index_.exchange(front_index_, std::memory_order_acq_rel) & index_mask;
+
+		return true;
+	}
+
+	// Gets the consumer's value.
+	const T& get_front() const
+	{
+		return values_[front_index_];
+	}
+
+
+private:
+	static constexpr auto index_mask = 0x3;
+	static constexpr auto dirty_flag = 0x4;
+
+
+	using Values = std::array<T, 3>;
+
+
+	Values values_;
+	std::atomic<int> middle_index_;
+	int back_index_;
+	int front_index_;
+}; // TripleBuffer
+
+template<typename T>
+constexpr int TripleBuffer<T>::index_mask;
+
+template<typename T>
+constexpr int TripleBuffer<T>::dirty_flag;
+
+
+// A wait-free bounded queue with a single producer and a single consumer.
+template<typename T>
+class SpscQueue
+{
+public:
+	SpscQueue()
+		:
+		values_{},
+		read_index_{},
+		write_index_{}
+	{
+	}
+
+	SpscQueue(
+		const SpscQueue& that) = delete;
+
+	SpscQueue& operator=(
+		const SpscQueue& that) = delete;
+
+
+	void initialize(
+		const int capacity)
+	{
+		// One extra value to tell a full queue from an empty one.
+		values_.resize(capacity + 1);
+
+		read_index_.store(0, std::memory_order_relaxed);
+		write_index_.store(0, std::memory_order_relaxed);
+	}
+
+	void uninitialize()
+	{
+		values_ = Values{};
+
+		read_index_.store(0, std::memory_order_relaxed);
+		write_index_.store(0, std::memory_order_relaxed);
+	}
+
+	// Adds the value to the queue.
+	//
+	// Returns true on success or false if the queue is full.
+	bool push(
+		const T& value)
+	{
+		const auto write_index = write_index_.load(std::memory_order_relaxed);
+		const auto next_write_index = get_next_index(write_index);
+
+		if (next_write_index == read_index_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		values_[write_index] = value;
+
+		write_index_.store(next_write_index, std::memory_order_release);
+
+		return true;
+	}
+
+	// Removes the oldest value from the queue.
+	//
+	// Returns true on success or false if the queue is empty.
+	bool pop(
+		T& value)
+	{
+		const auto read_index = read_index_.load(std::memory_order_relaxed);
+
+		if (read_index == write_index_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value = values_[read_index];
+
+		read_index_.store(get_next_index(read_index), std::memory_order_release);
+
+		return true;
+	}
+
+
+private:
+	using Values = ArenaVector<T>;
+
+
+	Values values_;
+	std::atomic<int> read_index_;
+	std::atomic<int> write_index_;
+
+
+	int get_next_index(
+		const int index) const
+	{
+		const auto next_index = index + 1;
+
+		return next_index < static_cast<int>(values_.size()) ? next_index : 0;
+	}
+}; // SpscQueue
+
+
+struct Source
+{
+	struct Send
+	{
+		struct Channel
+		{
+			Gains current_gains_;
+			Gains target_gains_;
+
+
+			void reset()
+			{
+				current_gains_.fill(0.0F);
+				target_gains_.fill(0.0F);
+			}
+		}; // Channel
+
+		using Channels = std::array<Channel, max_channels>;
+		using Filters = FilterBank<max_channels>;
+
+
+		// Used by the mixing.
+		SendProps props_;
+
+		// Used by the control.
+		SendProps deferred_props_;
+		SendProps applied_props_;
+
+		// The applied properties on the way from the control to the mixing.
+		TripleBuffer<SendProps> props_handoff_;
+
+		ActiveFilters filter_type_;
+		Filters low_pass_;
+		Filters high_pass_;
+		Channels channels_;
+		SampleBuffers* buffers_;
+		int channel_count_;
+	}; // Send
+
+	using Sends = ArenaVector<Send>;
+
+
+	Source()
+		:
+		direct_{},
+		auxes_{},
+		are_props_changed_{}
+	{
+	}
+
+
+	Send direct_;
+	Sends auxes_;
+	bool are_props_changed_;
+
+
+	void initialize(
+		const int effect_count)
+	{
+		direct_.props_.set_defaults();
+		direct_.deferred_props_.set_defaults();
+		direct_.applied_props_.set_defaults();
+
+		// Note: The sends are not movable.
+		auxes_ = Sends(effect_count);
+
+		for (auto& aux : auxes_)
+		{
+			aux.props_.set_defaults();
+			aux.deferred_props_.set_defaults();
+			aux.applied_props_.set_defaults();
+		}
+
+		are_props_changed_ = true;
+
+		direct_.low_pass_.reset();
+		direct_.high_pass_.reset();
+
+		for (auto& aux : auxes_)
+		{
+			aux.low_pass_.reset();
+			aux.high_pass_.reset();
+		}
+
+		for (int i = 0; i < max_channels; ++i)
+		{
+			direct_.channels_[i].reset();
+
+			for (auto& aux : auxes_)
+			{
+				aux.channels_[i].reset();
+			}
+		}
+	}
+}; // Source
+
+using Sources = ArenaVector<Source>;
+
+
+// ==========================================================================
+// EffectProps
+
+constexpr int EffectProps::Chorus::waveform_sinusoid;
+constexpr int EffectProps::Chorus::waveform_triangle;
+
+constexpr int EffectProps::Chorus::min_waveform;
+constexpr int EffectProps::Chorus::max_waveform;
+constexpr int EffectProps::Chorus::default_waveform;
+
+constexpr int EffectProps::Chorus::min_phase;
+constexpr int EffectProps::Chorus::max_phase;
+constexpr int EffectProps::Chorus::default_phase;
+
+constexpr float EffectProps::Chorus::min_rate;
+constexpr float EffectProps::Chorus::max_rate;
+constexpr float EffectProps::Chorus::default_rate;
+
+constexpr float EffectProps::Chorus::min_depth;
+constexpr float EffectProps::Chorus::max_depth;
+constexpr float EffectProps::Chorus::default_depth;
+
+constexpr float EffectProps::Chorus::min_feedback;
+constexpr float EffectProps::Chorus::max_feedback;
+constexpr float EffectProps::Chorus::default_feedback;
+
+constexpr float EffectProps::Chorus::min_delay;
+constexpr float EffectProps::Chorus::max_delay;
+constexpr float EffectProps::Chorus::default_delay;
+
+constexpr bool EffectProps::Compressor::min_on_off;
+constexpr bool EffectProps::Compressor::max_on_off;
+constexpr bool EffectProps::Compressor::default_on_off;
+
+constexpr float EffectProps::Dedicated::min_gain;
+constexpr float EffectProps::Dedicated::max_gain;
+constexpr float EffectProps::Dedicated::default_gain;
+
+constexpr float EffectProps::Distortion::min_edge;
+constexpr float EffectProps::Distortion::max_edge;
+constexpr float EffectProps::Distortion::default_edge;
+
+constexpr float EffectProps::Distortion::min_gain;
+constexpr float EffectProps::Distortion::max_gain;
+constexpr float EffectProps::Distortion::default_gain;
+
+constexpr float EffectProps::Distortion::min_low_pass_cutoff;
+constexpr float EffectProps::Distortion::max_low_pass_cutoff;
+constexpr float EffectProps::Distortion::default_low_pass_cutoff;
+
+constexpr float EffectProps::Distortion::min_eq_center;
+constexpr float EffectProps::Distortion::max_eq_center;
+constexpr float EffectProps::Distortion::default_eq_center;
+
+constexpr float EffectProps::Distortion::min_eq_bandwidth;
+constexpr float EffectProps::Distortion::max_eq_bandwidth;
+constexpr float EffectProps::Distortion::default_eq_bandwidth;
+
+constexpr float EffectProps::Echo::min_delay;
+constexpr float EffectProps::Echo::max_delay;
+constexpr float EffectProps::Echo::default_delay;
+
+constexpr float EffectProps::Echo::min_lr_delay;
+constexpr float EffectProps::Echo::max_lr_delay;
+constexpr float EffectProps::Echo::default_lr_delay;
+
+constexpr float EffectProps::Echo::min_damping;
+constexpr float EffectProps::Echo::max_damping;
+constexpr float EffectProps::Echo::default_damping;
+
+constexpr float EffectProps::Echo::min_feedback;
+constexpr float EffectProps::Echo::max_feedback;
+constexpr float EffectProps::Echo::default_feedback;
+
+constexpr float EffectProps::Echo::min_spread;
+constexpr float EffectProps::Echo::max_spread;
+constexpr float EffectProps::Echo::default_spread;
+
+constexpr float EffectProps::Equalizer::min_low_gain;
+constexpr float EffectProps::Equalizer::max_low_gain;
+constexpr float EffectProps::Equalizer::default_low_gain;
+
+constexpr float EffectProps::Equalizer::min_low_cutoff;
+constexpr float EffectProps::Equalizer::max_low_cutoff;
+constexpr float EffectProps::Equalizer::default_low_cutoff;
+
+constexpr float EffectProps::Equalizer::min_mid1_gain;
+constexpr float EffectProps::Equalizer::max_mid1_gain;
+constexpr float EffectProps::Equalizer::default_mid1_gain;
+
+constexpr float EffectProps::Equalizer::min_mid1_center;
+constexpr float EffectProps::Equalizer::max_mid1_center;
+constexpr float EffectProps::Equalizer::default_mid1_center;
+
+constexpr float EffectProps::Equalizer::min_mid1_width;
+constexpr float EffectProps::Equalizer::max_mid1_width;
+constexpr float EffectProps::Equalizer::default_mid1_width;
+
+constexpr float EffectProps::Equalizer::min_mid2_gain;
+constexpr float EffectProps::Equalizer::max_mid2_gain;
+constexpr float EffectProps::Equalizer::default_mid2_gain;
+
+constexpr float EffectProps::Equalizer::min_mid2_center;
+constexpr float EffectProps::Equalizer::max_mid2_center;
+constexpr float EffectProps::Equalizer::default_mid2_center;
+
+constexpr float EffectProps::Equalizer::min_mid2_width;
+constexpr float EffectProps::Equalizer::max_mid2_width;
+constexpr float EffectProps::Equalizer::default_mid2_width;
+
+constexpr float EffectProps::Equalizer::min_high_gain;
+constexpr float EffectProps::Equalizer::max_high_gain;
+constexpr float EffectProps::Equalizer::default_high_gain;
+
+constexpr float EffectProps::Equalizer::min_high_cutoff;
+constexpr float EffectProps::Equalizer::max_high_cutoff;
+constexpr float EffectProps::Equalizer::default_high_cutoff;
+
+constexpr int EffectProps::Flanger::waveform_sinusoid;
+constexpr int EffectProps::Flanger::waveform_triangle;
+
+constexpr int EffectProps::Flanger::min_waveform;
+constexpr int EffectProps::Flanger::max_waveform;
+constexpr int EffectProps::Flanger::default_waveform;
+
+constexpr int EffectProps::Flanger::min_phase;
+constexpr int EffectProps::Flanger::max_phase;
+constexpr int EffectProps::Flanger::default_phase;
+
+constexpr float EffectProps::Flanger::min_rate;
+constexpr float EffectProps::Flanger::max_rate;
+constexpr float EffectProps::Flanger::default_rate;
+
+constexpr float EffectProps::Flanger::min_depth;
+constexpr float EffectProps::Flanger::max_depth;
+constexpr float EffectProps::Flanger::default_depth;
+
+constexpr float EffectProps::Flanger::min_feedback;
+constexpr float EffectProps::Flanger::max_feedback;
+constexpr float EffectProps::Flanger::default_feedback;
+
+constexpr float EffectProps::Flanger::min_delay;
+constexpr float EffectProps::Flanger::max_delay;
+constexpr float EffectProps::Flanger::default_delay;
+
+constexpr float EffectProps::Reverb::min_density;
+constexpr float EffectProps::Reverb::max_density;
+constexpr float EffectProps::Reverb::default_density;
+
+constexpr float EffectProps::Reverb::min_diffusion;
+constexpr float EffectProps::Reverb::max_diffusion;
+constexpr float EffectProps::Reverb::default_diffusion;
+
+constexpr float EffectProps::Reverb::min_gain;
+constexpr float EffectProps::Reverb::max_gain;
+constexpr float EffectProps::Reverb::default_gain;
+
+constexpr float EffectProps::Reverb::min_gain_hf;
+constexpr float EffectProps::Reverb::max_gain_hf;
+constexpr float EffectProps::Reverb::default_gain_hf;
+
+constexpr float EffectProps::Reverb::min_gain_lf;
+constexpr float EffectProps::Reverb::max_gain_lf;
+constexpr float EffectProps::Reverb::default_gain_lf;
+
+constexpr float EffectProps::Reverb::min_decay_time;
+constexpr float EffectProps::Reverb::max_decay_time;
+constexpr float EffectProps::Reverb::default_decay_time;
+
+constexpr float EffectProps::Reverb::min_decay_hf_ratio;
+constexpr float EffectProps::Reverb::max_decay_hf_ratio;
+constexpr float EffectProps::Reverb::default_decay_hf_ratio;
+
+constexpr float EffectProps::Reverb::min_decay_lf_ratio;
+constexpr float EffectProps::Reverb::max_decay_lf_ratio;
+constexpr float EffectProps::Reverb::default_decay_lf_ratio;
+
+constexpr float EffectProps::Reverb::min_reflections_gain;
+constexpr float EffectProps::Reverb::max_reflections_gain;
+constexpr float EffectProps::Reverb::default_reflections_gain;
+
+constexpr float EffectProps::Reverb::min_reflections_delay;
+constexpr float EffectProps::Reverb::max_reflections_delay;
+constexpr float EffectProps::Reverb::default_reflections_delay;
+
+constexpr float EffectProps::Reverb::min_reflections_pan_xyz;
+constexpr float EffectProps::Reverb::max_reflections_pan_xyz;
+constexpr float EffectProps::Reverb::default_reflections_pan_xyz;
+
+constexpr float EffectProps::Reverb::min_late_reverb_gain;
+constexpr float EffectProps::Reverb::max_late_reverb_gain;
+constexpr float EffectProps::Reverb::default_late_reverb_gain;
+
+constexpr float EffectProps::Reverb::min_late_reverb_delay;
+constexpr float EffectProps::Reverb::max_late_reverb_delay;
+constexpr float EffectProps::Reverb::default_late_reverb_delay;
+
+constexpr float EffectProps::Reverb::min_late_reverb_pan_xyz;
+constexpr float EffectProps::Reverb::max_late_reverb_pan_xyz;
+constexpr float EffectProps::Reverb::default_late_reverb_pan_xyz;
+
+constexpr float EffectProps::Reverb::min_echo_time;
+constexpr float EffectProps::Reverb::max_echo_time;
+constexpr float EffectProps::Reverb::default_echo_time;
+
+constexpr float EffectProps::Reverb::min_echo_depth;
+constexpr float EffectProps::Reverb::max_echo_depth;
+constexpr float EffectProps::Reverb::default_echo_depth;
+
+constexpr float EffectProps::Reverb::min_modulation_time;
+constexpr float EffectProps::Reverb::max_modulation_time;
+constexpr float EffectProps::Reverb::default_modulation_time;
+
+constexpr float EffectProps::Reverb::min_modulation_depth;
+constexpr float EffectProps::Reverb::max_modulation_depth;
+constexpr float EffectProps::Reverb::default_modulation_depth;
+
+constexpr float EffectProps::Reverb::min_air_absorption_gain_hf;
+constexpr float EffectProps::Reverb::max_air_absorption_gain_hf;
+constexpr float EffectProps::Reverb::default_air_absorption_gain_hf;
+
+constexpr float EffectProps::Reverb::min_hf_reference;
+constexpr float EffectProps::Reverb::max_hf_reference;
+constexpr float EffectProps::Reverb::default_hf_reference;
+
+constexpr float EffectProps::Reverb::min_lf_reference;
+constexpr float EffectProps::Reverb::max_lf_reference;
+constexpr float EffectProps::Reverb::default_lf_reference;
+
+constexpr float EffectProps::Reverb::min_room_rolloff_factor;
+constexpr float EffectProps::Reverb::max_room_rolloff_factor;
+constexpr float EffectProps::Reverb::default_room_rolloff_factor;
+
+constexpr bool EffectProps::Reverb::min_decay_hf_limit;
+constexpr bool EffectProps::Reverb::max_decay_hf_limit;
+constexpr bool EffectProps::Reverb::default_decay_hf_limit;
+
+constexpr float EffectProps::RingModulator::min_frequency;
+constexpr float EffectProps::RingModulator::max_frequency;
+constexpr float EffectProps::RingModulator::default_frequency;
+
+constexpr float EffectProps::RingModulator::min_high_pass_cutoff;
+constexpr float EffectProps::RingModulator::max_high_pass_cutoff;
+constexpr float EffectProps::RingModulator::default_high_pass_cutoff;
+
+constexpr int EffectProps::RingModulator::waveform_sinusoid;
+constexpr int EffectProps::RingModulator::waveform_sawtooth;
+constexpr int EffectProps::RingModulator::waveform_square;
+
+constexpr int EffectProps::RingModulator::min_waveform;
+constexpr int EffectProps::RingModulator::max_waveform;
+constexpr int EffectProps::RingModulator::default_waveform;
+
+
+void EffectProps::Chorus::set_defaults()
+{
+	waveform_ = default_waveform;
+	phase_ = default_phase;
+	rate_ = default_rate;
+	depth_ = default_depth;
+	feedback_ = default_feedback;
+	delay_ = default_delay;
+}
+
+void EffectProps::Chorus::normalize()
+{
+	Math::clamp_i(waveform_, min_waveform, max_waveform);
+	Math::clamp_i(phase_, min_phase, max_phase);
+	Math::clamp_i(rate_, min_rate, max_rate);
+	Math::clamp_i(depth_, min_depth, max_depth);
+	Math::clamp_i(feedback_, min_feedback, max_feedback);
+	Math::clamp_i(delay_, min_delay, max_delay);
+}
+
+bool EffectProps::Chorus::are_equal(
+	const Chorus& a,
+	const Chorus& b)
+{
+	return
+		a.waveform_ == b.waveform_ &&
+		a.phase_ == b.phase_ &&
+		a.rate_ == b.rate_ &&
+		a.depth_ == b.depth_ &&
+		a.feedback_ == b.feedback_ &&
+		a.delay_ == b.delay_;
+}
+
+void EffectProps::Compressor::set_defaults()
+{
+	on_off_ = default_on_off;
+}
+
+void EffectProps::Compressor::normalize()
+{
+}
+
+bool EffectProps::Compressor::are_equal(
+	const Compressor& a,
+	const Compressor& b)
+{
+	return
+		a.on_off_ == b.on_off_;
+}
+
+void EffectProps::Dedicated::set_defaults()
+{
+	gain_ = default_gain;
+}
+
+void EffectProps::Dedicated::normalize()
+{
+	Math::clamp_i(gain_, min_gain, max_gain);
+}
+
+bool EffectProps::Dedicated::are_equal(
+	const Dedicated& a,
+	const Dedicated& b)
+{
+	return
+		a.gain_ == b.gain_;
+}
+
+void EffectProps::Distortion::set_defaults()
+{
+	edge_ = default_edge;
+	gain_ = default_gain;
+	low_pass_cutoff_ = default_low_pass_cutoff;
+	eq_center_ = default_eq_center;
+	eq_bandwidth_ = default_eq_bandwidth;
+}
+
+void EffectProps::Distortion::normalize()
+{
+	Math::clamp_i(edge_, min_edge, max_edge);
+	Math::clamp_i(gain_, min_gain, max_gain);
+	Math::clamp_i(low_pass_cutoff_, min_low_pass_cutoff, max_low_pass_cutoff);
+	Math::clamp_i(eq_center_, min_eq_center, max_eq_center);
+	Math::clamp_i(eq_bandwidth_, min_eq_bandwidth, max_eq_bandwidth);
+}
+
+bool EffectProps::Distortion::are_equal(
+	const Distortion& a,
+	const Distortion& b)
+{
+	return
+		a.edge_ == b.edge_ &&
+		a.gain_ == b.gain_ &&
+		a.low_pass_cutoff_ == b.low_pass_cutoff_ &&
+		a.eq_center_ == b.eq_center_ &&
+		a.eq_bandwidth_ == b.eq_bandwidth_;
+}
+
+void EffectProps::Echo::set_defaults()
+{
+	delay_ = default_delay;
+	lr_delay_ = default_lr_delay;
+	damping_ = default_damping;
+	feedback_ = default_feedback;
+	spread_ = default_spread;
+}
+
+void EffectProps::Echo::normalize()
+{
+	Math::clamp_i(delay_, min_delay, max_delay);
+	Math::clamp_i(lr_delay_, min_lr_delay, max_lr_delay);
+	Math::clamp_i(damping_, min_damping, max_damping);
+	Math::clamp_i(feedback_, min_feedback, max_feedback);
+	Math::clamp_i(spread_, min_spread, max_spread);
+}
+
+bool EffectProps::Echo::are_equal(
+	const Echo& a,
+	const Echo& b)
+{
+	return
+		a.delay_ == b.delay_ &&
+		a.lr_delay_ == b.lr_delay_ &&
+		a.damping_ == b.damping_ &&
+		a.feedback_ == b.feedback_ &&
+		a.spread_ == b.spread_;
+}
+
+void EffectProps::Equalizer::set_defaults()
+{
+	low_cutoff_ = default_low_cutoff;
+	low_gain_ = default_high_gain;
+	mid1_center_ = default_mid1_center;
+	mid1_gain_ = default_mid1_gain;
+	mid1_width_ = default_mid1_width;
+	mid2_center_ = default_mid2_center;
+	mid2_gain_ = default_mid2_gain;
+	mid2_width_ = default_mid2_width;
+	high_cutoff_ = default_high_cutoff;
+	high_gain_ = default_high_gain;
+}
+
+void EffectProps::Equalizer::normalize()
+{
+	Math::clamp_i(low_cutoff_, min_low_cutoff, max_low_cutoff);
+	Math::clamp_i(low_gain_, min_low_gain, max_low_gain);
+	Math::clamp_i(mid1_center_, min_mid1_center, max_mid1_center);
+	Math::clamp_i(mid1_gain_, min_mid1_gain, max_mid1_gain);
+	Math::clamp_i(mid1_width_, min_mid1_width, max_mid1_width);
+	Math::clamp_i(mid2_center_, min_mid2_center, max_mid2_center);
+	Math::clamp_i(mid2_gain_, min_mid2_gain, max_mid2_gain);
+	Math::clamp_i(mid2_width_, min_mid2_width, max_mid2_width);
+	Math::clamp_i(high_cutoff_, min_high_cutoff, max_high_cutoff);
+	Math::clamp_i(high_gain_, min_high_gain, max_high_gain);
+}
+
+bool EffectProps::Equalizer::are_equal(
+	const Equalizer& a,
+	const Equalizer& b)
+{
+	return
+		a.low_cutoff_ == b.low_cutoff_ &&
+		a.low_gain_ == b.low_gain_ &&
+		a.mid1_center_ == b.mid1_center_ &&
+		a.mid1_gain_ == b.mid1_gain_ &&
+		a.mid1_width_ == b.mid1_width_ &&
+		a.mid2_center_ == b.mid2_center_ &&
+		a.mid2_gain_ == b.mid2_gain_ &&
+		a.mid2_width_ == b.mid2_width_ &&
+		a.high_cutoff_ == b.high_cutoff_ &&
+		a.high_gain_ == b.high_gain_;
+}
+
+void EffectProps::Flanger::set_defaults()
+{
+	waveform_ = default_waveform;
+	phase_ = default_phase;
+	rate_ = default_rate;
+	depth_ = default_depth;
+	feedback_ = default_feedback;
+	delay_ = default_delay;
+}
+
+void EffectProps::Flanger::normalize()
+{
+	Math::clamp_i(waveform_, min_waveform, max_waveform);
+	Math::clamp_i(phase_, min_phase, max_phase);
+	Math::clamp_i(rate_, min_rate, max_rate);
+	Math::clamp_i(depth_, min_depth, max_depth);
+	Math::clamp_i(feedback_, min_feedback, max_feedback);
+	Math::clamp_i(delay_, min_delay, max_delay);
+}
+
+bool EffectProps::Flanger::are_equal(
+	const Flanger& a,
+	const Flanger& b)
+{
+	return
+		a.waveform_ == b.waveform_ &&
+		a.phase_ == b.phase_ &&
+		a.rate_ == b.rate_ &&
+		a.depth_ == b.depth_ &&
+		a.feedback_ == b.feedback_ &&
+		a.delay_ == b.delay_;
+}
+
+void EffectProps::Reverb::set_defaults()
+{
+	density_ = default_density;
+	diffusion_ = default_diffusion;
+	gain_ = default_gain;
+	gain_hf_ = default_gain_hf;
+	gain_lf_ = default_gain_lf;
+	decay_time_ = default_decay_time;
+	decay_hf_ratio_ = default_decay_hf_ratio;
+	decay_lf_ratio_ = default_decay_lf_ratio;
+	reflections_gain_ = default_reflections_gain;
+	reflections_delay_ = default_reflections_delay;
+	reflections_pan_.fill(default_reflections_pan_xyz);
+	late_reverb_gain_ = default_late_reverb_gain;
+	late_reverb_delay_ = default_late_reverb_delay;
+	late_reverb_pan_.fill(default_late_reverb_pan_xyz);
+	echo_time_ = default_echo_time;
+	echo_depth_ = default_echo_depth;
+	modulation_time_ = default_modulation_time;
+	modulation_depth_ = default_modulation_depth;
 	air_absorption_gain_hf_ = default_air_absorption_gain_hf;
 	hf_reference_ = default_hf_reference;
 	lf_reference_ = default_lf_reference;
@@ -1639,2270 +3415,5492 @@ void EffectProps::Reverb::set_defaults()
 	decay_hf_limit_ = default_decay_hf_limit;
 }
 
-void EffectProps::Reverb::normalize()
+void EffectProps::Reverb::normalize()
+{
+	Math::clamp_i(density_, min_density, max_density);
+	Math::clamp_i(diffusion_, min_diffusion, max_diffusion);
+	Math::clamp_i(gain_, min_gain, max_gain);
+	Math::clamp_i(gain_hf_, min_gain_hf, max_gain_hf);
+	Math::clamp_i(gain_lf_, min_gain_lf, max_gain_lf);
+	Math::clamp_i(decay_time_, min_decay_time, max_decay_time);
+	Math::clamp_i(decay_hf_ratio_, min_decay_hf_ratio, max_decay_hf_ratio);
+	Math::clamp_i(decay_lf_ratio_, min_decay_lf_ratio, max_decay_lf_ratio);
+	Math::clamp_i(reflections_gain_, min_reflections_gain, max_reflections_gain);
+	Math::clamp_i(reflections_delay_, min_reflections_delay, max_reflections_delay);
+	Math::clamp_i(reflections_pan_[0], min_reflections_pan_xyz, max_reflections_pan_xyz);
+	Math::clamp_i(reflections_pan_[1], min_reflections_pan_xyz, max_reflections_pan_xyz);
+	Math::clamp_i(reflections_pan_[2], min_reflections_pan_xyz, max_reflections_pan_xyz);
+	Math::clamp_i(late_reverb_gain_, min_late_reverb_gain, max_late_reverb_gain);
+	Math::clamp_i(late_reverb_delay_, min_late_reverb_delay, max_late_reverb_delay);
+	Math::clamp_i(late_reverb_pan_[0], min_late_reverb_pan_xyz, max_late_reverb_pan_xyz);
+	Math::clamp_i(late_reverb_pan_[1], min_late_reverb_pan_xyz, max_late_reverb_pan_xyz);
+	Math::clamp_i(late_reverb_pan_[2], min_late_reverb_pan_xyz, max_late_reverb_pan_xyz);
+	Math::clamp_i(echo_time_, min_echo_time, max_echo_time);
+	Math::clamp_i(echo_depth_, min_echo_depth, max_echo_depth);
+	Math::clamp_i(modulation_time_, min_modulation_time, max_modulation_time);
+	Math::clamp_i(modulation_depth_, min_modulation_depth, max_modulation_depth);
+	Math::clamp_i(air_absorption_gain_hf_, min_air_absorption_gain_hf, max_air_absorption_gain_hf);
+	Math::clamp_i(hf_reference_, min_hf_reference, max_hf_reference);
+	Math::clamp_i(lf_reference_, min_lf_reference, max_lf_reference);
+	Math::clamp_i(room_rolloff_factor_, min_room_rolloff_factor, max_room_rolloff_factor);
+	Math::clamp_i(decay_hf_limit_, min_decay_hf_limit, max_decay_hf_limit);
+}
+
+bool EffectProps::Reverb::are_equal(
+	const Reverb& a,
+	const Reverb& b)
+{
+	return
+		a.density_ == b.density_ &&
+		a.diffusion_ == b.diffusion_ &&
+		a.gain_ == b.gain_ &&
+		a.gain_hf_ == b.gain_hf_ &&
+		a.gain_lf_ == b.gain_lf_ &&
+		a.decay_time_ == b.decay_time_ &&
+		a.decay_hf_ratio_ == b.decay_hf_ratio_ &&
+		a.decay_lf_ratio_ == b.decay_lf_ratio_ &&
+		a.reflections_gain_ == b.reflections_gain_ &&
+		a.reflections_delay_ == b.reflections_delay_ &&
+		a.reflections_pan_ == b.reflections_pan_ &&
+		a.late_reverb_gain_ == b.late_reverb_gain_ &&
+		a.late_reverb_delay_ == b.late_reverb_delay_ &&
+		a.late_reverb_pan_ == b.late_reverb_pan_ &&
+		a.echo_time_ == b.echo_time_ &&
+		a.echo_depth_ == b.echo_depth_ &&
+		a.modulation_time_ == b.modulation_time_ &&
+		a.modulation_depth_ == b.modulation_depth_ &&
+		a.air_absorption_gain_hf_ == b.air_absorption_gain_hf_ &&
+		a.hf_reference_ == b.hf_reference_ &&
+		a.lf_reference_ == b.lf_reference_ &&
+		a.room_rolloff_factor_ == b.room_rolloff_factor_ &&
+		a.decay_hf_limit_ == b.decay_hf_limit_;
+}
+
+void EffectProps::RingModulator::set_defaults()
+{
+	frequency_ = default_frequency;
+	high_pass_cutoff_ = default_high_pass_cutoff;
+	waveform_ = default_waveform;
+}
+
+void EffectProps::RingModulator::normalize()
+{
+	Math::clamp_i(frequency_, min_frequency, max_frequency);
+	Math::clamp_i(high_pass_cutoff_, min_high_pass_cutoff, max_high_pass_cutoff);
+	Math::clamp_i(waveform_, min_waveform, max_waveform);
+}
+
+bool EffectProps::RingModulator::are_equal(
+	const RingModulator& a,
+	const RingModulator& b)
+{
+	return
+		a.frequency_ == b.frequency_ &&
+		a.high_pass_cutoff_ == b.high_pass_cutoff_ &&
+		a.waveform_ == b.waveform_;
+}
+
+// EffectProps
+// ==========================================================================
+
+
+// ==========================================================================
+// Effect
+
+void Effect::set_defaults()
+{
+	switch (type_)
+	{
+	case EffectType::chorus:
+		props_.chorus_.set_defaults();
+		break;
+
+	case EffectType::compressor:
+		props_.compressor_.set_defaults();
+		break;
+
+	case EffectType::dedicated_dialog:
+	case EffectType::dedicated_low_frequency:
+		props_.dedicated_.set_defaults();
+		break;
+
+	case EffectType::distortion:
+		props_.distortion_.set_defaults();
+		break;
+
+	case EffectType::echo:
+		props_.echo_.set_defaults();
+		break;
+
+	case EffectType::equalizer:
+		props_.equalizer_.set_defaults();
+		break;
+
+	case EffectType::flanger:
+		props_.flanger_.set_defaults();
+		break;
+
+	case EffectType::eax_reverb:
+	case EffectType::reverb:
+		props_.reverb_.set_defaults();
+		break;
+
+	case EffectType::ring_modulator:
+		props_.ring_modulator_.set_defaults();
+		break;
+
+	case EffectType::null:
+	default:
+		break;
+	}
+}
+
+void Effect::set_type_and_defaults(
+	const EffectType effect_type)
+{
+	type_ = effect_type;
+	set_defaults();
+}
+
+void Effect::normalize()
+{
+	switch (type_)
+	{
+	case EffectType::chorus:
+		props_.chorus_.normalize();
+		break;
+
+	case EffectType::compressor:
+		props_.compressor_.normalize();
+		break;
+
+	case EffectType::dedicated_dialog:
+	case EffectType::dedicated_low_frequency:
+		props_.dedicated_.normalize();
+		break;
+
+	case EffectType::distortion:
+		props_.distortion_.normalize();
+		break;
+
+	case EffectType::echo:
+		props_.echo_.normalize();
+		break;
+
+	case EffectType::equalizer:
+		props_.equalizer_.normalize();
+		break;
+
+	case EffectType::flanger:
+		props_.flanger_.normalize();
+		break;
+
+	case EffectType::eax_reverb:
+	case EffectType::reverb:
+		props_.reverb_.normalize();
+		break;
+
+	case EffectType::ring_modulator:
+		props_.ring_modulator_.normalize();
+		break;
+
+	case EffectType::null:
+	default:
+		break;
+	}
+}
+
+bool Effect::are_equal(
+	const Effect& a,
+	const Effect& b)
+{
+	if (a.type_ != b.type_)
+	{
+		return false;
+	}
+
+	switch (a.type_)
+	{
+	case EffectType::null:
+		return true;
+
+	case EffectType::chorus:
+		return EffectProps::Chorus::are_equal(a.props_.chorus_, b.props_.chorus_);
+
+	case EffectType::compressor:
+		return EffectProps::Compressor::are_equal(a.props_.compressor_, b.props_.compressor_);
+
+	case EffectType::dedicated_dialog:
+	case EffectType::dedicated_low_frequency:
+		return EffectProps::Dedicated::are_equal(a.props_.dedicated_, b.props_.dedicated_);
+
+	case EffectType::distortion:
+		return EffectProps::Distortion::are_equal(a.props_.distortion_, b.props_.distortion_);
+
+	case EffectType::echo:
+		return EffectProps::Echo::are_equal(a.props_.echo_, b.props_.echo_);
+
+	case EffectType::equalizer:
+		return EffectProps::Equalizer::are_equal(a.props_.equalizer_, b.props_.equalizer_);
+
+	case EffectType::flanger:
+		return EffectProps::Flanger::are_equal(a.props_.flanger_, b.props_.flanger_);
+
+	case EffectType::eax_reverb:
+	case EffectType::reverb:
+		return EffectProps::Reverb::are_equal(a.props_.reverb_, b.props_.reverb_);
+
+	case EffectType::ring_modulator:
+		return EffectProps::RingModulator::are_equal(a.props_.ring_modulator_, b.props_.ring_modulator_);
+
+	default:
+		return false;
+	}
+}
+
+// Effect
+// ==========================================================================
+
+
+// ==========================================================================
+// SendProps
+
+constexpr float SendProps::lp_frequency_reference;
+constexpr float SendProps::hp_frequency_reference;
+
+constexpr float SendProps::min_gain;
+constexpr float SendProps::max_gain;
+constexpr float SendProps::default_gain;
+
+constexpr float SendProps::min_gain_hf;
+constexpr float SendProps::max_gain_hf;
+constexpr float SendProps::default_gain_hf;
+
+constexpr float SendProps::min_gain_lf;
+constexpr float SendProps::max_gain_lf;
+constexpr float SendProps::default_gain_lf;
+
+
+void SendProps::set_defaults()
+{
+	gain_ = default_gain;
+	gain_hf_ = default_gain_hf;
+	gain_lf_ = default_gain_lf;
+}
+
+void SendProps::normalize()
+{
+	Math::clamp_i(gain_, min_gain, max_gain);
+	Math::clamp_i(gain_hf_, min_gain_hf, max_gain_hf);
+	Math::clamp_i(gain_lf_, min_gain_lf, max_gain_lf);
+}
+
+bool SendProps::are_equal(
+	const SendProps& a,
+	const SendProps& b)
+{
+	return
+		a.gain_ == b.gain_ &&
+		a.gain_hf_ == b.gain_hf_ &&
+		a.gain_lf_ == b.gain_lf_;
+}
+
+// SendProps
+// ==========================================================================
+
+
+// ==========================================================================
+// InitParams
+
+constexpr ChannelFormat InitParams::default_channel_format;
+constexpr int InitParams::default_sampling_rate;
+constexpr int InitParams::default_effect_count;
+constexpr int InitParams::default_source_count;
+constexpr int InitParams::default_block_size;
+constexpr int InitParams::default_worker_count;
+constexpr bool InitParams::default_are_effect_states_pooled;
+constexpr int InitParams::default_distortion_oversampling_factor;
+
+
+void InitParams::set_defaults()
+{
+	channel_format_ = default_channel_format;
+	sampling_rate_ = default_sampling_rate;
+	effect_count_ = default_effect_count;
+	source_count_ = default_source_count;
+	block_size_ = default_block_size;
+	worker_count_ = default_worker_count;
+	are_effect_states_pooled_ = default_are_effect_states_pooled;
+	distortion_oversampling_factor_ = default_distortion_oversampling_factor;
+	memory_resource_ = nullptr;
+}
+
+// InitParams
+// ==========================================================================
+
+// ==========================================================================
+// MemoryResource
+
+// Allocates the memory from the global heap.
+class HeapMemoryResource final :
+	public MemoryResource
+{
+protected:
+	void* do_allocate(
+		const std::size_t size,
+		const std::size_t alignment) final
+	{
+		// Over-allocate to align the block and to store the original pointer before it.
+		const auto raw_block = std::malloc(size + alignment + sizeof(void*));
+
+		if (!raw_block)
+		{
+			return nullptr;
+		}
+
+		auto address = reinterpret_cast<std::uintptr_t>(raw_block) + sizeof(void*);
+		address = (address + alignment - 1) & ~(alignment - 1);
+
+		const auto block = reinterpret_cast<void**>(address);
+		block[-1] = raw_block;
+
+		return block;
+	}
+
+	void do_deallocate(
+		void* const pointer,
+		const std::size_t size,
+		const std::size_t alignment) final
+	{
+		static_cast<void>(size);
+		static_cast<void>(alignment);
+
+		if (!pointer)
+		{
+			return;
+		}
+
+		std::free(static_cast<void**>(pointer)[-1]);
+	}
+}; // HeapMemoryResource
+
+
+MemoryResource::~MemoryResource()
+{
+}
+
+void* MemoryResource::allocate(
+	const std::size_t size,
+	const std::size_t alignment)
+{
+	return do_allocate(size, alignment);
+}
+
+void MemoryResource::deallocate(
+	void* const pointer,
+	const std::size_t size,
+	const std::size_t alignment)
+{
+	do_deallocate(pointer, size, alignment);
+}
+
+MemoryResource* MemoryResource::get_default()
+{
+	static auto heap_memory_resource = HeapMemoryResource{};
+
+	return &heap_memory_resource;
+}
+
+// MemoryResource
+// ==========================================================================
+
+// ==========================================================================
+// RtChecks
+
+bool RtChecks::is_enabled()
+{
+#ifdef OALSFXPP_RT_CHECKS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void RtChecks::set_violation_handler(
+	const ViolationHandler handler,
+	void* const user_data)
+{
+#ifdef OALSFXPP_RT_CHECKS
+	RtScope::violation_handler_ = handler ? handler : RtScope::default_violation_handler;
+	RtScope::violation_handler_user_data_ = handler ? user_data : nullptr;
+#else
+	static_cast<void>(handler);
+	static_cast<void>(user_data);
+#endif
+}
+
+// RtChecks
+// ==========================================================================
+
+// ==========================================================================
+// Reverb presets
+
+// Default
+//
+const EffectProps::Reverb ReverbPresets::Default::generic = {1.0000F, 1.0000F, 0.3162F, 0.8913F, 1.0000F, 1.4900F, 0.8300F, 1.0000F, 0.0500F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::padded_cell = {0.1715F, 1.0000F, 0.3162F, 0.0010F, 1.0000F, 0.1700F, 0.1000F, 1.0000F, 0.2500F, 0.0010F, {0.0000F, 0.0000F, 0.0000F}, 1.2691F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::room = {0.4287F, 1.0000F, 0.3162F, 0.5929F, 1.0000F, 0.4000F, 0.8300F, 1.0000F, 0.1503F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 1.0629F, 0.0030F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::bathroom = {0.1715F, 1.0000F, 0.3162F, 0.2512F, 1.0000F, 1.4900F, 0.5400F, 1.0000F, 0.6531F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 3.2734F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::living_room = {0.9766F, 1.0000F, 0.3162F, 0.0010F, 1.0000F, 0.5000F, 0.1000F, 1.0000F, 0.2051F, 0.0030F, {0.0000F, 0.0000F, 0.0000F}, 0.2805F, 0.0040F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::stone_room = {1.0000F, 1.0000F, 0.3162F, 0.7079F, 1.0000F, 2.3100F, 0.6400F, 1.0000F, 0.4411F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1003F, 0.0170F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::auditorium = {1.0000F, 1.0000F, 0.3162F, 0.5781F, 1.0000F, 4.3200F, 0.5900F, 1.0000F, 0.4032F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.7170F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::concert_hall = {1.0000F, 1.0000F, 0.3162F, 0.5623F, 1.0000F, 3.9200F, 0.7000F, 1.0000F, 0.2427F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.9977F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::cave = {1.0000F, 1.0000F, 0.3162F, 1.0000F, 1.0000F, 2.9100F, 1.3000F, 1.0000F, 0.5000F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.7063F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Default::arena = {1.0000F, 1.0000F, 0.3162F, 0.4477F, 1.0000F, 7.2400F, 0.3300F, 1.0000F, 0.2612F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.0186F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::hangar = {1.0000F, 1.0000F, 0.3162F, 0.3162F, 1.0000F, 10.0500F, 0.2300F, 1.0000F, 0.5000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.2560F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::carpeted_hallway = {0.4287F, 1.0000F, 0.3162F, 0.0100F, 1.0000F, 0.3000F, 0.1000F, 1.0000F, 0.1215F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 0.1531F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::hallway = {0.3645F, 1.0000F, 0.3162F, 0.7079F, 1.0000F, 1.4900F, 0.5900F, 1.0000F, 0.2458F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.6615F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::stone_corridor = {1.0000F, 1.0000F, 0.3162F, 0.7612F, 1.0000F, 2.7000F, 0.7900F, 1.0000F, 0.2472F, 0.0130F, {0.0000F, 0.0000F, 0.0000F}, 1.5758F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::alley = {1.0000F, 0.3000F, 0.3162F, 0.7328F, 1.0000F, 1.4900F, 0.8600F, 1.0000F, 0.2500F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.9954F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 0.9500F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::forest = {1.0000F, 0.3000F, 0.3162F, 0.0224F, 1.0000F, 1.4900F, 0.5400F, 1.0000F, 0.0525F, 0.1620F, {0.0000F, 0.0000F, 0.0000F}, 0.7682F, 0.0880F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::city = {1.0000F, 0.5000F, 0.3162F, 0.3981F, 1.0000F, 1.4900F, 0.6700F, 1.0000F, 0.0730F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.1427F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::mountains = {1.0000F, 0.2700F, 0.3162F, 0.0562F, 1.0000F, 1.4900F, 0.2100F, 1.0000F, 0.0407F, 0.3000F, {0.0000F, 0.0000F, 0.0000F}, 0.1919F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Default::quarry = {1.0000F, 1.0000F, 0.3162F, 0.3162F, 1.0000F, 1.4900F, 0.8300F, 1.0000F, 0.0000F, 0.0610F, {0.0000F, 0.0000F, 0.0000F}, 1.7783F, 0.0250F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 0.7000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::plain = {1.0000F, 0.2100F, 0.3162F, 0.1000F, 1.0000F, 1.4900F, 0.5000F, 1.0000F, 0.0585F, 0.1790F, {0.0000F, 0.0000F, 0.0000F}, 0.1089F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::parking_lot = {1.0000F, 1.0000F, 0.3162F, 1.0000F, 1.0000F, 1.6500F, 1.5000F, 1.0000F, 0.2082F, 0.0080F, {0.0000F, 0.0000F, 0.0000F}, 0.2652F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Default::sewer_pipe = {0.3071F, 0.8000F, 0.3162F, 0.3162F, 1.0000F, 2.8100F, 0.1400F, 1.0000F, 1.6387F, 0.0140F, {0.0000F, 0.0000F, 0.0000F}, 3.2471F, 0.0210F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::underwater = {0.3645F, 1.0000F, 0.3162F, 0.0100F, 1.0000F, 1.4900F, 0.1000F, 1.0000F, 0.5963F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 7.0795F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 1.1800F, 0.3480F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Default::drugged = {0.4287F, 0.5000F, 0.3162F, 1.0000F, 1.0000F, 8.3900F, 1.3900F, 1.0000F, 0.8760F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 3.1081F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 1.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Default::dizzy = {0.3645F, 0.6000F, 0.3162F, 0.6310F, 1.0000F, 17.2300F, 0.5600F, 1.0000F, 0.1392F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.4937F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.8100F, 0.3100F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Default::psychotic = {0.0625F, 0.5000F, 0.3162F, 0.8404F, 1.0000F, 7.5600F, 0.9100F, 1.0000F, 0.4864F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 2.4378F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 4.0000F, 1.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+// Castle
+//
+const EffectProps::Reverb ReverbPresets::Castle::small_room = {1.0000F, 0.8900F, 0.3162F, 0.3981F, 0.1000F, 1.2200F, 0.8300F, 0.3100F, 0.8913F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Castle::short_passage = {1.0000F, 0.8900F, 0.3162F, 0.3162F, 0.1000F, 2.3200F, 0.8300F, 0.3100F, 0.8913F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Castle::medium_room = {1.0000F, 0.9300F, 0.3162F, 0.2818F, 0.1000F, 2.0400F, 0.8300F, 0.4600F, 0.6310F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 1.5849F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1550F, 0.0300F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Castle::large_room = {1.0000F, 0.8200F, 0.3162F, 0.2818F, 0.1259F, 2.5300F, 0.8300F, 0.5000F, 0.4467F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.1850F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Castle::long_passage = {1.0000F, 0.8900F, 0.3162F, 0.3981F, 0.1000F, 3.4200F, 0.8300F, 0.3100F, 0.8913F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Castle::hall = {1.0000F, 0.8100F, 0.3162F, 0.2818F, 0.1778F, 3.1400F, 0.7900F, 0.6200F, 0.1778F, 0.0560F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Castle::cupboard = {1.0000F, 0.8900F, 0.3162F, 0.2818F, 0.1000F, 0.6700F, 0.8700F, 0.3100F, 1.4125F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 3.5481F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Castle::courtyard = {1.0000F, 0.4200F, 0.3162F, 0.4467F, 0.1995F, 2.1300F, 0.6100F, 0.2300F, 0.2239F, 0.1600F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0360F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.3700F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Castle::alcove = {1.0000F, 0.8900F, 0.3162F, 0.5012F, 0.1000F, 1.6400F, 0.8700F, 0.3100F, 1.0000F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+
+// Factory
+//
+const EffectProps::Reverb ReverbPresets::Factory::small_room = {0.3645F, 0.8200F, 0.3162F, 0.7943F, 0.5012F, 1.7200F, 0.6500F, 1.3100F, 0.7079F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.7783F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.1190F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::short_passage = {0.3645F, 0.6400F, 0.2512F, 0.7943F, 0.5012F, 2.5300F, 0.6500F, 1.3100F, 1.0000F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.1350F, 0.2300F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::medium_room = {0.4287F, 0.8200F, 0.2512F, 0.7943F, 0.5012F, 2.7600F, 0.6500F, 1.3100F, 0.2818F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.1740F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::large_room = {0.4287F, 0.7500F, 0.2512F, 0.7079F, 0.6310F, 4.2400F, 0.5100F, 1.3100F, 0.1778F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.2310F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::long_passage = {0.3645F, 0.6400F, 0.2512F, 0.7943F, 0.5012F, 4.0600F, 0.6500F, 1.3100F, 1.0000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0370F, {0.0000F, 0.0000F, 0.0000F}, 0.1350F, 0.2300F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::hall = {0.4287F, 0.7500F, 0.3162F, 0.7079F, 0.6310F, 7.4300F, 0.5100F, 1.3100F, 0.0631F, 0.0730F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0270F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::cupboard = {0.3071F, 0.6300F, 0.2512F, 0.7943F, 0.5012F, 0.4900F, 0.6500F, 1.3100F, 1.2589F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.1070F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::courtyard = {0.3071F, 0.5700F, 0.3162F, 0.3162F, 0.6310F, 2.3200F, 0.2900F, 0.5600F, 0.2239F, 0.1400F, {0.0000F, 0.0000F, 0.0000F}, 0.3981F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2900F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Factory::alcove = {0.3645F, 0.5900F, 0.2512F, 0.7943F, 0.5012F, 3.1400F, 0.6500F, 1.3100F, 1.4125F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.1140F, 0.1000F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+
+// Ice palace
+//
+const EffectProps::Reverb ReverbPresets::IcePalace::small_room = {1.0000F, 0.8400F, 0.3162F, 0.5623F, 0.2818F, 1.5100F, 1.5300F, 0.2700F, 0.8913F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1640F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::short_passage = {1.0000F, 0.7500F, 0.3162F, 0.5623F, 0.2818F, 1.7900F, 1.4600F, 0.2800F, 0.5012F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0190F, {0.0000F, 0.0000F, 0.0000F}, 0.1770F, 0.0900F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::medium_room = {1.0000F, 0.8700F, 0.3162F, 0.5623F, 0.4467F, 2.2200F, 1.5300F, 0.3200F, 0.3981F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0270F, {0.0000F, 0.0000F, 0.0000F}, 0.1860F, 0.1200F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::large_room = {1.0000F, 0.8100F, 0.3162F, 0.5623F, 0.4467F, 3.1400F, 1.5300F, 0.3200F, 0.2512F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0270F, {0.0000F, 0.0000F, 0.0000F}, 0.2140F, 0.1100F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::long_passage = {1.0000F, 0.7700F, 0.3162F, 0.5623F, 0.3981F, 3.0100F, 1.4600F, 0.2800F, 0.7943F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0250F, {0.0000F, 0.0000F, 0.0000F}, 0.1860F, 0.0400F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::hall = {1.0000F, 0.7600F, 0.3162F, 0.4467F, 0.5623F, 5.4900F, 1.5300F, 0.3800F, 0.1122F, 0.0540F, {0.0000F, 0.0000F, 0.0000F}, 0.6310F, 0.0520F, {0.0000F, 0.0000F, 0.0000F}, 0.2260F, 0.1100F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::cupboard = {1.0000F, 0.8300F, 0.3162F, 0.5012F, 0.2239F, 0.7600F, 1.5300F, 0.2600F, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.1430F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::courtyard = {1.0000F, 0.5900F, 0.3162F, 0.2818F, 0.3162F, 2.0400F, 1.2000F, 0.3800F, 0.3162F, 0.1730F, {0.0000F, 0.0000F, 0.0000F}, 0.3162F, 0.0430F, {0.0000F, 0.0000F, 0.0000F}, 0.2350F, 0.4800F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::IcePalace::alcove = {1.0000F, 0.8400F, 0.3162F, 0.5623F, 0.2818F, 2.7600F, 1.4600F, 0.2800F, 1.1220F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1610F, 0.0900F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+
+// Space station
+//
+const EffectProps::Reverb ReverbPresets::SpaceStation::small_room = {0.2109F, 0.7000F, 0.3162F, 0.7079F, 0.8913F, 1.7200F, 0.8200F, 0.5500F, 0.7943F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0130F, {0.0000F, 0.0000F, 0.0000F}, 0.1880F, 0.2600F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::SpaceStation::short_passage = {0.2109F, 0.8700F, 0.3162F, 0.6310F, 0.8913F, 3.5700F, 0.5000F, 0.5500F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.1720F, 0.2000F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::SpaceStation::medium_room = {0.2109F, 0.7500F, 0.3162F, 0.6310F, 0.8913F, 3.0100F, 0.5000F, 0.5500F, 0.3981F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0350F, {0.0000F, 0.0000F, 0.0000F}, 0.2090F, 0.3100F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::SpaceStation::large_room = {0.3645F, 0.8100F, 0.3162F, 0.6310F, 0.8913F, 3.8900F, 0.3800F, 0.6100F, 0.3162F, 0.0560F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0350F, {0.0000F, 0.0000F, 0.0000F}, 0.2330F, 0.2800F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::SpaceStation::long_passage = {0.4287F, 0.8200F, 0.3162F, 0.6310F, 0.8913F, 4.6200F, 0.6200F, 0.5500F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0310F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2300F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::SpaceStation::hall = {0.4287F, 0.8700F, 0.3162F, 0.6310F, 0.8913F, 7.1100F, 0.3800F, 0.6100F, 0.1778F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.6310F, 0.0470F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2500F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::SpaceStation::cupboard = {0.1715F, 0.5600F, 0.3162F, 0.7079F, 0.8913F, 0.7900F, 0.8100F, 0.5500F, 1.4125F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.7783F, 0.0180F, {0.0000F, 0.0000F, 0.0000F}, 0.1810F, 0.3100F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::SpaceStation::alcove = {0.2109F, 0.7800F, 0.3162F, 0.7079F, 0.8913F, 1.1600F, 0.8100F, 0.5500F, 1.4125F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0180F, {0.0000F, 0.0000F, 0.0000F}, 0.1920F, 0.2100F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+
+// Wooden galeon
+//
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::small_room = {1.0000F, 1.0000F, 0.3162F, 0.1122F, 0.3162F, 0.7900F, 0.3200F, 0.8700F, 1.0000F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::short_passage = {1.0000F, 1.0000F, 0.3162F, 0.1259F, 0.3162F, 1.7500F, 0.5000F, 0.8700F, 0.8913F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.6310F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::medium_room = {1.0000F, 1.0000F, 0.3162F, 0.1000F, 0.2818F, 1.4700F, 0.4200F, 0.8200F, 0.8913F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::large_room = {1.0000F, 1.0000F, 0.3162F, 0.0891F, 0.2818F, 2.6500F, 0.3300F, 0.8200F, 0.8913F, 0.0660F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::long_passage = {1.0000F, 1.0000F, 0.3162F, 0.1000F, 0.3162F, 1.9900F, 0.4000F, 0.7900F, 1.0000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.4467F, 0.0360F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::hall = {1.0000F, 1.0000F, 0.3162F, 0.0794F, 0.2818F, 3.4500F, 0.3000F, 0.8200F, 0.8913F, 0.0880F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0630F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::cupboard = {1.0000F, 1.0000F, 0.3162F, 0.1413F, 0.3162F, 0.5600F, 0.4600F, 0.9100F, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0280F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::courtyard = {1.0000F, 0.6500F, 0.3162F, 0.0794F, 0.3162F, 1.7900F, 0.3500F, 0.7900F, 0.5623F, 0.1230F, {0.0000F, 0.0000F, 0.0000F}, 0.1000F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::WoodenGaleon::alcove = {1.0000F, 1.0000F, 0.3162F, 0.1259F, 0.3162F, 1.2200F, 0.6200F, 0.9100F, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+
+// Sports
+//
+const EffectProps::Reverb ReverbPresets::Sports::empty_stadium = {1.0000F, 1.0000F, 0.3162F, 0.4467F, 0.7943F, 6.2600F, 0.5100F, 1.1000F, 0.0631F, 0.1830F, {0.0000F, 0.0000F, 0.0000F}, 0.3981F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Sports::squash_court = {1.0000F, 0.7500F, 0.3162F, 0.3162F, 0.7943F, 2.2200F, 0.9100F, 1.1600F, 0.4467F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1260F, 0.1900F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Sports::small_swimming_pool = {1.0000F, 0.7000F, 0.3162F, 0.7943F, 0.8913F, 2.7600F, 1.2500F, 1.1400F, 0.6310F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1790F, 0.1500F, 0.8950F, 0.1900F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Sports::large_swimming_pool = {1.0000F, 0.8200F, 0.3162F, 0.7943F, 1.0000F, 5.4900F, 1.3100F, 1.1400F, 0.4467F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 0.5012F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2220F, 0.5500F, 1.1590F, 0.2100F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Sports::gymnasium = {1.0000F, 0.8100F, 0.3162F, 0.4467F, 0.8913F, 3.1400F, 1.0600F, 1.3500F, 0.3981F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.5623F, 0.0450F, {0.0000F, 0.0000F, 0.0000F}, 0.1460F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Sports::full_stadium = {1.0000F, 1.0000F, 0.3162F, 0.0708F, 0.7943F, 5.2500F, 0.1700F, 0.8000F, 0.1000F, 0.1880F, {0.0000F, 0.0000F, 0.0000F}, 0.2818F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Sports::stadium_tannoy = {1.0000F, 0.7800F, 0.3162F, 0.5623F, 0.5012F, 2.5300F, 0.8800F, 0.6800F, 0.2818F, 0.2300F, {0.0000F, 0.0000F, 0.0000F}, 0.5012F, 0.0630F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+// Prefab
+//
+const EffectProps::Reverb ReverbPresets::Prefab::workshop = {0.4287F, 1.0000F, 0.3162F, 0.1413F, 0.3981F, 0.7600F, 1.0000F, 1.0000F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Prefab::school_room = {0.4022F, 0.6900F, 0.3162F, 0.6310F, 0.5012F, 0.9800F, 0.4500F, 0.1800F, 1.4125F, 0.0170F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.0950F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Prefab::practise_room = {0.4022F, 0.8700F, 0.3162F, 0.3981F, 0.5012F, 1.1200F, 0.5600F, 0.1800F, 1.2589F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.0950F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Prefab::outhouse = {1.0000F, 0.8200F, 0.3162F, 0.1122F, 0.1585F, 1.3800F, 0.3800F, 0.3500F, 0.8913F, 0.0240F, {0.0000F, 0.0000F, -0.0000F}, 0.6310F, 0.0440F, {0.0000F, 0.0000F, 0.0000F}, 0.1210F, 0.1700F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Prefab::caravan = {1.0000F, 1.0000F, 0.3162F, 0.0891F, 0.1259F, 0.4300F, 1.5000F, 1.0000F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+// Dome
+//
+const EffectProps::Reverb ReverbPresets::Dome::tomb = {1.0000F, 0.7900F, 0.3162F, 0.3548F, 0.2239F, 4.1800F, 0.2100F, 0.1000F, 0.3868F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 1.6788F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.1770F, 0.1900F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, false, };
+const EffectProps::Reverb ReverbPresets::Dome::saint_pauls = {1.0000F, 0.8700F, 0.3162F, 0.3548F, 0.2239F, 10.4800F, 0.1900F, 0.1000F, 0.1778F, 0.0900F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0420F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.1200F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, true, };
+
+// Pipe
+//
+const EffectProps::Reverb ReverbPresets::Pipe::small = {1.0000F, 1.0000F, 0.3162F, 0.3548F, 0.2239F, 5.0400F, 0.1000F, 0.1000F, 0.5012F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 2.5119F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Pipe::long_thin = {0.2560F, 0.9100F, 0.3162F, 0.4467F, 0.2818F, 9.2100F, 0.1800F, 0.1000F, 0.7079F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Pipe::large = {1.0000F, 1.0000F, 0.3162F, 0.3548F, 0.2239F, 8.4500F, 0.1000F, 0.1000F, 0.3981F, 0.0460F, {0.0000F, 0.0000F, 0.0000F}, 1.5849F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Pipe::resonant = {0.1373F, 0.9100F, 0.3162F, 0.4467F, 0.2818F, 6.8100F, 0.1800F, 0.1000F, 0.7079F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, false, };
+
+// Outdoors
+//
+const EffectProps::Reverb ReverbPresets::Outdoors::backyard = {1.0000F, 0.4500F, 0.3162F, 0.2512F, 0.5012F, 1.1200F, 0.3400F, 0.4600F, 0.4467F, 0.0690F, {0.0000F, 0.0000F, -0.0000F}, 0.7079F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.2180F, 0.3400F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Outdoors::rolling_plains = {1.0000F, 0.0000F, 0.3162F, 0.0112F, 0.6310F, 2.1300F, 0.2100F, 0.4600F, 0.1778F, 0.3000F, {0.0000F, 0.0000F, -0.0000F}, 0.4467F, 0.0190F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Outdoors::deep_canyon = {1.0000F, 0.7400F, 0.3162F, 0.1778F, 0.6310F, 3.8900F, 0.2100F, 0.4600F, 0.3162F, 0.2230F, {0.0000F, 0.0000F, -0.0000F}, 0.3548F, 0.0190F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Outdoors::creek = {1.0000F, 0.3500F, 0.3162F, 0.1778F, 0.5012F, 2.1300F, 0.2100F, 0.4600F, 0.3981F, 0.1150F, {0.0000F, 0.0000F, -0.0000F}, 0.1995F, 0.0310F, {0.0000F, 0.0000F, 0.0000F}, 0.2180F, 0.3400F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Outdoors::valley = {1.0000F, 0.2800F, 0.3162F, 0.0282F, 0.1585F, 2.8800F, 0.2600F, 0.3500F, 0.1413F, 0.2630F, {0.0000F, 0.0000F, -0.0000F}, 0.3981F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.3400F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+
+// Mood
+//
+const EffectProps::Reverb ReverbPresets::Mood::heaven = {1.0000F, 0.9400F, 0.3162F, 0.7943F, 0.4467F, 5.0400F, 1.1200F, 0.5600F, 0.2427F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0800F, 2.7420F, 0.0500F, 0.9977F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Mood::hell = {1.0000F, 0.5700F, 0.3162F, 0.3548F, 0.4467F, 3.5700F, 0.4900F, 2.0000F, 0.0000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1100F, 0.0400F, 2.1090F, 0.5200F, 0.9943F, 5000.0000F, 139.5000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Mood::memory = {1.0000F, 0.8500F, 0.3162F, 0.6310F, 0.3548F, 4.0600F, 0.8200F, 0.5600F, 0.0398F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.4740F, 0.4500F, 0.9886F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+// Driving
+//
+const EffectProps::Reverb ReverbPresets::Driving::commentator = {1.0000F, 0.0000F, 0.3162F, 0.5623F, 0.5012F, 2.4200F, 0.8800F, 0.6800F, 0.1995F, 0.0930F, {0.0000F, 0.0000F, 0.0000F}, 0.2512F, 0.0170F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9886F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Driving::pit_garage = {0.4287F, 0.5900F, 0.3162F, 0.7079F, 0.5623F, 1.7200F, 0.9300F, 0.8700F, 0.5623F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.1100F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Driving::incar_racer = {0.0832F, 0.8000F, 0.3162F, 1.0000F, 0.7943F, 0.1700F, 2.0000F, 0.4100F, 1.7783F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10268.2002F, 251.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Driving::incar_sports = {0.0832F, 0.8000F, 0.3162F, 0.6310F, 1.0000F, 0.1700F, 0.7500F, 0.4100F, 1.0000F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.5623F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10268.2002F, 251.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Driving::incar_luxury = {0.2560F, 1.0000F, 0.3162F, 0.1000F, 0.5012F, 0.1300F, 0.4100F, 0.4600F, 0.7943F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.5849F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10268.2002F, 251.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Driving::full_grand_stand = {1.0000F, 1.0000F, 0.3162F, 0.2818F, 0.6310F, 3.0100F, 1.3700F, 1.2800F, 0.3548F, 0.0900F, {0.0000F, 0.0000F, 0.0000F}, 0.1778F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10420.2002F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Driving::empty_grand_stand = {1.0000F, 1.0000F, 0.3162F, 1.0000F, 0.7943F, 4.6200F, 1.7500F, 1.4000F, 0.2082F, 0.0900F, {0.0000F, 0.0000F, 0.0000F}, 0.2512F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10420.2002F, 250.0000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::Driving::tunnel = {1.0000F, 0.8100F, 0.3162F, 0.3981F, 0.8913F, 3.4200F, 0.9400F, 1.3100F, 0.7079F, 0.0510F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0470F, {0.0000F, 0.0000F, 0.0000F}, 0.2140F, 0.0500F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 155.3000F, 0.0000F, true, };
+
+// City
+//
+const EffectProps::Reverb ReverbPresets::City::streets = {1.0000F, 0.7800F, 0.3162F, 0.7079F, 0.8913F, 1.7900F, 1.1200F, 0.9100F, 0.2818F, 0.0460F, {0.0000F, 0.0000F, 0.0000F}, 0.1995F, 0.0280F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::City::subway = {1.0000F, 0.7400F, 0.3162F, 0.7079F, 0.8913F, 3.0100F, 1.2300F, 0.9100F, 0.7079F, 0.0460F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0280F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 0.2100F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::City::museum = {1.0000F, 0.8200F, 0.3162F, 0.1778F, 0.1778F, 3.2800F, 1.4000F, 0.5700F, 0.2512F, 0.0390F, {0.0000F, 0.0000F, -0.0000F}, 0.8913F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 0.1300F, 0.1700F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::City::library = {1.0000F, 0.8200F, 0.3162F, 0.2818F, 0.0891F, 2.7600F, 0.8900F, 0.4100F, 0.3548F, 0.0290F, {0.0000F, 0.0000F, -0.0000F}, 0.8913F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.1300F, 0.1700F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+
+const EffectProps::Reverb ReverbPresets::City::underpass = {1.0000F, 0.8200F, 0.3162F, 0.4467F, 0.8913F, 3.5700F, 1.1200F, 0.9100F, 0.3981F, 0.0590F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0370F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.1400F, 0.2500F, 0.0000F, 0.9920F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::City::abandoned = {1.0000F, 0.6900F, 0.3162F, 0.7943F, 0.8913F, 3.2800F, 1.1700F, 0.9100F, 0.4467F, 0.0440F, {0.0000F, 0.0000F, 0.0000F}, 0.2818F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2000F, 0.2500F, 0.0000F, 0.9966F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+// Misc
+//
+const EffectProps::Reverb ReverbPresets::Misc::dusty_room = {0.3645F, 0.5600F, 0.3162F, 0.7943F, 0.7079F, 1.7900F, 0.3800F, 0.2100F, 0.5012F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0060F, {0.0000F, 0.0000F, 0.0000F}, 0.2020F, 0.0500F, 0.2500F, 0.0000F, 0.9886F, 13046.0000F, 163.3000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Misc::chapel = {1.0000F, 0.8400F, 0.3162F, 0.5623F, 1.0000F, 4.6200F, 0.6400F, 1.2300F, 0.4467F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.1100F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+
+const EffectProps::Reverb ReverbPresets::Misc::small_water_room = {1.0000F, 0.7000F, 0.3162F, 0.4477F, 1.0000F, 1.5100F, 1.2500F, 1.1400F, 0.8913F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1790F, 0.1500F, 0.8950F, 0.1900F, 0.9920F, 5000.0000F, 250.0000F, 0.0000F, false, };
+
+// Reverb presets
+// ==========================================================================
+
+
+class EffectState
+{
+public:
+	EffectState(
+		const EffectState& that) = delete;
+
+	EffectState& operator=(
+		const EffectState& that) = delete;
+
+	virtual ~EffectState()
+	{
+	}
+
+
+	// The tail of the effects which never decay (i.e. a feedback gain of one or more).
+	static constexpr auto infinite_tail_sample_count = std::numeric_limits<int>::max();
+
+
+	SampleBuffers* dst_buffers_;
+	int dst_channel_count_;
+
+	// The memory of the state (set by the factory).
+	Arena* arena_;
+	std::size_t object_size_;
+
+
+	void construct()
+	{
+		do_construct();
+	}
+
+	void destruct()
+	{
+		do_destruct();
+	}
+
+	void update_device(
+		Device& device)
+	{
+		do_update_device(device);
+	}
+
+	void update(
+		Device& device,
+		const EffectSlot& effect_slot,
+		const EffectProps& props)
+	{
+		do_update(device, effect_slot, props);
+	}
+
+	void process(
+		int sample_count,
+		const SampleBuffers& src_samples,
+		SampleBuffers& dst_samples,
+		const int channel_count)
+	{
+		do_process(sample_count, src_samples, dst_samples, channel_count);
+	}
+
+	// Gets a number of samples the output needs to decay below
+	// the silence threshold after the input went silent.
+	int get_tail_sample_count() const
+	{
+		return do_get_tail_sample_count();
+	}
+
+	static void destroy(
+		EffectState*& effect_state)
+	{
+		if (!effect_state)
+		{
+			return;
+		}
+
+		effect_state->destruct();
+
+		const auto arena = effect_state->arena_;
+		const auto object_size = effect_state->object_size_;
+
+		effect_state->~EffectState();
+		Arena::deallocate(arena, effect_state, object_size, Arena::alignment);
+
+		effect_state = nullptr;
+	}
+
+
+protected:
+	EffectState()
+		:
+		dst_buffers_{},
+		dst_channel_count_{},
+		arena_{},
+		object_size_{}
+	{
+	}
+
+
+	virtual void do_construct() = 0;
+
+	virtual void do_destruct() = 0;
+
+	virtual void do_update_device(
+		Device& device) = 0;
+
+	virtual void do_update(
+		Device& device,
+		const EffectSlot& effect_slot,
+		const EffectProps& props) = 0;
+
+	virtual void do_process(
+		const int sample_count,
+		const SampleBuffers& src_samples,
+		SampleBuffers& dst_samples,
+		const int channel_count) = 0;
+
+	virtual int do_get_tail_sample_count() const = 0;
+
+
+	// The tail of the effects without a feedback loop (i.e. filters only).
+	static constexpr auto filter_tail_time = 0.1F;
+
+
+	// Calculates a tail of the effect which consists of filters only.
+	static int calc_filter_tail_sample_count(
+		const int sampling_rate)
+	{
+		return static_cast<int>(filter_tail_time * sampling_rate);
+	}
+
+	// Calculates a tail of the feedback loop.
+	//
+	// "period" is a loop length in samples, and "feedback" is a loop gain.
+	static int calc_feedback_tail_sample_count(
+		const int period,
+		const float feedback)
+	{
+		const auto gain = std::abs(feedback);
+
+		if (!(gain < 1.0F))
+		{
+			return infinite_tail_sample_count;
+		}
+
+		if (!(gain > silence_threshold_gain))
+		{
+			return period;
+		}
+
+		const auto cycle_count = std::ceil(std::log(silence_threshold_gain) / std::log(gain));
+		const auto sample_count = (static_cast<double>(cycle_count) + 1.0) * period;
+
+		if (sample_count >= infinite_tail_sample_count)
+		{
+			return infinite_tail_sample_count;
+		}
+
+		return static_cast<int>(sample_count);
+	}
+}; // EffectState
+
+
+constexpr int EffectState::infinite_tail_sample_count;
+constexpr float EffectState::filter_tail_time;
+
+
+class EffectStateFactory
+{
+public:
+	static EffectState* create_by_type(
+		const EffectType type)
+	{
+		switch (type)
+		{
+		case EffectType::null:
+			return create_null();
+
+		case EffectType::chorus:
+			return create_chorus();
+
+		case EffectType::compressor:
+			return create_compressor();
+
+		case EffectType::dedicated_dialog:
+		case EffectType::dedicated_low_frequency:
+			return create_dedicated();
+
+		case EffectType::distortion:
+			return create_distortion();
+
+		case EffectType::echo:
+			return create_echo();
+
+		case EffectType::equalizer:
+			return create_equalizer();
+
+		case EffectType::flanger:
+			return create_flanger();
+
+		case EffectType::eax_reverb:
+		case EffectType::reverb:
+			return create_reverb();
+
+		case EffectType::ring_modulator:
+			return create_ring_modulator();
+
+		default:
+			return nullptr;
+		}
+	}
+
+	// Gets a class name of the effect type's state.
+	static const char* get_name_by_type(
+		const EffectType type)
+	{
+		switch (type)
+		{
+		case EffectType::null:
+			return "NullEffectState";
+
+		case EffectType::chorus:
+			return "ChorusEffectState";
+
+		case EffectType::compressor:
+			return "CompressorEffectState";
+
+		case EffectType::dedicated_dialog:
+		case EffectType::dedicated_low_frequency:
+			return "DedicatedEffectState";
+
+		case EffectType::distortion:
+			return "DistortionEffectState";
+
+		case EffectType::echo:
+			return "EchoEffectState";
+
+		case EffectType::equalizer:
+			return "EqualizerEffectState";
+
+		case EffectType::flanger:
+			return "FlangerEffectState";
+
+		case EffectType::eax_reverb:
+		case EffectType::reverb:
+			return "ReverbEffectState";
+
+		case EffectType::ring_modulator:
+			return "RingModulatorEffectState";
+
+		default:
+			return nullptr;
+		}
+	}
+
+
+private:
+	static EffectState* create_null();
+	static EffectState* create_chorus();
+	static EffectState* create_compressor();
+	static EffectState* create_dedicated();
+	static EffectState* create_distortion();
+	static EffectState* create_echo();
+	static EffectState* create_equalizer();
+	static EffectState* create_flanger();
+	static EffectState* create_reverb();
+	static EffectState* create_ring_modulator();
+
+
+	// Creates the state in the current arena.
+	template<typename T>
+	static EffectState* create()
+	{
+		static_assert(alignof(T) <= Arena::alignment, "Unsupported alignment.");
+
+		const auto arena = Arena::get_current();
+		const auto memory = Arena::allocate(arena, sizeof(T), Arena::alignment);
+
+		if (!memory)
+		{
+			return nullptr;
+		}
+
+		auto result = static_cast<EffectState*>(new (memory) T{});
+
+		result->arena_ = arena;
+		result->object_size_ = sizeof(T);
+		result->construct();
+
+		return result;
+	}
+}; // EffectStateFactory
+
+struct EffectStateDeleter
+{
+	void operator()(
+		EffectState* effect_state)
+	{
+		EffectState::destroy(effect_state);
+	}
+}; // EffectStateDeleter
+
+struct Device
+{
+	using ChannelIds = std::array<ChannelId, max_channels>;
+
+
+	int sampling_rate_;
+	int channel_count_;
+	int block_size_;
+	int distortion_oversampling_factor_;
+	ChannelFormat channel_format_;
+	ChannelIds channel_ids_;
+	SampleBuffers sample_buffers_;
+
+	// Temp storage used for each source when mixing (one buffer per channel).
+	SampleBuffers resampled_data_;
+	SampleBuffers filtered_data_;
+
+	// The "dry" path corresponds to the main output.
+	AmbiOutput dry_;
+
+	// First-order ambisonics output, to be upsampled to the dry buffer if different.
+	AmbiOutput foa_;
+
+
+	void initialize(
+		const ChannelFormat channel_format,
+		const int sampling_rate,
+		const int block_size,
+		const int distortion_oversampling_factor)
+	{
+		channel_count_ = channel_format_to_channel_count(channel_format);
+
+		// Set output format
+		channel_format_ = channel_format;
+		sampling_rate_ = sampling_rate;
+		block_size_ = block_size;
+		distortion_oversampling_factor_ = distortion_oversampling_factor;
+
+		alu_init_renderer();
+
+		sample_buffers_.clear();
+		sample_buffers_.resize(channel_count_, SampleBuffer(block_size_));
+
+		resampled_data_.clear();
+		resampled_data_.resize(channel_count_, SampleBuffer(block_size_));
+
+		filtered_data_.clear();
+		filtered_data_.resize(channel_count_, SampleBuffer(block_size_));
+	}
+
+	void uninitialize()
+	{
+		sample_buffers_ = SampleBuffers{};
+		resampled_data_ = SampleBuffers{};
+		filtered_data_ = SampleBuffers{};
+	}
+
+	void set_default_wfx_channel_order()
+	{
+		channel_ids_.fill(ChannelId::none);
+
+		switch (channel_format_)
+		{
+		case ChannelFormat::mono:
+			channel_ids_[0] = ChannelId::front_center;
+			break;
+
+		case ChannelFormat::stereo:
+			channel_ids_[0] = ChannelId::front_left;
+			channel_ids_[1] = ChannelId::front_right;
+			break;
+
+		case ChannelFormat::quad:
+			channel_ids_[0] = ChannelId::front_left;
+			channel_ids_[1] = ChannelId::front_right;
+			channel_ids_[2] = ChannelId::back_left;
+			channel_ids_[3] = ChannelId::back_right;
+			break;
+
+		case ChannelFormat::five_point_one:
+			channel_ids_[0] = ChannelId::front_left;
+			channel_ids_[1] = ChannelId::front_right;
+			channel_ids_[2] = ChannelId::front_center;
+			channel_ids_[3] = ChannelId::lfe;
+			channel_ids_[4] = ChannelId::side_left;
+			channel_ids_[5] = ChannelId::side_right;
+			break;
+
+		case ChannelFormat::five_point_one_rear:
+			channel_ids_[0] = ChannelId::front_left;
+			channel_ids_[1] = ChannelId::front_right;
+			channel_ids_[2] = ChannelId::front_center;
+			channel_ids_[3] = ChannelId::lfe;
+			channel_ids_[4] = ChannelId::back_left;
+			channel_ids_[5] = ChannelId::back_right;
+			break;
+
+		case ChannelFormat::six_point_one:
+			channel_ids_[0] = ChannelId::front_left;
+			channel_ids_[1] = ChannelId::front_right;
+			channel_ids_[2] = ChannelId::front_center;
+			channel_ids_[3] = ChannelId::lfe;
+			channel_ids_[4] = ChannelId::back_center;
+			channel_ids_[5] = ChannelId::side_left;
+			channel_ids_[6] = ChannelId::side_right;
+			break;
+
+		case ChannelFormat::seven_point_one:
+			channel_ids_[0] = ChannelId::front_left;
+			channel_ids_[1] = ChannelId::front_right;
+			channel_ids_[2] = ChannelId::front_center;
+			channel_ids_[3] = ChannelId::lfe;
+			channel_ids_[4] = ChannelId::back_left;
+			channel_ids_[5] = ChannelId::back_right;
+			channel_ids_[6] = ChannelId::side_left;
+			channel_ids_[7] = ChannelId::side_right;
+			break;
+
+		case ChannelFormat::none:
+		default:
+			break;
+		}
+	}
+
+	void alu_init_renderer()
+	{
+		dry_.ambi_.reset();
+		dry_.coeff_count_ = 0;
+		set_default_wfx_channel_order();
+
+		const ChannelPanning *channel_map = nullptr;
+		auto coeff_count = 0;
+		auto count = 0;
+
+		switch (channel_format_)
+		{
+		case ChannelFormat::mono:
+			count = get_array_extents(Panning::mono_panning);
+			channel_map = Panning::mono_panning;
+			coeff_count = 1;
+			break;
+
+		case ChannelFormat::stereo:
+			count = get_array_extents(Panning::stereo_panning);
+			channel_map = Panning::stereo_panning;
+			coeff_count = 4;
+			break;
+
+		case ChannelFormat::quad:
+			count = get_array_extents(Panning::quad_panning);
+			channel_map = Panning::quad_panning;
+			coeff_count = 4;
+			break;
+
+		case ChannelFormat::five_point_one:
+			count = get_array_extents(Panning::x5_1_side_panning);
+			channel_map = Panning::x5_1_side_panning;
+			coeff_count = 9;
+			break;
+
+		case ChannelFormat::five_point_one_rear:
+			count = get_array_extents(Panning::x5_1_rear_panning);
+			channel_map = Panning::x5_1_rear_panning;
+			coeff_count = 9;
+			break;
+
+		case ChannelFormat::six_point_one:
+			count = get_array_extents(Panning::x6_1_panning);
+			channel_map = Panning::x6_1_panning;
+			coeff_count = 9;
+			break;
+
+		case ChannelFormat::seven_point_one:
+			count = get_array_extents(Panning::x7_1_panning);
+			channel_map = Panning::x7_1_panning;
+			coeff_count = 16;
+			break;
+
+		case ChannelFormat::none:
+		default:
+			break;
+		}
+
+		Panning::set_channel_map(
+			channel_ids_.data(),
+			dry_.ambi_.coeffs_.data(),
+			channel_map,
+			count,
+			&channel_count_);
+
+		dry_.coeff_count_ = coeff_count;
+
+		foa_.ambi_.reset();
+
+		for (int i = 0; i < channel_count_; ++i)
+		{
+			foa_.ambi_.coeffs_[i][0] = dry_.ambi_.coeffs_[i][0];
+
+			for (int j = 1; j < 4; ++j)
+			{
+				foa_.ambi_.coeffs_[i][j] = dry_.ambi_.coeffs_[i][j];
+			}
+		}
+
+		foa_.coeff_count_ = 4;
+	}
+
+	// Returns the index for the given channel name (e.g. FrontCenter), or -1 if it
+	// doesn't exist.
+	int get_channel_index(
+		const ChannelId channel_id_to_find)
+	{
+		const auto it_begin = channel_ids_.cbegin();
+		const auto it_end = channel_ids_.cbegin();
+
+		const auto it = std::find_if(
+			it_begin,
+			it_end,
+			[=](const ChannelId channel_id)
+			{
+				return channel_id == channel_id_to_find;
+			}
+		);
+
+		if (it == it_end)
+		{
+			return -1;
+		}
+
+		return static_cast<int>(it - it_begin);
+	}
+
+	static int channel_format_to_channel_count(
+		const ChannelFormat channel_format)
+	{
+		switch (channel_format)
+		{
+		case ChannelFormat::mono:
+			return 1;
+
+		case ChannelFormat::stereo:
+			return 2;
+
+		case ChannelFormat::quad:
+			return 4;
+
+		case ChannelFormat::five_point_one:
+		case ChannelFormat::five_point_one_rear:
+			return 6;
+
+		case ChannelFormat::six_point_one:
+			return 7;
+
+		case ChannelFormat::seven_point_one:
+			return 8;
+
+		default:
+			return 0;
+		}
+	}
+}; // Device
+
+struct EffectSlot
+{
+	// A number of the effect state classes.
+	static constexpr auto effect_state_kind_count = 10;
+
+
+	using EffectStateUPtr = std::unique_ptr<EffectState, EffectStateDeleter>;
+	using EffectStates = std::array<EffectStateUPtr, effect_state_kind_count>;
+
+
+	Effect effect_;
+	EffectState* effect_state_;
+	bool is_props_changed_;
+
+	// Set if the slot is muted and not processed.
+	bool is_suspended_;
+
+	// Set if the slot has a routed send in the current block.
+	bool is_fed_;
+
+	// Set if the slot should be cleared and processed in the current block.
+	bool is_active_;
+
+	// The effect's tail, and the part of it yet to be processed.
+	// The slot sleeps when there is no input and no remaining tail.
+	int tail_sample_count_;
+	int remaining_tail_sample_count_;
+
+	// Wet buffer configuration is ACN channel order with N3D scaling:
+	// * Channel 0 is the unattenuated mono signal.
+	// * Channel 1 is OpenAL -X
+	// * Channel 2 is OpenAL Y
+	// * Channel 3 is OpenAL -Z
+	// Consequently, effects that only want to work with mono input can use
+	// channel 0 by itself. Effects that want multichannel can process the
+	// ambisonics signal and make a B-Format pan (ComputeFirstOrderGains) for
+	// first-order device output (FOAOut).
+	SampleBuffers wet_buffer_;
+
+	// Private accumulation buffer of the effect's output
+	// when the slot is processed on a worker thread.
+	SampleBuffers output_buffer_;
+
+	// The owned effect states by the kind (see "get_effect_state_kind").
+	// Without the pooling only the state of the current effect is created.
+	EffectStates effect_states_;
+	bool are_effect_states_pooled_;
+
+
+	EffectSlot()
+		:
+		effect_{},
+		effect_state_{},
+		is_props_changed_{},
+		is_suspended_{},
+		is_fed_{},
+		is_active_{},
+		tail_sample_count_{},
+		remaining_tail_sample_count_{},
+		wet_buffer_{SampleBuffers::size_type{max_effect_channels}},
+		output_buffer_{},
+		effect_states_{},
+		are_effect_states_pooled_{}
+	{
+	}
+
+	EffectSlot(
+		const EffectSlot& that) = delete;
+
+	EffectSlot(
+		EffectSlot&& that) = default;
+
+	EffectSlot& operator=(
+		const EffectSlot& that) = delete;
+
+	EffectSlot& operator=(
+		EffectSlot&& that) = default;
+
+	~EffectSlot()
+	{
+		uninitialize();
+	}
+
+	// Returns true on success or false otherwise.
+	bool initialize(
+		Device& device,
+		const bool are_effect_states_pooled)
+	{
+		uninitialize();
+
+		for (auto& buffer : wet_buffer_)
+		{
+			buffer.assign(device.block_size_, 0.0F);
+		}
+
+		are_effect_states_pooled_ = are_effect_states_pooled;
+
+		if (are_effect_states_pooled_)
+		{
+			for (int i = 0; i < effect_state_kind_count; ++i)
+			{
+				auto& effect_state = effect_states_[i];
+				effect_state.reset(EffectStateFactory::create_by_type(effect_state_kinds[i]));
+
+				if (!effect_state)
+				{
+					return false;
+				}
+
+				attach_effect_state(device, *effect_state);
+			}
+		}
+		else
+		{
+			auto& effect_state = effect_states_[get_effect_state_kind(EffectType::null)];
+			effect_state.reset(EffectStateFactory::create_by_type(EffectType::null));
+
+			if (!effect_state)
+			{
+				return false;
+			}
+
+			attach_effect_state(device, *effect_state);
+		}
+
+		effect_.type_ = EffectType::null;
+		effect_state_ = effect_states_[get_effect_state_kind(EffectType::null)].get();
+		is_props_changed_ = true;
+		is_suspended_ = false;
+		is_fed_ = false;
+		is_active_ = false;
+		tail_sample_count_ = 0;
+		remaining_tail_sample_count_ = 0;
+
+		return true;
+	}
+
+	void uninitialize()
+	{
+		effect_state_ = nullptr;
+
+		for (auto& effect_state : effect_states_)
+		{
+			effect_state.reset(nullptr);
+		}
+	}
+
+	// Sets the effect.
+	//
+	// Note: Without the pooling, the state of a new effect type should be
+	// replaced by "replace_effect_state" beforehand.
+	void set_effect(
+		Device& device,
+		const Effect& effect)
+	{
+		RtScope rt_scope{"EffectSlot::set_effect", EffectStateFactory::get_name_by_type(effect.type_)};
+
+		if (effect_.type_ != effect.type_)
+		{
+			auto& effect_state = effect_states_[get_effect_state_kind(effect.type_)];
+
+			// Recycle the state.
+			effect_state->construct();
+
+			attach_effect_state(device, *effect_state);
+
+			effect_state_ = effect_state.get();
+			effect_.type_ = effect.type_;
+
+			remaining_tail_sample_count_ = 0;
+		}
+
+		effect_.props_ = effect.props_;
+		is_props_changed_ = true;
+	}
+
+	// Replaces the state of the current effect with the one of the new effect type.
+	//
+	// Used without the pooling.
+	//
+	// Returns the replaced state.
+	EffectState* replace_effect_state(
+		const EffectType effect_type,
+		EffectState* const effect_state)
+	{
+		const auto result = effect_states_[get_effect_state_kind(effect_.type_)].release();
+
+		effect_states_[get_effect_state_kind(effect_type)].reset(effect_state);
+
+		effect_state_ = effect_state;
+		effect_.type_ = effect_type;
+		is_props_changed_ = true;
+
+		remaining_tail_sample_count_ = 0;
+
+		return result;
+	}
+
+	// Creates the state of the effect type in the current arena
+	// for "replace_effect_state".
+	//
+	// Returns the state or null on error.
+	static EffectState* create_effect_state(
+		Device& device,
+		const EffectType effect_type)
+	{
+		RtScope rt_scope{"EffectSlot::create_effect_state", EffectStateFactory::get_name_by_type(effect_type)};
+
+		const auto result = EffectStateFactory::create_by_type(effect_type);
+
+		if (result)
+		{
+			attach_effect_state(device, *result);
+		}
+
+		return result;
+	}
+
+
+private:
+	// Effect types by the kind.
+	static constexpr EffectType effect_state_kinds[effect_state_kind_count] =
+	{
+		EffectType::null,
+		EffectType::chorus,
+		EffectType::compressor,
+		EffectType::dedicated_dialog,
+		EffectType::distortion,
+		EffectType::echo,
+		EffectType::equalizer,
+		EffectType::flanger,
+		EffectType::ring_modulator,
+		EffectType::reverb,
+	};
+
+
+	// Gets a kind of the effect state (i.e. the effect types sharing the same state class).
+	static int get_effect_state_kind(
+		const EffectType effect_type)
+	{
+		switch (effect_type)
+		{
+		case EffectType::dedicated_low_frequency:
+			return get_effect_state_kind(EffectType::dedicated_dialog);
+
+		case EffectType::eax_reverb:
+			return get_effect_state_kind(EffectType::reverb);
+
+		default:
+			return static_cast<int>(std::find(
+				std::begin(effect_state_kinds),
+				std::end(effect_state_kinds),
+				effect_type) - std::begin(effect_state_kinds));
+		}
+	}
+
+	static void attach_effect_state(
+		Device& device,
+		EffectState& effect_state)
+	{
+		effect_state.dst_buffers_ = &device.sample_buffers_;
+		effect_state.dst_channel_count_ = device.channel_count_;
+		effect_state.update_device(device);
+	}
+}; // EffectSlot
+
+constexpr int EffectSlot::effect_state_kind_count;
+constexpr EffectType EffectSlot::effect_state_kinds[effect_state_kind_count];
+
+struct EffectContext
+{
+	// The applied effect with a number of the states created for the effect types so far.
+	struct AppliedEffect
+	{
+		Effect effect_;
+		int effect_state_count_;
+	}; // AppliedEffect
+
+	using EffectStateQueue = SpscQueue<EffectState*>;
+
+
+	// Used by the control.
+	Effect deferred_effect_;
+	Effect applied_effect_;
+
+	// A number of the created states, and of the ones not destroyed yet.
+	int created_effect_state_count_;
+	int live_effect_state_count_;
+
+	// The applied effect on the way from the control to the mixing.
+	TripleBuffer<AppliedEffect> effect_handoff_;
+
+	// Without the pooling, the states of the new effect types are created by the control,
+	// and the replaced ones are returned to it to destroy, so the mixing doesn't allocate memory.
+	EffectStateQueue created_effect_states_;
+	EffectStateQueue retired_effect_states_;
+
+	// The suspension flag on the way from the control to the mixing.
+	std::atomic<bool> is_suspended_;
+
+	// Used by the mixing.
+	EffectSlot effect_slot_;
+	int taken_effect_state_count_;
+
+
+	~EffectContext()
+	{
+		destroy_effect_states(created_effect_states_);
+		destroy_effect_states(retired_effect_states_);
+	}
+
+	// Destroys the states in the queue.
+	static void destroy_effect_states(
+		EffectStateQueue& effect_states)
+	{
+		auto effect_state = static_cast<EffectState*>(nullptr);
+
+		while (effect_states.pop(effect_state))
+		{
+			EffectState::destroy(effect_state);
+		}
+	}
+}; // EffectContext
+
+using EffectContexts = ArenaVector<EffectContext>;
+
+// A change of the properties scheduled at the sample offset.
+struct ScheduledEvent
+{
+	enum class Type
+	{
+		effect_props,
+		send_props,
+	}; // Type
+
+
+	Type type_;
+	int sample_offset_;
+	int source_index_;
+	int effect_index_;
+	Effect effect_;
+	SendProps send_props_;
+}; // ScheduledEvent
+
+using ScheduledEvents = ArenaVector<ScheduledEvent>;
+using EffectSlotPtrs = ArenaVector<EffectSlot*>;
+
+
+// Mixing kernels.
+//
+// Note: A ramped gain is evaluated per sample as "gain + (step * index)",
+// so all kernels ramp the same way regardless of a vector width.
+struct MixKernels
+{
+	// Adds the source samples scaled by the gain to the target ones.
+	using MulAddFunc = void (*)(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count);
+
+	// Adds the source samples scaled by the linearly changing gain to the target ones.
+	using MulAddRampFunc = void (*)(
+		const float* const src_samples,
+		const float gain,
+		const float step,
+		float* const dst_samples,
+		const int sample_count);
+
+	// Stores the source samples scaled by the gain into the target ones.
+	using MulFunc = void (*)(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count);
+
+	// Adds the source samples to the target ones.
+	using AddFunc = void (*)(
+		const float* const src_samples,
+		float* const dst_samples,
+		const int sample_count);
+
+
+	MulAddFunc mul_add_;
+	MulAddRampFunc mul_add_ramp_;
+	MulFunc mul_;
+	AddFunc add_;
+}; // MixKernels
+
+
+struct ScalarMixKernels
+{
+	static void mul_add(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		for (int i = 0; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i] * gain;
+		}
+	}
+
+	static void mul_add_ramp(
+		const float* const src_samples,
+		const float gain,
+		const float step,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		for (int i = 0; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i] * (gain + (step * static_cast<float>(i)));
+		}
+	}
+
+	static void mul(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		for (int i = 0; i < sample_count; ++i)
+		{
+			dst_samples[i] = src_samples[i] * gain;
+		}
+	}
+
+	static void add(
+		const float* const src_samples,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		for (int i = 0; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i];
+		}
+	}
+}; // ScalarMixKernels
+
+
+#ifdef OALSFXPP_X86_SIMD
+
+struct Sse2MixKernels
+{
+	OALSFXPP_TARGET("sse2")
+	static void mul_add(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm_set1_ps(gain);
+
+		auto i = 0;
+
+		for (; (i + 4) <= sample_count; i += 4)
+		{
+			const auto src = _mm_loadu_ps(src_samples + i);
+			const auto dst = _mm_loadu_ps(dst_samples + i);
+
+			_mm_storeu_ps(dst_samples + i, _mm_add_ps(dst, _mm_mul_ps(src, gains)));
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i] * gain;
+		}
+	}
+
+	OALSFXPP_TARGET("sse2")
+	static void mul_add_ramp(
+		const float* const src_samples,
+		const float gain,
+		const float step,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm_set1_ps(gain);
+		const auto steps = _mm_set1_ps(step);
+		const auto index_step = _mm_set1_ps(4.0F);
+
+		auto indices = _mm_setr_ps(0.0F, 1.0F, 2.0F, 3.0F);
+
+		auto i = 0;
+
+		for (; (i + 4) <= sample_count; i += 4)
+		{
+			const auto src = _mm_loadu_ps(src_samples + i);
+			const auto dst = _mm_loadu_ps(dst_samples + i);
+			const auto ramp = _mm_add_ps(gains, _mm_mul_ps(steps, indices));
+
+			_mm_storeu_ps(dst_samples + i, _mm_add_ps(dst, _mm_mul_ps(src, ramp)));
+
+			indices = _mm_add_ps(indices, index_step);
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i] * (gain + (step * static_cast<float>(i)));
+		}
+	}
+
+	OALSFXPP_TARGET("sse2")
+	static void mul(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm_set1_ps(gain);
+
+		auto i = 0;
+
+		for (; (i + 4) <= sample_count; i += 4)
+		{
+			_mm_storeu_ps(dst_samples + i, _mm_mul_ps(_mm_loadu_ps(src_samples + i), gains));
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] = src_samples[i] * gain;
+		}
+	}
+
+	OALSFXPP_TARGET("sse2")
+	static void add(
+		const float* const src_samples,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		auto i = 0;
+
+		for (; (i + 4) <= sample_count; i += 4)
+		{
+			_mm_storeu_ps(dst_samples + i, _mm_add_ps(_mm_loadu_ps(dst_samples + i), _mm_loadu_ps(src_samples + i)));
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i];
+		}
+	}
+}; // Sse2MixKernels
+
+
+struct Avx2MixKernels
+{
+	OALSFXPP_TARGET("avx2,fma")
+	static void mul_add(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm256_set1_ps(gain);
+
+		auto i = 0;
+
+		for (; (i + 8) <= sample_count; i += 8)
+		{
+			const auto src = _mm256_loadu_ps(src_samples + i);
+			const auto dst = _mm256_loadu_ps(dst_samples + i);
+
+			_mm256_storeu_ps(dst_samples + i, _mm256_fmadd_ps(src, gains, dst));
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i] * gain;
+		}
+	}
+
+	OALSFXPP_TARGET("avx2,fma")
+	static void mul_add_ramp(
+		const float* const src_samples,
+		const float gain,
+		const float step,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm256_set1_ps(gain);
+		const auto steps = _mm256_set1_ps(step);
+		const auto index_step = _mm256_set1_ps(8.0F);
+
+		auto indices = _mm256_setr_ps(0.0F, 1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F);
+
+		auto i = 0;
+
+		for (; (i + 8) <= sample_count; i += 8)
+		{
+			const auto src = _mm256_loadu_ps(src_samples + i);
+			const auto dst = _mm256_loadu_ps(dst_samples + i);
+			const auto ramp = _mm256_fmadd_ps(steps, indices, gains);
+
+			_mm256_storeu_ps(dst_samples + i, _mm256_fmadd_ps(src, ramp, dst));
+
+			indices = _mm256_add_ps(indices, index_step);
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i] * (gain + (step * static_cast<float>(i)));
+		}
+	}
+
+	OALSFXPP_TARGET("avx2,fma")
+	static void mul(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm256_set1_ps(gain);
+
+		auto i = 0;
+
+		for (; (i + 8) <= sample_count; i += 8)
+		{
+			_mm256_storeu_ps(dst_samples + i, _mm256_mul_ps(_mm256_loadu_ps(src_samples + i), gains));
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] = src_samples[i] * gain;
+		}
+	}
+
+	OALSFXPP_TARGET("avx2,fma")
+	static void add(
+		const float* const src_samples,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		auto i = 0;
+
+		for (; (i + 8) <= sample_count; i += 8)
+		{
+			_mm256_storeu_ps(dst_samples + i, _mm256_add_ps(_mm256_loadu_ps(dst_samples + i), _mm256_loadu_ps(src_samples + i)));
+		}
+
+		for (; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i];
+		}
+	}
+}; // Avx2MixKernels
+
+
+struct Avx512MixKernels
+{
+	OALSFXPP_TARGET("avx512f")
+	static void mul_add(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm512_set1_ps(gain);
+
+		for (int i = 0; i < sample_count; i += 16)
+		{
+			const auto mask = get_mask(sample_count - i);
+			const auto src = _mm512_maskz_loadu_ps(mask, src_samples + i);
+			const auto dst = _mm512_maskz_loadu_ps(mask, dst_samples + i);
+
+			_mm512_mask_storeu_ps(dst_samples + i, mask, _mm512_fmadd_ps(src, gains, dst));
+		}
+	}
+
+	OALSFXPP_TARGET("avx512f")
+	static void mul_add_ramp(
+		const float* const src_samples,
+		const float gain,
+		const float step,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm512_set1_ps(gain);
+		const auto steps = _mm512_set1_ps(step);
+		const auto index_step = _mm512_set1_ps(16.0F);
+
+		auto indices = _mm512_setr_ps(
+			0.0F, 1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F,
+			8.0F, 9.0F, 10.0F, 11.0F, 12.0F, 13.0F, 14.0F, 15.0F);
+
+		for (int i = 0; i < sample_count; i += 16)
+		{
+			const auto mask = get_mask(sample_count - i);
+			const auto src = _mm512_maskz_loadu_ps(mask, src_samples + i);
+			const auto dst = _mm512_maskz_loadu_ps(mask, dst_samples + i);
+			const auto ramp = _mm512_fmadd_ps(steps, indices, gains);
+
+			_mm512_mask_storeu_ps(dst_samples + i, mask, _mm512_fmadd_ps(src, ramp, dst));
+
+			indices = _mm512_add_ps(indices, index_step);
+		}
+	}
+
+	OALSFXPP_TARGET("avx512f")
+	static void mul(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		const auto gains = _mm512_set1_ps(gain);
+
+		for (int i = 0; i < sample_count; i += 16)
+		{
+			const auto mask = get_mask(sample_count - i);
+			const auto src = _mm512_maskz_loadu_ps(mask, src_samples + i);
+
+			_mm512_mask_storeu_ps(dst_samples + i, mask, _mm512_mul_ps(src, gains));
+		}
+	}
+
+	OALSFXPP_TARGET("avx512f")
+	static void add(
+		const float* const src_samples,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		for (int i = 0; i < sample_count; i += 16)
+		{
+			const auto mask = get_mask(sample_count - i);
+			const auto src = _mm512_maskz_loadu_ps(mask, src_samples + i);
+			const auto dst = _mm512_maskz_loadu_ps(mask, dst_samples + i);
+
+			_mm512_mask_storeu_ps(dst_samples + i, mask, _mm512_add_ps(dst, src));
+		}
+	}
+
+
+private:
+	// Gets a mask of the remaining lanes.
+	static __mmask16 get_mask(
+		const int remaining_count)
+	{
+		return remaining_count >= 16 ?
+			static_cast<__mmask16>(0xFFFFU) :
+			static_cast<__mmask16>((1U << remaining_count) - 1U);
+	}
+}; // Avx512MixKernels
+
+#endif // OALSFXPP_X86_SIMD
+
+
+struct MixHelpers
+{
+	// Selects the mixing kernels for the CPU.
+	//
+	// Note: The kernels are selected once for all instances.
+	static void initialize()
+	{
+		static const auto is_initialized = select_kernels();
+
+		static_cast<void>(is_initialized);
+	}
+
+	// Basically the inverse of the "mix". Rather than one input going to multiple
+	// outputs (each with its own gain), it's multiple inputs (each with its own
+	// gain) going to one output. This applies one row (vs one column) of a matrix
+	// transform. And as the matrices are more or less static once set up, no
+	// stepping is necessary.
+	static void mix_row(
+		float* dst_buffer,
+		const float* gains,
+		const SampleBuffers& src_buffers,
+		const int channel_count,
+		const int src_position,
+		const int buffer_size)
+	{
+		for (int c = 0; c < channel_count; ++c)
+		{
+			const auto gain = gains[c];
+
+			if (!(std::abs(gain) > silence_threshold_gain))
+			{
+				continue;
+			}
+
+			kernels_.mul_add_(src_buffers[c].data() + src_position, gain, dst_buffer, buffer_size);
+		}
+	}
+
+	static void mix(
+		const float* data,
+		const int channel_count,
+		SampleBuffers& dst_buffers,
+		float* current_gains,
+		const float* target_gains,
+		const int counter,
+		const int dst_position,
+		const int buffer_size)
+	{
+		const auto delta = ((counter > 0) ? 1.0F / static_cast<float>(counter) : 0.0F);
+
+		for (int c = 0; c < channel_count; ++c)
+		{
+			auto pos = 0;
+			auto gain = current_gains[c];
+			const auto step = (target_gains[c] - gain) * delta;
+			const auto dst_samples = dst_buffers[c].data() + dst_position;
+
+			if (std::abs(step) > Math::get_epsilon())
+			{
+				pos = std::min(buffer_size, counter);
+
+				kernels_.mul_add_ramp_(data, gain, step, dst_samples, pos);
+
+				if (pos == counter)
+				{
+					gain = target_gains[c];
+				}
+				else
+				{
+					gain += step * static_cast<float>(pos);
+				}
+
+				current_gains[c] = gain;
+			}
+
+			if (!(std::abs(gain) > silence_threshold_gain))
+			{
+				continue;
+			}
+
+			kernels_.mul_add_(data + pos, gain, dst_samples + pos, buffer_size - pos);
+		}
+	}
+
+	// Adds the source samples scaled by the gain to the target ones.
+	static void mul_add(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		kernels_.mul_add_(src_samples, gain, dst_samples, sample_count);
+	}
+
+	// Stores the source samples scaled by the gain into the target ones.
+	static void mul(
+		const float* const src_samples,
+		const float gain,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		kernels_.mul_(src_samples, gain, dst_samples, sample_count);
+	}
+
+	// Adds the source samples to the target ones.
+	static void add(
+		const float* const src_samples,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		kernels_.add_(src_samples, dst_samples, sample_count);
+	}
+
+
+private:
+	static MixKernels kernels_;
+
+
+	static bool select_kernels()
+	{
+#ifdef OALSFXPP_X86_SIMD
+		const auto& cpu_features = CpuFeatures::get();
+
+		if (cpu_features.has_avx512f_)
+		{
+			kernels_ = MixKernels
+			{
+				Avx512MixKernels::mul_add,
+				Avx512MixKernels::mul_add_ramp,
+				Avx512MixKernels::mul,
+				Avx512MixKernels::add,
+			};
+		}
+		else if (cpu_features.has_avx2_fma_)
+		{
+			kernels_ = MixKernels
+			{
+				Avx2MixKernels::mul_add,
+				Avx2MixKernels::mul_add_ramp,
+				Avx2MixKernels::mul,
+				Avx2MixKernels::add,
+			};
+		}
+		else if (cpu_features.has_sse2_)
+		{
+			kernels_ = MixKernels
+			{
+				Sse2MixKernels::mul_add,
+				Sse2MixKernels::mul_add_ramp,
+				Sse2MixKernels::mul,
+				Sse2MixKernels::add,
+			};
+		}
+#endif
+
+		return true;
+	}
+}; // MixHelpers
+
+
+MixKernels MixHelpers::kernels_ = MixKernels
+{
+	ScalarMixKernels::mul_add,
+	ScalarMixKernels::mul_add_ramp,
+	ScalarMixKernels::mul,
+	ScalarMixKernels::add,
+};
+
+
+// Triangular probability density function (TPDF) dither.
+struct TpdfDither
+{
+	std::uint32_t seed_;
+
+
+	void initialize()
+	{
+		seed_ = 22'222;
+	}
+
+	// Returns a dither value in range (-1, 1) of the least significant bit.
+	float generate()
+	{
+		const auto value1 = generate_uniform();
+		const auto value2 = generate_uniform();
+
+		return value1 - value2;
+	}
+
+
+private:
+	// Returns a uniformly distributed value in range [0, 1).
+	float generate_uniform()
+	{
+		seed_ = (seed_ * 1'664'525U) + 1'013'904'223U;
+
+		return static_cast<float>(seed_ >> 8) * (1.0F / 16'777'216.0F);
+	}
+}; // TpdfDither
+
+
+struct SampleConverter
+{
+	static float to_f32(
+		const float sample)
+	{
+		return sample;
+	}
+
+	static float to_f32(
+		const std::int16_t sample)
+	{
+		return static_cast<float>(sample) * (1.0F / 32'768.0F);
+	}
+
+	static float to_f32(
+		const std::int32_t sample)
+	{
+		return static_cast<float>(sample) * (1.0F / 2'147'483'648.0F);
+	}
+
+	// Note: The dither value is in units of the least significant bit.
+	static void from_f32(
+		const float sample,
+		const float dither,
+		float& dst_sample)
+	{
+		static_cast<void>(dither);
+
+		dst_sample = sample;
+	}
+
+	static void from_f32(
+		const float sample,
+		const float dither,
+		std::int16_t& dst_sample)
+	{
+		const auto value = Math::clamp((sample * 32'768.0F) + dither, -32'768.0F, 32'767.0F);
+
+		dst_sample = static_cast<std::int16_t>(std::lrint(value));
+	}
+
+	static void from_f32(
+		const float sample,
+		const float dither,
+		std::int32_t& dst_sample)
+	{
+		// The greatest float value less than 2^31.
+		constexpr auto max_value = 2'147'483'520.0F;
+
+		const auto value = Math::clamp((sample * 2'147'483'648.0F) + dither, -2'147'483'648.0F, max_value);
+
+		dst_sample = static_cast<std::int32_t>(std::lrint(value));
+	}
+}; // SampleConverter
+
+
+// A fixed set of threads which run the tasks of a job
+// in parallel with the calling thread.
+class WorkerPool
+{
+public:
+	using TaskFunc = void (*)(
+		void* context,
+		const int task_index);
+
+
+	WorkerPool()
+		:
+		threads_{},
+		mutex_{},
+		start_cv_{},
+		done_cv_{},
+		is_quit_{},
+		job_id_{},
+		busy_worker_count_{},
+		task_func_{},
+		task_context_{},
+		task_count_{},
+		next_task_index_{}
+	{
+	}
+
+	WorkerPool(
+		const WorkerPool& that) = delete;
+
+	WorkerPool& operator=(
+		const WorkerPool& that) = delete;
+
+	~WorkerPool()
+	{
+		uninitialize();
+	}
+
+
+	// Starts the worker threads.
+	//
+	// Returns true on success or false otherwise.
+	bool initialize(
+		const int worker_count)
+	{
+		uninitialize();
+
+		is_quit_ = false;
+		job_id_ = 0;
+		busy_worker_count_ = 0;
+
+		threads_.reserve(worker_count);
+
+		try
+		{
+			for (int i = 0; i < worker_count; ++i)
+			{
+				threads_.emplace_back(&WorkerPool::worker_main, this, job_id_);
+			}
+		}
+		catch (const std::system_error&)
+		{
+			uninitialize();
+			return false;
+		}
+
+		return true;
+	}
+
+	// Stops the worker threads.
+	void uninitialize()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			is_quit_ = true;
+		}
+
+		start_cv_.notify_all();
+
+		for (auto& thread : threads_)
+		{
+			thread.join();
+		}
+
+		threads_.clear();
+	}
+
+	int get_worker_count() const
+	{
+		return static_cast<int>(threads_.size());
+	}
+
+	// Runs the tasks in range [0..task_count) and waits for their completion.
+	void run(
+		const int task_count,
+		const TaskFunc task_func,
+		void* const task_context)
+	{
+		if (threads_.empty() || task_count <= 1)
+		{
+			for (int i = 0; i < task_count; ++i)
+			{
+				task_func(task_context, i);
+			}
+
+			return;
+		}
+
+		RtScope rt_scope{"WorkerPool::run"};
+		RtScope::check(RtChecks::ViolationType::blocking_call, 0);
+
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+
+			task_func_ = task_func;
+			task_context_ = task_context;
+			task_count_ = task_count;
+			next_task_index_.store(0, std::memory_order_relaxed);
+			busy_worker_count_ = get_worker_count();
+			++job_id_;
+		}
+
+		start_cv_.notify_all();
+
+		run_tasks();
+
+		std::unique_lock<std::mutex> lock{mutex_};
+		done_cv_.wait(lock, [this]() { return busy_worker_count_ == 0; });
+	}
+
+
+private:
+	using Threads = std::vector<std::thread>;
+
+
+	Threads threads_;
+	std::mutex mutex_;
+	std::condition_variable start_cv_;
+	std::condition_variable done_cv_;
+	bool is_quit_;
+	unsigned int job_id_;
+	int busy_worker_count_;
+	TaskFunc task_func_;
+	void* task_context_;
+	int task_count_;
+	std::atomic<int> next_task_index_;
+
+
+	void run_tasks()
+	{
+		while (true)
+		{
+			const auto task_index = next_task_index_.fetch_add(1, std::memory_order_relaxed);
+
+			if (task_index >= task_count_)
+			{
+				break;
+			}
+
+			task_func_(task_context_, task_index);
+		}
+	}
+
+	// Note: The initial job id is passed by the creator, because
+	// a thread may start after the first job has been posted.
+	void worker_main(
+		unsigned int job_id)
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock{mutex_};
+				start_cv_.wait(lock, [this, job_id]() { return is_quit_ || job_id_ != job_id; });
+
+				if (is_quit_)
+				{
+					break;
+				}
+
+				job_id = job_id_;
+			}
+
+			run_tasks();
+
+			{
+				std::lock_guard<std::mutex> lock{mutex_};
+				--busy_worker_count_;
+			}
+
+			done_cv_.notify_one();
+		}
+	}
+}; // WorkerPool
+
+
+// ==========================================================================
+// Api::Impl
+
+struct ApiImplErrorMessages
 {
-	Math::clamp_i(density_, min_density, max_density);
-	Math::clamp_i(diffusion_, min_diffusion, max_diffusion);
-	Math::clamp_i(gain_, min_gain, max_gain);
-	Math::clamp_i(gain_hf_, min_gain_hf, max_gain_hf);
-	Math::clamp_i(gain_lf_, min_gain_lf, max_gain_lf);
-	Math::clamp_i(decay_time_, min_decay_time, max_decay_time);
-	Math::clamp_i(decay_hf_ratio_, min_decay_hf_ratio, max_decay_hf_ratio);
-	Math::clamp_i(decay_lf_ratio_, min_decay_lf_ratio, max_decay_lf_ratio);
-	Math::clamp_i(reflections_gain_, min_reflections_gain, max_reflections_gain);
-	Math::clamp_i(reflections_delay_, min_reflections_delay, max_reflections_delay);
-	Math::clamp_i(reflections_pan_[0], min_reflections_pan_xyz, max_reflections_pan_xyz);
-	Math::clamp_i(reflections_pan_[1], min_reflections_pan_xyz, max_reflections_pan_xyz);
-	Math::clamp_i(reflections_pan_[2], min_reflections_pan_xyz, max_reflections_pan_xyz);
-	Math::clamp_i(late_reverb_gain_, min_late_reverb_gain, max_late_reverb_gain);
-	Math::clamp_i(late_reverb_delay_, min_late_reverb_delay, max_late_reverb_delay);
-	Math::clamp_i(late_reverb_pan_[0], min_late_reverb_pan_xyz, max_late_reverb_pan_xyz);
-	Math::clamp_i(late_reverb_pan_[1], min_late_reverb_pan_xyz, max_late_reverb_pan_xyz);
-	Math::clamp_i(late_reverb_pan_[2], min_late_reverb_pan_xyz, max_late_reverb_pan_xyz);
-	Math::clamp_i(echo_time_, min_echo_time, max_echo_time);
-	Math::clamp_i(echo_depth_, min_echo_depth, max_echo_depth);
-	Math::clamp_i(modulation_time_, min_modulation_time, max_modulation_time);
-	Math::clamp_i(modulation_depth_, min_modulation_depth, max_modulation_depth);
-	Math::clamp_i(air_absorption_gain_hf_, min_air_absorption_gain_hf, max_air_absorption_gain_hf);
-	Math::clamp_i(hf_reference_, min_hf_reference, max_hf_reference);
-	Math::clamp_i(lf_reference_, min_lf_reference, max_lf_reference);
-	Math::clamp_i(room_rolloff_factor_, min_room_rolloff_factor, max_room_rolloff_factor);
-	Math::clamp_i(decay_hf_limit_, min_decay_hf_limit, max_decay_hf_limit);
-}
+	static constexpr auto no_error = "";
+	static constexpr auto invalid_channel_format = "Invalid channel format.";
+	static constexpr auto sampling_rate_out_of_range = "Sampling rate is out of range.";
+	static constexpr auto effect_count_out_of_range = "Effect count is out of range.";
+	static constexpr auto source_count_out_of_range = "Source count is out of range.";
+	static constexpr auto block_size_out_of_range = "Block size is out of range.";
+	static constexpr auto worker_count_out_of_range = "Worker count is out of range.";
+	static constexpr auto invalid_distortion_oversampling_factor = "Invalid distortion oversampling factor.";
+	static constexpr auto start_workers = "Failed to start worker threads.";
+	static constexpr auto too_many_scheduled_events = "Too many scheduled events.";
+	static constexpr auto too_many_effect_type_changes = "Too many effect type changes waiting for mixing.";
+	static constexpr auto create_effect_states = "Failed to create effect states.";
+	static constexpr auto allocate_memory = "Failed to allocate memory.";
+}; // ApiImplErrorMessages
+
+
+constexpr const char* ApiImplErrorMessages::no_error;
+constexpr const char* ApiImplErrorMessages::invalid_channel_format;
+constexpr const char* ApiImplErrorMessages::sampling_rate_out_of_range;
+constexpr const char* ApiImplErrorMessages::effect_count_out_of_range;
+constexpr const char* ApiImplErrorMessages::source_count_out_of_range;
+constexpr const char* ApiImplErrorMessages::block_size_out_of_range;
+constexpr const char* ApiImplErrorMessages::worker_count_out_of_range;
+constexpr const char* ApiImplErrorMessages::invalid_distortion_oversampling_factor;
+constexpr const char* ApiImplErrorMessages::start_workers;
+constexpr const char* ApiImplErrorMessages::too_many_scheduled_events;
+constexpr const char* ApiImplErrorMessages::too_many_effect_type_changes;
+constexpr const char* ApiImplErrorMessages::create_effect_states;
+constexpr const char* ApiImplErrorMessages::allocate_memory;
+
+
+class Api::Impl
+{
+public:
+	// The size of the instance's header with the memory resource.
+	static constexpr auto memory_header_size = Arena::alignment;
+
+
+	Arena arena_;
+	Device device_;
+	Sources sources_;
+	EffectContexts effect_contexts_;
+	int effect_count_;
+	TpdfDither dither_;
+	WorkerPool worker_pool_;
+	EffectSlotPtrs pending_effect_slots_;
+	int pending_sample_count_;
+	SpscQueue<ScheduledEvent> event_queue_;
+	ScheduledEvents scheduled_events_;
+	int scheduled_event_index_;
+	const char* error_message_;
+
+
+	explicit Impl(
+		MemoryResource& memory_resource)
+		:
+		arena_{memory_resource},
+		device_{},
+		sources_{},
+		effect_contexts_{},
+		effect_count_{},
+		dither_{},
+		worker_pool_{},
+		pending_effect_slots_{},
+		pending_sample_count_{},
+		event_queue_{},
+		scheduled_events_{},
+		scheduled_event_index_{},
+		error_message_{ApiImplErrorMessages::no_error}
+	{
+	}
+
+	~Impl()
+	{
+		uninitialize();
+	}
+
+
+	// Allocates the instance from the memory resource.
+	//
+	// The resource is stored before the instance to free it.
+	static void* operator new(
+		const std::size_t size,
+		MemoryResource& memory_resource,
+		const std::nothrow_t&) noexcept
+	{
+		static_assert(alignof(Impl) <= Arena::alignment, "Unsupported alignment.");
+
+		const auto block = static_cast<unsigned char*>(
+			memory_resource.allocate(memory_header_size + size, Arena::alignment));
+
+		if (!block)
+		{
+			return nullptr;
+		}
+
+		*reinterpret_cast<MemoryResource**>(block) = &memory_resource;
+
+		return block + memory_header_size;
+	}
+
+	static void operator delete(
+		void* const pointer,
+		MemoryResource& memory_resource,
+		const std::nothrow_t&) noexcept
+	{
+		const auto block = static_cast<unsigned char*>(pointer) - memory_header_size;
+
+		memory_resource.deallocate(block, memory_header_size + sizeof(Impl), Arena::alignment);
+	}
+
+	static void operator delete(
+		void* const pointer) noexcept
+	{
+		if (!pointer)
+		{
+			return;
+		}
+
+		const auto block = static_cast<unsigned char*>(pointer) - memory_header_size;
+		const auto memory_resource = *reinterpret_cast<MemoryResource**>(block);
+
+		memory_resource->deallocate(block, memory_header_size + sizeof(Impl), Arena::alignment);
+	}
+
+
+	bool initialize(
+		const InitParams& init_params)
+	{
+		uninitialize();
+
+		MixHelpers::initialize();
+		FilterBankHelpers::initialize();
+		WaveshaperHelpers::initialize();
+
+		const auto channel_format = init_params.channel_format_;
+		const auto sampling_rate = init_params.sampling_rate_;
+		const auto effect_count = init_params.effect_count_;
+		const auto source_count = init_params.source_count_;
+		const auto block_size = init_params.block_size_;
+		const auto worker_count = init_params.worker_count_;
+		const auto distortion_oversampling_factor = init_params.distortion_oversampling_factor_;
+
+		const auto channel_count = Device::channel_format_to_channel_count(channel_format);
+
+		if (channel_count == 0)
+		{
+			error_message_ = ApiImplErrorMessages::invalid_channel_format;
+			return false;
+		}
+
+		if (sampling_rate < min_sampling_rate)
+		{
+			error_message_ = ApiImplErrorMessages::sampling_rate_out_of_range;
+			return false;
+		}
+
+		if (effect_count <= 0 || effect_count > max_effects)
+		{
+			error_message_ = ApiImplErrorMessages::effect_count_out_of_range;
+			return false;
+		}
+
+		if (source_count < min_sources || source_count > max_sources)
+		{
+			error_message_ = ApiImplErrorMessages::source_count_out_of_range;
+			return false;
+		}
+
+		if (block_size < min_block_size || block_size > max_block_size)
+		{
+			error_message_ = ApiImplErrorMessages::block_size_out_of_range;
+			return false;
+		}
+
+		if (worker_count < min_workers || worker_count > max_workers)
+		{
+			error_message_ = ApiImplErrorMessages::worker_count_out_of_range;
+			return false;
+		}
+
+		// A power of two.
+		if (distortion_oversampling_factor <= 0 ||
+			distortion_oversampling_factor > max_distortion_oversampling_factor ||
+			(distortion_oversampling_factor & (distortion_oversampling_factor - 1)) != 0)
+		{
+			error_message_ = ApiImplErrorMessages::invalid_distortion_oversampling_factor;
+			return false;
+		}
+
+		// The first pass measures the memory of the instance,
+		// and the second one lays it out in the arena.
+		{
+			ArenaScope arena_scope{arena_};
+
+			arena_.begin_measure();
+
+			const auto is_measured = initialize_memory(init_params);
+
+			release_memory();
+
+			if (!is_measured)
+			{
+				return false;
+			}
+		}
+
+		if (!arena_.initialize(arena_.get_measured_size()))
+		{
+			error_message_ = ApiImplErrorMessages::allocate_memory;
+			return false;
+		}
+
+		{
+			ArenaScope arena_scope{arena_};
+
+			if (!initialize_memory(init_params))
+			{
+				return false;
+			}
+		}
+
+		if (!worker_pool_.initialize(worker_count))
+		{
+			error_message_ = ApiImplErrorMessages::start_workers;
+			return false;
+		}
+
+		return true;
+	}
+
+	void uninitialize()
+	{
+		worker_pool_.uninitialize();
+
+		release_memory();
+
+		arena_.uninitialize();
+	}
+
+	// Allocates and initializes the containers of the instance in the current arena.
+	//
+	// Returns true on success or false otherwise.
+	bool initialize_memory(
+		const InitParams& init_params)
+	{
+		const auto channel_format = init_params.channel_format_;
+		const auto sampling_rate = init_params.sampling_rate_;
+		const auto effect_count = init_params.effect_count_;
+		const auto source_count = init_params.source_count_;
+		const auto block_size = init_params.block_size_;
+		const auto worker_count = init_params.worker_count_;
+		const auto are_effect_states_pooled = init_params.are_effect_states_pooled_;
+		const auto distortion_oversampling_factor = init_params.distortion_oversampling_factor_;
+
+		// Bind the containers to the current arena.
+		release_memory();
+
+		device_.initialize(channel_format, sampling_rate, block_size, distortion_oversampling_factor);
+
+		effect_count_ = effect_count;
+
+		// Note: The effect contexts are not movable.
+		effect_contexts_ = EffectContexts(effect_count_);
+
+		for (auto& effect_context : effect_contexts_)
+		{
+			effect_context.deferred_effect_.set_type_and_defaults(EffectType::null);
+			effect_context.applied_effect_.set_type_and_defaults(EffectType::null);
+			effect_context.is_suspended_.store(false, std::memory_order_relaxed);
+
+			if (!effect_context.effect_slot_.initialize(device_, are_effect_states_pooled))
+			{
+				error_message_ = ApiImplErrorMessages::create_effect_states;
+				return false;
+			}
+
+			// The state of the null effect.
+			effect_context.created_effect_state_count_ = 0;
+			effect_context.live_effect_state_count_ = 1;
+			effect_context.taken_effect_state_count_ = 0;
+
+			if (!are_effect_states_pooled)
+			{
+				effect_context.created_effect_states_.initialize(max_pending_effect_states);
+				effect_context.retired_effect_states_.initialize(max_pending_effect_states);
+			}
+
+			if (worker_count > 0)
+			{
+				effect_context.effect_slot_.output_buffer_.assign(device_.channel_count_, SampleBuffer(block_size));
+			}
+		}
+
+		pending_effect_slots_.clear();
+		pending_effect_slots_.reserve(effect_count_);
+
+		event_queue_.initialize(max_scheduled_events);
+
+		scheduled_events_.clear();
+		scheduled_events_.reserve(max_scheduled_events);
+		scheduled_event_index_ = 0;
+
+		// Note: The sources are not movable.
+		sources_ = Sources(source_count);
+
+		for (auto& source : sources_)
+		{
+			source.initialize(effect_count);
+		}
+
+		dither_.initialize();
+
+		return true;
+	}
+
+	// Frees the containers of the instance.
+	void release_memory()
+	{
+		effect_contexts_ = EffectContexts{};
+		sources_ = Sources{};
+		pending_effect_slots_ = EffectSlotPtrs{};
+		event_queue_.uninitialize();
+		scheduled_events_ = ScheduledEvents{};
+
+		device_.uninitialize();
+	}
+
+	// Reads interleaved source samples.
+	//
+	// There is one buffer per source; a null buffer denotes a silent source.
+	template<typename T>
+	struct InterleavedReader
+	{
+		const T* const* samples_;
+		int source_count_;
+		int channel_count_;
+
+
+		bool has_source(
+			const int source_index) const
+		{
+			return source_index < source_count_ && samples_[source_index];
+		}
+
+		const float* read(
+			const int source_index,
+			const int channel,
+			const int offset,
+			const int sample_count,
+			float* dst_samples) const
+		{
+			auto src_samples = &samples_[source_index][(offset * channel_count_) + channel];
+
+			for (int i = 0; i < sample_count; ++i)
+			{
+				dst_samples[i] = SampleConverter::to_f32(src_samples[i * channel_count_]);
+			}
+
+			return dst_samples;
+		}
+	}; // InterleavedReader
+
+	// Reads planar source samples of the first source.
+	//
+	// Returns the source plane itself, so no copy is made.
+	struct PlanarReader
+	{
+		const float* const* channels_;
+
+
+		bool has_source(
+			const int source_index) const
+		{
+			return source_index == 0;
+		}
+
+		const float* read(
+			const int source_index,
+			const int channel,
+			const int offset,
+			const int sample_count,
+			float* dst_samples) const
+		{
+			static_cast<void>(source_index);
+			static_cast<void>(sample_count);
+			static_cast<void>(dst_samples);
+
+			return &channels_[channel][offset];
+		}
+	}; // PlanarReader
+
+	// Writes interleaved target samples.
+	//
+	// Integer samples are saturated, and optionally dithered.
+	template<typename T>
+	struct InterleavedWriter
+	{
+		T* samples_;
+		TpdfDither* dither_;
+
+
+		void write(
+			const SampleBuffers& src_buffers,
+			const int offset,
+			const int sample_count,
+			const int channel_count) const
+		{
+			for (int j = 0; j < channel_count; ++j)
+			{
+				const auto& src_buffer = src_buffers[j];
+				auto out = &samples_[(offset * channel_count) + j];
+
+				if (dither_)
+				{
+					for (int i = 0; i < sample_count; ++i)
+					{
+						SampleConverter::from_f32(src_buffer[i], dither_->generate(), out[i * channel_count]);
+					}
+				}
+				else
+				{
+					for (int i = 0; i < sample_count; ++i)
+					{
+						SampleConverter::from_f32(src_buffer[i], 0.0F, out[i * channel_count]);
+					}
+				}
+			}
+		}
+	}; // InterleavedWriter
 
-bool EffectProps::Reverb::are_equal(
-	const Reverb& a,
-	const Reverb& b)
-{
-	return
-		a.density_ == b.density_ &&
-		a.diffusion_ == b.diffusion_ &&
-		a.gain_ == b.gain_ &&
-		a.gain_hf_ == b.gain_hf_ &&
-		a.gain_lf_ == b.gain_lf_ &&
-		a.decay_time_ == b.decay_time_ &&
-		a.decay_hf_ratio_ == b.decay_hf_ratio_ &&
-		a.decay_lf_ratio_ == b.decay_lf_ratio_ &&
-		a.reflections_gain_ == b.reflections_gain_ &&
-		a.reflections_delay_ == b.reflections_delay_ &&
-		a.reflections_pan_ == b.reflections_pan_ &&
-		a.late_reverb_gain_ == b.late_reverb_gain_ &&
-		a.late_reverb_delay_ == b.late_reverb_delay_ &&
-		a.late_reverb_pan_ == b.late_reverb_pan_ &&
-		a.echo_time_ == b.echo_time_ &&
-		a.echo_depth_ == b.echo_depth_ &&
-		a.modulation_time_ == b.modulation_time_ &&
-		a.modulation_depth_ == b.modulation_depth_ &&
-		a.air_absorption_gain_hf_ == b.air_absorption_gain_hf_ &&
-		a.hf_reference_ == b.hf_reference_ &&
-		a.lf_reference_ == b.lf_reference_ &&
-		a.room_rolloff_factor_ == b.room_rolloff_factor_ &&
-		a.decay_hf_limit_ == b.decay_hf_limit_;
-}
+	// Writes planar target samples.
+	struct PlanarWriter
+	{
+		float* const* channels_;
 
-void EffectProps::RingModulator::set_defaults()
-{
-	frequency_ = default_frequency;
-	high_pass_cutoff_ = default_high_pass_cutoff;
-	waveform_ = default_waveform;
-}
 
-void EffectProps::RingModulator::normalize()
-{
-	Math::clamp_i(frequency_, min_frequency, max_frequency);
-	Math::clamp_i(high_pass_cutoff_, min_high_pass_cutoff, max_high_pass_cutoff);
-	Math::clamp_i(waveform_, min_waveform, max_waveform);
-}
+		void write(
+			const SampleBuffers& src_buffers,
+			const int offset,
+			const int sample_count,
+			const int channel_count) const
+		{
+			for (int j = 0; j < channel_count; ++j)
+			{
+				std::copy_n(src_buffers[j].cbegin(), sample_count, &channels_[j][offset]);
+			}
+		}
+	}; // PlanarWriter
 
-bool EffectProps::RingModulator::are_equal(
-	const RingModulator& a,
-	const RingModulator& b)
-{
-	return
-		a.frequency_ == b.frequency_ &&
-		a.high_pass_cutoff_ == b.high_pass_cutoff_ &&
-		a.waveform_ == b.waveform_;
-}
 
-// EffectProps
-// ==========================================================================
+	// Checks the channel planes for null pointers.
+	template<typename T>
+	static bool are_channels_valid(
+		const T* const* channels,
+		const int channel_count)
+	{
+		if (!channels)
+		{
+			return false;
+		}
 
+		for (int i = 0; i < channel_count; ++i)
+		{
+			if (!channels[i])
+			{
+				return false;
+			}
+		}
 
-// ==========================================================================
-// Effect
+		return true;
+	}
 
-void Effect::set_defaults()
-{
-	switch (type_)
+	template<typename TReader>
+	void mix_source(
+		Source& source,
+		const int source_index,
+		const TReader& reader,
+		const int offset,
+		const int sample_count)
 	{
-	case EffectType::chorus:
-		props_.chorus_.set_defaults();
-		break;
+		const auto channel_count = device_.channel_count_;
 
-	case EffectType::compressor:
-		props_.compressor_.set_defaults();
-		break;
+		const float* src_samples[max_channels];
+		float* filtered_samples[max_channels];
 
-	case EffectType::dedicated_dialog:
-	case EffectType::dedicated_low_frequency:
-		props_.dedicated_.set_defaults();
-		break;
+		for (int chan = 0; chan < channel_count; ++chan)
+		{
+			src_samples[chan] = reader.read(source_index, chan, offset, sample_count, device_.resampled_data_[chan].data());
+			filtered_samples[chan] = device_.filtered_data_[chan].data();
+		}
 
-	case EffectType::distortion:
-		props_.distortion_.set_defaults();
-		break;
+		mix_send(source.direct_, channel_count, src_samples, filtered_samples, sample_count);
 
-	case EffectType::echo:
-		props_.echo_.set_defaults();
-		break;
+		for (auto& aux : source.auxes_)
+		{
+			if (!aux.buffers_)
+			{
+				continue;
+			}
 
-	case EffectType::equalizer:
-		props_.equalizer_.set_defaults();
-		break;
+			mix_send(aux, channel_count, src_samples, filtered_samples, sample_count);
+		}
+	}
 
-	case EffectType::flanger:
-		props_.flanger_.set_defaults();
-		break;
+	// Filters all the channels of a source at once and mixes them into the send's buffers.
+	static void mix_send(
+		Source::Send& send,
+		const int channel_count,
+		const float* const* src_samples,
+		float* const* filtered_samples,
+		const int sample_count)
+	{
+		const auto samples = apply_filters(
+			send.low_pass_,
+			send.high_pass_,
+			channel_count,
+			filtered_samples,
+			src_samples,
+			sample_count,
+			send.filter_type_);
 
-	case EffectType::eax_reverb:
-	case EffectType::reverb:
-		props_.reverb_.set_defaults();
-		break;
+		for (int chan = 0; chan < channel_count; ++chan)
+		{
+			auto& parms = send.channels_[chan];
 
-	case EffectType::ring_modulator:
-		props_.ring_modulator_.set_defaults();
-		break;
+			parms.current_gains_ = parms.target_gains_;
 
-	case EffectType::null:
-	default:
-		break;
+			MixHelpers::mix(
+				samples[chan],
+				send.channel_count_,
+				*send.buffers_,
+				parms.current_gains_.data(),
+				parms.target_gains_.data(),
+				0,
+				0,
+				sample_count);
+		}
 	}
-}
 
-void Effect::set_type_and_defaults(
-	const EffectType effect_type)
-{
-	type_ = effect_type;
-	set_defaults();
-}
+	template<typename TReader>
+	void mix_sources(
+		const TReader& reader,
+		const int offset,
+		const int sample_count)
+	{
+		const auto source_count = static_cast<int>(sources_.size());
 
-void Effect::normalize()
-{
-	switch (type_)
+		for (int i = 0; i < source_count; ++i)
+		{
+			if (!reader.has_source(i))
+			{
+				continue;
+			}
+
+			mix_source(sources_[i], i, reader, offset, sample_count);
+		}
+	}
+
+	// Note: The whole block of source samples is read before the block
+	// of target samples is written, which makes in-place mixing safe.
+	template<typename TReader, typename TWriter>
+	void mix_data(
+		const int sample_count,
+		const TReader& reader,
+		const TWriter& writer)
 	{
-	case EffectType::chorus:
-		props_.chorus_.normalize();
-		break;
+		RtScope rt_scope{"Api::mix"};
 
-	case EffectType::compressor:
-		props_.compressor_.normalize();
-		break;
+		take_scheduled_events();
 
-	case EffectType::dedicated_dialog:
-	case EffectType::dedicated_low_frequency:
-		props_.dedicated_.normalize();
-		break;
+		for (int samples_done = 0; samples_done < sample_count; )
+		{
+			update_applied_changes();
+			apply_scheduled_events(samples_done);
 
-	case EffectType::distortion:
-		props_.distortion_.normalize();
-		break;
+			// Split the block at the next scheduled event.
+			const auto samples_to_do = std::min(
+				std::min(sample_count, get_next_scheduled_event_offset(sample_count)) - samples_done,
+				device_.block_size_);
 
-	case EffectType::echo:
-		props_.echo_.normalize();
-		break;
+			for (int c = 0; c < device_.channel_count_; ++c)
+			{
+				std::fill_n(device_.sample_buffers_[c].begin(), samples_to_do, 0.0F);
+			}
 
-	case EffectType::equalizer:
-		props_.equalizer_.normalize();
-		break;
+			update_context_sources();
+			update_effect_slots_activity(reader);
 
-	case EffectType::flanger:
-		props_.flanger_.normalize();
-		break;
+			for (auto& effect_context : effect_contexts_)
+			{
+				auto& effect_slot = effect_context.effect_slot_;
 
-	case EffectType::eax_reverb:
-	case EffectType::reverb:
-		props_.reverb_.normalize();
-		break;
+				if (!effect_slot.is_active_)
+				{
+					continue;
+				}
 
-	case EffectType::ring_modulator:
-		props_.ring_modulator_.normalize();
-		break;
+				for (int c = 0; c < max_effect_channels; ++c)
+				{
+					std::fill_n(effect_slot.wet_buffer_[c].begin(), samples_to_do, 0.0F);
+				}
+			}
 
-	case EffectType::null:
-	default:
-		break;
+			// source processing
+			mix_sources(reader, samples_done, samples_to_do);
+
+			// effect slot processing
+			pending_effect_slots_.clear();
+
+			for (auto& effect_context : effect_contexts_)
+			{
+				auto& effect_slot = effect_context.effect_slot_;
+
+				if (!effect_slot.is_active_ || !update_effect_slot_tail(effect_slot, samples_to_do))
+				{
+					continue;
+				}
+
+				pending_effect_slots_.emplace_back(&effect_slot);
+			}
+
+			process_effect_slots(samples_to_do);
+
+			writer.write(device_.sample_buffers_, samples_done, samples_to_do, device_.channel_count_);
+
+			samples_done += samples_to_do;
+		}
+
+		carry_over_scheduled_events(sample_count);
 	}
-}
 
-bool Effect::are_equal(
-	const Effect& a,
-	const Effect& b)
-{
-	if (a.type_ != b.type_)
+	// Adds the event to the queue.
+	//
+	// Called by the control.
+	//
+	// Returns true on success or false otherwise.
+	bool schedule_event(
+		const ScheduledEvent& event)
 	{
-		return false;
+		if (!event_queue_.push(event))
+		{
+			error_message_ = ApiImplErrorMessages::too_many_scheduled_events;
+			return false;
+		}
+
+		return true;
+	}
+
+	// Moves the queued events to the scheduled ones ordered by the offset.
+	//
+	// Note: The events with the same offset keep the order they were scheduled.
+	void take_scheduled_events()
+	{
+		const auto old_count = scheduled_events_.size();
+
+		auto event = ScheduledEvent{};
+
+		while (scheduled_events_.size() < scheduled_events_.capacity() && event_queue_.pop(event))
+		{
+			scheduled_events_.emplace_back(event);
+		}
+
+		if (scheduled_events_.size() == old_count)
+		{
+			return;
+		}
+
+		// Insert the new events into the ordered ones.
+		//
+		// Note: Unlike std::stable_sort it doesn't allocate a temporary buffer.
+		const auto begin = scheduled_events_.begin();
+
+		for (auto i = begin + old_count; i != scheduled_events_.end(); ++i)
+		{
+			const auto position = std::upper_bound(
+				begin,
+				i,
+				*i,
+				[](const ScheduledEvent& lhs, const ScheduledEvent& rhs)
+				{
+					return lhs.sample_offset_ < rhs.sample_offset_;
+				}
+			);
+
+			std::rotate(position, i, i + 1);
+		}
 	}
 
-	switch (a.type_)
+	// Gets the offset of the next event to apply.
+	//
+	// Returns the offset or the default one if there is no such event.
+	int get_next_scheduled_event_offset(
+		const int default_offset) const
 	{
-	case EffectType::null:
-		return true;
+		if (scheduled_event_index_ == static_cast<int>(scheduled_events_.size()))
+		{
+			return default_offset;
+		}
 
-	case EffectType::chorus:
-		return EffectProps::Chorus::are_equal(a.props_.chorus_, b.props_.chorus_);
+		return scheduled_events_[scheduled_event_index_].sample_offset_;
+	}
 
-	case EffectType::compressor:
-		return EffectProps::Compressor::are_equal(a.props_.compressor_, b.props_.compressor_);
+	// Applies the events up to the offset.
+	void apply_scheduled_events(
+		const int sample_offset)
+	{
+		const auto event_count = static_cast<int>(scheduled_events_.size());
 
-	case EffectType::dedicated_dialog:
-	case EffectType::dedicated_low_frequency:
-		return EffectProps::Dedicated::are_equal(a.props_.dedicated_, b.props_.dedicated_);
+		for ( ; scheduled_event_index_ < event_count; ++scheduled_event_index_)
+		{
+			const auto& event = scheduled_events_[scheduled_event_index_];
 
-	case EffectType::distortion:
-		return EffectProps::Distortion::are_equal(a.props_.distortion_, b.props_.distortion_);
+			if (event.sample_offset_ > sample_offset)
+			{
+				break;
+			}
 
-	case EffectType::echo:
-		return EffectProps::Echo::are_equal(a.props_.echo_, b.props_.echo_);
+			switch (event.type_)
+			{
+			case ScheduledEvent::Type::effect_props:
+			{
+				auto& effect_slot = effect_contexts_[event.effect_index_].effect_slot_;
 
-	case EffectType::equalizer:
-		return EffectProps::Equalizer::are_equal(a.props_.equalizer_, b.props_.equalizer_);
+				// Drop the properties of the replaced effect.
+				if (event.effect_.type_ == effect_slot.effect_.type_)
+				{
+					effect_slot.effect_.props_ = event.effect_.props_;
+					effect_slot.is_props_changed_ = true;
+				}
 
-	case EffectType::flanger:
-		return EffectProps::Flanger::are_equal(a.props_.flanger_, b.props_.flanger_);
+				break;
+			}
 
-	case EffectType::eax_reverb:
-	case EffectType::reverb:
-		return EffectProps::Reverb::are_equal(a.props_.reverb_, b.props_.reverb_);
+			case ScheduledEvent::Type::send_props:
+			{
+				auto& source = sources_[event.source_index_];
 
-	case EffectType::ring_modulator:
-		return EffectProps::RingModulator::are_equal(a.props_.ring_modulator_, b.props_.ring_modulator_);
+				auto& send = (
+					event.effect_index_ < 0 ?
+					source.direct_ :
+					source.auxes_[event.effect_index_]);
 
-	default:
-		return false;
+				send.props_ = event.send_props_;
+				source.are_props_changed_ = true;
+
+				break;
+			}
+			}
+		}
 	}
-}
 
-// Effect
-// ==========================================================================
+	// Removes the applied events, and shifts the rest to the next "mix" call.
+	void carry_over_scheduled_events(
+		const int sample_count)
+	{
+		scheduled_events_.erase(scheduled_events_.begin(), scheduled_events_.begin() + scheduled_event_index_);
+		scheduled_event_index_ = 0;
 
+		for (auto& event : scheduled_events_)
+		{
+			event.sample_offset_ -= sample_count;
+		}
+	}
 
-// ==========================================================================
-// SendProps
+	// Publishes the deferred changes which differ from the applied ones.
+	//
+	// Called by the control.
+	//
+	// Returns true on success or false otherwise.
+	bool apply_changes()
+	{
+		RtScope rt_scope{"Api::apply_changes"};
 
-constexpr float SendProps::lp_frequency_reference;
-constexpr float SendProps::hp_frequency_reference;
+		auto is_succeed = true;
 
-constexpr float SendProps::min_gain;
-constexpr float SendProps::max_gain;
-constexpr float SendProps::default_gain;
+		for (auto& effect_context : effect_contexts_)
+		{
+			destroy_retired_effect_states(effect_context);
 
-constexpr float SendProps::min_gain_hf;
-constexpr float SendProps::max_gain_hf;
-constexpr float SendProps::default_gain_hf;
+			effect_context.deferred_effect_.normalize();
 
-constexpr float SendProps::min_gain_lf;
-constexpr float SendProps::max_gain_lf;
-constexpr float SendProps::default_gain_lf;
+			if (Effect::are_equal(effect_context.deferred_effect_, effect_context.applied_effect_))
+			{
+				continue;
+			}
 
+			if (effect_context.deferred_effect_.type_ != effect_context.applied_effect_.type_ &&
+				!effect_context.effect_slot_.are_effect_states_pooled_ &&
+				!create_effect_state(effect_context))
+			{
+				// Keep the change deferred.
+				is_succeed = false;
+				continue;
+			}
 
-void SendProps::set_defaults()
-{
-	gain_ = default_gain;
-	gain_hf_ = default_gain_hf;
-	gain_lf_ = default_gain_lf;
-}
+			effect_context.applied_effect_ = effect_context.deferred_effect_;
 
-void SendProps::normalize()
-{
-	Math::clamp_i(gain_, min_gain, max_gain);
-	Math::clamp_i(gain_hf_, min_gain_hf, max_gain_hf);
-	Math::clamp_i(gain_lf_, min_gain_lf, max_gain_lf);
-}
+			auto& applied_effect = effect_context.effect_handoff_.get_back();
+			applied_effect.effect_ = effect_context.applied_effect_;
+			applied_effect.effect_state_count_ = effect_context.created_effect_state_count_;
 
-bool SendProps::are_equal(
-	const SendProps& a,
-	const SendProps& b)
-{
-	return
-		a.gain_ == b.gain_ &&
-		a.gain_hf_ == b.gain_hf_ &&
-		a.gain_lf_ == b.gain_lf_;
-}
+			effect_context.effect_handoff_.publish();
+		}
 
-// SendProps
-// ==========================================================================
+		for (auto& source : sources_)
+		{
+			apply_send_changes(source.direct_);
 
-// ==========================================================================
-// Reverb presets
+			for (auto& aux_send : source.auxes_)
+			{
+				apply_send_changes(aux_send);
+			}
+		}
 
-// Default
-//
-const EffectProps::Reverb ReverbPresets::Default::generic = {1.0000F, 1.0000F, 0.3162F, 0.8913F, 1.0000F, 1.4900F, 0.8300F, 1.0000F, 0.0500F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		return is_succeed;
+	}
 
-const EffectProps::Reverb ReverbPresets::Default::padded_cell = {0.1715F, 1.0000F, 0.3162F, 0.0010F, 1.0000F, 0.1700F, 0.1000F, 1.0000F, 0.2500F, 0.0010F, {0.0000F, 0.0000F, 0.0000F}, 1.2691F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+	// Creates the state of the deferred effect type, and hands it over to the mixing.
+	//
+	// Called by the control.
+	//
+	// Returns true on success or false otherwise.
+	bool create_effect_state(
+		EffectContext& effect_context)
+	{
+		// All states but the current one may be in the queues.
+		if (effect_context.live_effect_state_count_ > max_pending_effect_states)
+		{
+			error_message_ = ApiImplErrorMessages::too_many_effect_type_changes;
+			return false;
+		}
 
-const EffectProps::Reverb ReverbPresets::Default::room = {0.4287F, 1.0000F, 0.3162F, 0.5929F, 1.0000F, 0.4000F, 0.8300F, 1.0000F, 0.1503F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 1.0629F, 0.0030F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		// The state overflows the arena into its memory resource.
+		ArenaScope arena_scope{arena_};
 
-const EffectProps::Reverb ReverbPresets::Default::bathroom = {0.1715F, 1.0000F, 0.3162F, 0.2512F, 1.0000F, 1.4900F, 0.5400F, 1.0000F, 0.6531F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 3.2734F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		auto effect_state = EffectSlot::create_effect_state(device_, effect_context.deferred_effect_.type_);
 
-const EffectProps::Reverb ReverbPresets::Default::living_room = {0.9766F, 1.0000F, 0.3162F, 0.0010F, 1.0000F, 0.5000F, 0.1000F, 1.0000F, 0.2051F, 0.0030F, {0.0000F, 0.0000F, 0.0000F}, 0.2805F, 0.0040F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		if (!effect_state)
+		{
+			error_message_ = ApiImplErrorMessages::create_effect_states;
+			return false;
+		}
 
-const EffectProps::Reverb ReverbPresets::Default::stone_room = {1.0000F, 1.0000F, 0.3162F, 0.7079F, 1.0000F, 2.3100F, 0.6400F, 1.0000F, 0.4411F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1003F, 0.0170F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		effect_context.created_effect_states_.push(effect_state);
+		effect_context.created_effect_state_count_ += 1;
+		effect_context.live_effect_state_count_ += 1;
 
-const EffectProps::Reverb ReverbPresets::Default::auditorium = {1.0000F, 1.0000F, 0.3162F, 0.5781F, 1.0000F, 4.3200F, 0.5900F, 1.0000F, 0.4032F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.7170F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		return true;
+	}
 
-const EffectProps::Reverb ReverbPresets::Default::concert_hall = {1.0000F, 1.0000F, 0.3162F, 0.5623F, 1.0000F, 3.9200F, 0.7000F, 1.0000F, 0.2427F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.9977F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+	// Destroys the states returned by the mixing.
+	//
+	// Called by the control.
+	static void destroy_retired_effect_states(
+		EffectContext& effect_context)
+	{
+		auto effect_state = static_cast<EffectState*>(nullptr);
 
-const EffectProps::Reverb ReverbPresets::Default::cave = {1.0000F, 1.0000F, 0.3162F, 1.0000F, 1.0000F, 2.9100F, 1.3000F, 1.0000F, 0.5000F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.7063F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+		while (effect_context.retired_effect_states_.pop(effect_state))
+		{
+			EffectState::destroy(effect_state);
+			effect_context.live_effect_state_count_ -= 1;
+		}
+	}
 
-const EffectProps::Reverb ReverbPresets::Default::arena = {1.0000F, 1.0000F, 0.3162F, 0.4477F, 1.0000F, 7.2400F, 0.3300F, 1.0000F, 0.2612F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.0186F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+	static void apply_send_changes(
+		Source::Send& send)
+	{
+		send.deferred_props_.normalize();
 
-const EffectProps::Reverb ReverbPresets::Default::hangar = {1.0000F, 1.0000F, 0.3162F, 0.3162F, 1.0000F, 10.0500F, 0.2300F, 1.0000F, 0.5000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.2560F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		if (!SendProps::are_equal(send.deferred_props_, send.applied_props_))
+		{
+			send.applied_props_ = send.deferred_props_;
 
-const EffectProps::Reverb ReverbPresets::Default::carpeted_hallway = {0.4287F, 1.0000F, 0.3162F, 0.0100F, 1.0000F, 0.3000F, 0.1000F, 1.0000F, 0.1215F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 0.1531F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			send.props_handoff_.get_back() = send.applied_props_;
+			send.props_handoff_.publish();
+		}
+	}
 
-const EffectProps::Reverb ReverbPresets::Default::hallway = {0.3645F, 1.0000F, 0.3162F, 0.7079F, 1.0000F, 1.4900F, 0.5900F, 1.0000F, 0.2458F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.6615F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+	// Takes the changes published by the control.
+	//
+	// Called by the mixing at the block boundary.
+	void update_applied_changes()
+	{
+		auto is_routing_changed = false;
 
-const EffectProps::Reverb ReverbPresets::Default::stone_corridor = {1.0000F, 1.0000F, 0.3162F, 0.7612F, 1.0000F, 2.7000F, 0.7900F, 1.0000F, 0.2472F, 0.0130F, {0.0000F, 0.0000F, 0.0000F}, 1.5758F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		for (auto& effect_context : effect_contexts_)
+		{
+			auto& effect_slot = effect_context.effect_slot_;
 
-const EffectProps::Reverb ReverbPresets::Default::alley = {1.0000F, 0.3000F, 0.3162F, 0.7328F, 1.0000F, 1.4900F, 0.8600F, 1.0000F, 0.2500F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.9954F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 0.9500F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			if (effect_context.effect_handoff_.update())
+			{
+				const auto& applied_effect = effect_context.effect_handoff_.get_front();
 
-const EffectProps::Reverb ReverbPresets::Default::forest = {1.0000F, 0.3000F, 0.3162F, 0.0224F, 1.0000F, 1.4900F, 0.5400F, 1.0000F, 0.0525F, 0.1620F, {0.0000F, 0.0000F, 0.0000F}, 0.7682F, 0.0880F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+				take_effect_states(effect_context, applied_effect);
+				effect_slot.set_effect(device_, applied_effect.effect_);
+			}
 
-const EffectProps::Reverb ReverbPresets::Default::city = {1.0000F, 0.5000F, 0.3162F, 0.3981F, 1.0000F, 1.4900F, 0.6700F, 1.0000F, 0.0730F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.1427F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			const auto is_suspended = effect_context.is_suspended_.load(std::memory_order_relaxed);
 
-const EffectProps::Reverb ReverbPresets::Default::mountains = {1.0000F, 0.2700F, 0.3162F, 0.0562F, 1.0000F, 1.4900F, 0.2100F, 1.0000F, 0.0407F, 0.3000F, {0.0000F, 0.0000F, 0.0000F}, 0.1919F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			if (effect_slot.is_suspended_ != is_suspended)
+			{
+				effect_slot.is_suspended_ = is_suspended;
+				is_routing_changed = true;
+			}
+		}
 
-const EffectProps::Reverb ReverbPresets::Default::quarry = {1.0000F, 1.0000F, 0.3162F, 0.3162F, 1.0000F, 1.4900F, 0.8300F, 1.0000F, 0.0000F, 0.0610F, {0.0000F, 0.0000F, 0.0000F}, 1.7783F, 0.0250F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 0.7000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		for (auto& source : sources_)
+		{
+			if (is_routing_changed)
+			{
+				source.are_props_changed_ = true;
+			}
 
-const EffectProps::Reverb ReverbPresets::Default::plain = {1.0000F, 0.2100F, 0.3162F, 0.1000F, 1.0000F, 1.4900F, 0.5000F, 1.0000F, 0.0585F, 0.1790F, {0.0000F, 0.0000F, 0.0000F}, 0.1089F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			if (update_send_changes(source.direct_))
+			{
+				source.are_props_changed_ = true;
+			}
 
-const EffectProps::Reverb ReverbPresets::Default::parking_lot = {1.0000F, 1.0000F, 0.3162F, 1.0000F, 1.0000F, 1.6500F, 1.5000F, 1.0000F, 0.2082F, 0.0080F, {0.0000F, 0.0000F, 0.0000F}, 0.2652F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			for (auto& aux_send : source.auxes_)
+			{
+				if (update_send_changes(aux_send))
+				{
+					source.are_props_changed_ = true;
+				}
+			}
+		}
+	}
 
-const EffectProps::Reverb ReverbPresets::Default::sewer_pipe = {0.3071F, 0.8000F, 0.3162F, 0.3162F, 1.0000F, 2.8100F, 0.1400F, 1.0000F, 1.6387F, 0.0140F, {0.0000F, 0.0000F, 0.0000F}, 3.2471F, 0.0210F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+	// Takes the states created by the control up to the applied effect,
+	// and returns the replaced ones to it.
+	//
+	// Called by the mixing.
+	static void take_effect_states(
+		EffectContext& effect_context,
+		const EffectContext::AppliedEffect& applied_effect)
+	{
+		auto& effect_slot = effect_context.effect_slot_;
 
-const EffectProps::Reverb ReverbPresets::Default::underwater = {0.3645F, 1.0000F, 0.3162F, 0.0100F, 1.0000F, 1.4900F, 0.1000F, 1.0000F, 0.5963F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 7.0795F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 1.1800F, 0.3480F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		while (effect_context.taken_effect_state_count_ != applied_effect.effect_state_count_)
+		{
+			auto effect_state = static_cast<EffectState*>(nullptr);
 
-const EffectProps::Reverb ReverbPresets::Default::drugged = {0.4287F, 0.5000F, 0.3162F, 1.0000F, 1.0000F, 8.3900F, 1.3900F, 1.0000F, 0.8760F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 3.1081F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 1.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			// Note: The control queues the states before publishing the effect.
+			effect_context.created_effect_states_.pop(effect_state);
+			effect_context.taken_effect_state_count_ += 1;
 
-const EffectProps::Reverb ReverbPresets::Default::dizzy = {0.3645F, 0.6000F, 0.3162F, 0.6310F, 1.0000F, 17.2300F, 0.5600F, 1.0000F, 0.1392F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.4937F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.8100F, 0.3100F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			// The states of the effect types replaced before the mixing are not used.
+			if (effect_context.taken_effect_state_count_ == applied_effect.effect_state_count_)
+			{
+				effect_state = effect_slot.replace_effect_state(applied_effect.effect_.type_, effect_state);
+			}
 
-const EffectProps::Reverb ReverbPresets::Default::psychotic = {0.0625F, 0.5000F, 0.3162F, 0.8404F, 1.0000F, 7.5600F, 0.9100F, 1.0000F, 0.4864F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 2.4378F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 4.0000F, 1.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			// Note: The control keeps the number of the states within the queue capacity.
+			effect_context.retired_effect_states_.push(effect_state);
+		}
+	}
 
-// Castle
-//
-const EffectProps::Reverb ReverbPresets::Castle::small_room = {1.0000F, 0.8900F, 0.3162F, 0.3981F, 0.1000F, 1.2200F, 0.8300F, 0.3100F, 0.8913F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+	static bool update_send_changes(
+		Source::Send& send)
+	{
+		if (!send.props_handoff_.update())
+		{
+			return false;
+		}
 
-const EffectProps::Reverb ReverbPresets::Castle::short_passage = {1.0000F, 0.8900F, 0.3162F, 0.3162F, 0.1000F, 2.3200F, 0.8300F, 0.3100F, 0.8913F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+		send.props_ = send.props_handoff_.get_front();
 
-const EffectProps::Reverb ReverbPresets::Castle::medium_room = {1.0000F, 0.9300F, 0.3162F, 0.2818F, 0.1000F, 2.0400F, 0.8300F, 0.4600F, 0.6310F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 1.5849F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1550F, 0.0300F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+		return true;
+	}
 
-const EffectProps::Reverb ReverbPresets::Castle::large_room = {1.0000F, 0.8200F, 0.3162F, 0.2818F, 0.1259F, 2.5300F, 0.8300F, 0.5000F, 0.4467F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.1850F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+	// Processes the pending effect slots.
+	//
+	// With several slots and the worker threads available, each slot is processed
+	// in parallel into its own accumulation buffer, and the buffers are added
+	// to the device ones in the slots' order afterwards.
+	void process_effect_slots(
+		const int sample_count)
+	{
+		const auto slot_count = static_cast<int>(pending_effect_slots_.size());
 
-const EffectProps::Reverb ReverbPresets::Castle::long_passage = {1.0000F, 0.8900F, 0.3162F, 0.3981F, 0.1000F, 3.4200F, 0.8300F, 0.3100F, 0.8913F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+		if (slot_count <= 1 || worker_pool_.get_worker_count() == 0)
+		{
+			for (auto effect_slot : pending_effect_slots_)
+			{
+				auto state = effect_slot->effect_state_;
 
-const EffectProps::Reverb ReverbPresets::Castle::hall = {1.0000F, 0.8100F, 0.3162F, 0.2818F, 0.1778F, 3.1400F, 0.7900F, 0.6200F, 0.1778F, 0.0560F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+				RtScope rt_scope{"EffectState::process", EffectStateFactory::get_name_by_type(effect_slot->effect_.type_)};
 
-const EffectProps::Reverb ReverbPresets::Castle::cupboard = {1.0000F, 0.8900F, 0.3162F, 0.2818F, 0.1000F, 0.6700F, 0.8700F, 0.3100F, 1.4125F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 3.5481F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+				state->process(
+					sample_count,
+					effect_slot->wet_buffer_,
+					*state->dst_buffers_,
+					state->dst_channel_count_);
+			}
 
-const EffectProps::Reverb ReverbPresets::Castle::courtyard = {1.0000F, 0.4200F, 0.3162F, 0.4467F, 0.1995F, 2.1300F, 0.6100F, 0.2300F, 0.2239F, 0.1600F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0360F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.3700F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			return;
+		}
 
-const EffectProps::Reverb ReverbPresets::Castle::alcove = {1.0000F, 0.8900F, 0.3162F, 0.5012F, 0.1000F, 1.6400F, 0.8700F, 0.3100F, 1.0000F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 0.1380F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 5168.6001F, 139.5000F, 0.0000F, true, };
+		pending_sample_count_ = sample_count;
 
-// Factory
-//
-const EffectProps::Reverb ReverbPresets::Factory::small_room = {0.3645F, 0.8200F, 0.3162F, 0.7943F, 0.5012F, 1.7200F, 0.6500F, 1.3100F, 0.7079F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.7783F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.1190F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+		worker_pool_.run(slot_count, process_effect_slot_task, this);
 
-const EffectProps::Reverb ReverbPresets::Factory::short_passage = {0.3645F, 0.6400F, 0.2512F, 0.7943F, 0.5012F, 2.5300F, 0.6500F, 1.3100F, 1.0000F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.1350F, 0.2300F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+		for (auto effect_slot : pending_effect_slots_)
+		{
+			for (int c = 0; c < device_.channel_count_; ++c)
+			{
+				MixHelpers::add(
+					effect_slot->output_buffer_[c].data(),
+					device_.sample_buffers_[c].data(),
+					sample_count);
+			}
+		}
+	}
 
-const EffectProps::Reverb ReverbPresets::Factory::medium_room = {0.4287F, 0.8200F, 0.2512F, 0.7943F, 0.5012F, 2.7600F, 0.6500F, 1.3100F, 0.2818F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.1740F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+	static void process_effect_slot_task(
+		void* context,
+		const int task_index)
+	{
+		auto& impl = *static_cast<Impl*>(context);
+		auto& effect_slot = *impl.pending_effect_slots_[task_index];
+		const auto sample_count = impl.pending_sample_count_;
+		auto state = effect_slot.effect_state_;
 
-const EffectProps::Reverb ReverbPresets::Factory::large_room = {0.4287F, 0.7500F, 0.2512F, 0.7079F, 0.6310F, 4.2400F, 0.5100F, 1.3100F, 0.1778F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.2310F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+		RtScope rt_scope{"EffectState::process", EffectStateFactory::get_name_by_type(effect_slot.effect_.type_)};
 
-const EffectProps::Reverb ReverbPresets::Factory::long_passage = {0.3645F, 0.6400F, 0.2512F, 0.7943F, 0.5012F, 4.0600F, 0.6500F, 1.3100F, 1.0000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0370F, {0.0000F, 0.0000F, 0.0000F}, 0.1350F, 0.2300F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+		for (int c = 0; c < state->dst_channel_count_; ++c)
+		{
+			std::fill_n(effect_slot.output_buffer_[c].begin(), sample_count, 0.0F);
+		}
 
-const EffectProps::Reverb ReverbPresets::Factory::hall = {0.4287F, 0.7500F, 0.3162F, 0.7079F, 0.6310F, 7.4300F, 0.5100F, 1.3100F, 0.0631F, 0.0730F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0270F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+		state->process(
+			sample_count,
+			effect_slot.wet_buffer_,
+			effect_slot.output_buffer_,
+			state->dst_channel_count_);
+	}
 
-const EffectProps::Reverb ReverbPresets::Factory::cupboard = {0.3071F, 0.6300F, 0.2512F, 0.7943F, 0.5012F, 0.4900F, 0.6500F, 1.3100F, 1.2589F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.1070F, 0.0700F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
 
-const EffectProps::Reverb ReverbPresets::Factory::courtyard = {0.3071F, 0.5700F, 0.3162F, 0.3162F, 0.6310F, 2.3200F, 0.2900F, 0.5600F, 0.2239F, 0.1400F, {0.0000F, 0.0000F, 0.0000F}, 0.3981F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2900F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+private:
+	struct ChannelMap
+	{
+		ChannelId channel_id_;
+		float angle_;
+		float elevation_;
+	}; // ChannelMap
 
-const EffectProps::Reverb ReverbPresets::Factory::alcove = {0.3645F, 0.5900F, 0.2512F, 0.7943F, 0.5012F, 3.1400F, 0.6500F, 1.3100F, 1.4125F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.1140F, 0.1000F, 0.2500F, 0.0000F, 0.9943F, 3762.6001F, 362.5000F, 0.0000F, true, };
+	static constexpr ChannelMap mono_map[1] =
+	{
+		{ChannelId::front_center, 0.0F, 0.0F, },
+	};
 
-// Ice palace
-//
-const EffectProps::Reverb ReverbPresets::IcePalace::small_room = {1.0000F, 0.8400F, 0.3162F, 0.5623F, 0.2818F, 1.5100F, 1.5300F, 0.2700F, 0.8913F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1640F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+	static constexpr ChannelMap stereo_map[2] =
+	{
+		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
+	};
 
-const EffectProps::Reverb ReverbPresets::IcePalace::short_passage = {1.0000F, 0.7500F, 0.3162F, 0.5623F, 0.2818F, 1.7900F, 1.4600F, 0.2800F, 0.5012F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0190F, {0.0000F, 0.0000F, 0.0000F}, 0.1770F, 0.0900F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+	static constexpr ChannelMap quad_map[4] =
+	{
+		{ChannelId::front_left, Math::deg_to_rad(-45.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_right, Math::deg_to_rad(45.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::back_left, Math::deg_to_rad(-135.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::back_right, Math::deg_to_rad(135.0F), Math::deg_to_rad(0.0F), },
+	};
 
-const EffectProps::Reverb ReverbPresets::IcePalace::medium_room = {1.0000F, 0.8700F, 0.3162F, 0.5623F, 0.4467F, 2.2200F, 1.5300F, 0.3200F, 0.3981F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0270F, {0.0000F, 0.0000F, 0.0000F}, 0.1860F, 0.1200F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+	static constexpr ChannelMap x5_1_map[6] =
+	{
+		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_center, Math::deg_to_rad(0.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::lfe, 0.0F, 0.0F, },
+		{ChannelId::side_left, Math::deg_to_rad(-110.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::side_right, Math::deg_to_rad(110.0F), Math::deg_to_rad(0.0F), },
+	};
 
-const EffectProps::Reverb ReverbPresets::IcePalace::large_room = {1.0000F, 0.8100F, 0.3162F, 0.5623F, 0.4467F, 3.1400F, 1.5300F, 0.3200F, 0.2512F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0270F, {0.0000F, 0.0000F, 0.0000F}, 0.2140F, 0.1100F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+	static constexpr ChannelMap x6_1_map[7] =
+	{
+		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_center, Math::deg_to_rad(0.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::lfe, 0.0F, 0.0F, },
+		{ChannelId::back_center, Math::deg_to_rad(180.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::side_left, Math::deg_to_rad(-90.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::side_right, Math::deg_to_rad(90.0F), Math::deg_to_rad(0.0F), },
+	};
 
-const EffectProps::Reverb ReverbPresets::IcePalace::long_passage = {1.0000F, 0.7700F, 0.3162F, 0.5623F, 0.3981F, 3.0100F, 1.4600F, 0.2800F, 0.7943F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0250F, {0.0000F, 0.0000F, 0.0000F}, 0.1860F, 0.0400F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+	static constexpr ChannelMap x7_1_map[8] =
+	{
+		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::front_center, Math::deg_to_rad(0.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::lfe, 0.0F, 0.0F, },
+		{ChannelId::back_left, Math::deg_to_rad(-150.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::back_right, Math::deg_to_rad(150.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::side_left, Math::deg_to_rad(-90.0F), Math::deg_to_rad(0.0F), },
+		{ChannelId::side_right, Math::deg_to_rad(90.0F), Math::deg_to_rad(0.0F), },
+	};
 
-const EffectProps::Reverb ReverbPresets::IcePalace::hall = {1.0000F, 0.7600F, 0.3162F, 0.4467F, 0.5623F, 5.4900F, 1.5300F, 0.3800F, 0.1122F, 0.0540F, {0.0000F, 0.0000F, 0.0000F}, 0.6310F, 0.0520F, {0.0000F, 0.0000F, 0.0000F}, 0.2260F, 0.1100F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
 
-const EffectProps::Reverb ReverbPresets::IcePalace::cupboard = {1.0000F, 0.8300F, 0.3162F, 0.5012F, 0.2239F, 0.7600F, 1.5300F, 0.2600F, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.1430F, 0.0800F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+	static const float* const* apply_filters(
+		Source::Send::Filters& lp_filter,
+		Source::Send::Filters& hp_filter,
+		const int channel_count,
+		float* const* dst_samples,
+		const float* const* src_samples,
+		const int sample_count,
+		const ActiveFilters filter_type)
+	{
+		switch (filter_type)
+		{
+		case ActiveFilters::none:
+			lp_filter.process_pass_through(channel_count, sample_count, src_samples);
+			hp_filter.process_pass_through(channel_count, sample_count, src_samples);
+			break;
 
-const EffectProps::Reverb ReverbPresets::IcePalace::courtyard = {1.0000F, 0.5900F, 0.3162F, 0.2818F, 0.3162F, 2.0400F, 1.2000F, 0.3800F, 0.3162F, 0.1730F, {0.0000F, 0.0000F, 0.0000F}, 0.3162F, 0.0430F, {0.0000F, 0.0000F, 0.0000F}, 0.2350F, 0.4800F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+		case ActiveFilters::low_pass:
+			lp_filter.process(channel_count, sample_count, src_samples, dst_samples);
+			hp_filter.process_pass_through(channel_count, sample_count, dst_samples);
+			return dst_samples;
 
-const EffectProps::Reverb ReverbPresets::IcePalace::alcove = {1.0000F, 0.8400F, 0.3162F, 0.5623F, 0.2818F, 2.7600F, 1.4600F, 0.2800F, 1.1220F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1610F, 0.0900F, 0.2500F, 0.0000F, 0.9943F, 12428.5000F, 99.6000F, 0.0000F, true, };
+		case ActiveFilters::high_pass:
+			lp_filter.process_pass_through(channel_count, sample_count, src_samples);
+			hp_filter.process(channel_count, sample_count, src_samples, dst_samples);
+			return dst_samples;
 
-// Space station
-//
-const EffectProps::Reverb ReverbPresets::SpaceStation::small_room = {0.2109F, 0.7000F, 0.3162F, 0.7079F, 0.8913F, 1.7200F, 0.8200F, 0.5500F, 0.7943F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0130F, {0.0000F, 0.0000F, 0.0000F}, 0.1880F, 0.2600F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+		case ActiveFilters::band_pass:
+			lp_filter.process(channel_count, sample_count, src_samples, dst_samples);
+			hp_filter.process(channel_count, sample_count, dst_samples, dst_samples);
+			return dst_samples;
+		}
 
-const EffectProps::Reverb ReverbPresets::SpaceStation::short_passage = {0.2109F, 0.8700F, 0.3162F, 0.6310F, 0.8913F, 3.5700F, 0.5000F, 0.5500F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.1720F, 0.2000F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+		return src_samples;
+	}
 
-const EffectProps::Reverb ReverbPresets::SpaceStation::medium_room = {0.2109F, 0.7500F, 0.3162F, 0.6310F, 0.8913F, 3.0100F, 0.5000F, 0.5500F, 0.3981F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0350F, {0.0000F, 0.0000F, 0.0000F}, 0.2090F, 0.3100F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+	bool calc_effect_slot_params(
+		EffectSlot& effect_slot)
+	{
+		if (!effect_slot.is_props_changed_)
+		{
+			return false;
+		}
 
-const EffectProps::Reverb ReverbPresets::SpaceStation::large_room = {0.3645F, 0.8100F, 0.3162F, 0.6310F, 0.8913F, 3.8900F, 0.3800F, 0.6100F, 0.3162F, 0.0560F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0350F, {0.0000F, 0.0000F, 0.0000F}, 0.2330F, 0.2800F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+		effect_slot.is_props_changed_ = false;
 
-const EffectProps::Reverb ReverbPresets::SpaceStation::long_passage = {0.4287F, 0.8200F, 0.3162F, 0.6310F, 0.8913F, 4.6200F, 0.6200F, 0.5500F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0310F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2300F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+		RtScope rt_scope{"EffectState::update", EffectStateFactory::get_name_by_type(effect_slot.effect_.type_)};
 
-const EffectProps::Reverb ReverbPresets::SpaceStation::hall = {0.4287F, 0.8700F, 0.3162F, 0.6310F, 0.8913F, 7.1100F, 0.3800F, 0.6100F, 0.1778F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.6310F, 0.0470F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2500F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+		effect_slot.effect_state_->update(device_, effect_slot, effect_slot.effect_.props_);
 
-const EffectProps::Reverb ReverbPresets::SpaceStation::cupboard = {0.1715F, 0.5600F, 0.3162F, 0.7079F, 0.8913F, 0.7900F, 0.8100F, 0.5500F, 1.4125F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.7783F, 0.0180F, {0.0000F, 0.0000F, 0.0000F}, 0.1810F, 0.3100F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+		effect_slot.tail_sample_count_ = effect_slot.effect_state_->get_tail_sample_count();
 
-const EffectProps::Reverb ReverbPresets::SpaceStation::alcove = {0.2109F, 0.7800F, 0.3162F, 0.7079F, 0.8913F, 1.1600F, 0.8100F, 0.5500F, 1.4125F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0180F, {0.0000F, 0.0000F, 0.0000F}, 0.1920F, 0.2100F, 0.2500F, 0.0000F, 0.9943F, 3316.1001F, 458.2000F, 0.0000F, true, };
+		if (effect_slot.remaining_tail_sample_count_ > 0)
+		{
+			effect_slot.remaining_tail_sample_count_ = effect_slot.tail_sample_count_;
+		}
 
-// Wooden galeon
-//
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::small_room = {1.0000F, 1.0000F, 0.3162F, 0.1122F, 0.3162F, 0.7900F, 0.3200F, 0.8700F, 1.0000F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+		return true;
+	}
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::short_passage = {1.0000F, 1.0000F, 0.3162F, 0.1259F, 0.3162F, 1.7500F, 0.5000F, 0.8700F, 0.8913F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.6310F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+	bool calc_source_params(
+		Source& source)
+	{
+		if (!source.are_props_changed_)
+		{
+			return false;
+		}
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::medium_room = {1.0000F, 1.0000F, 0.3162F, 0.1000F, 0.2818F, 1.4700F, 0.4200F, 0.8200F, 0.8913F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+		source.are_props_changed_ = false;
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::large_room = {1.0000F, 1.0000F, 0.3162F, 0.0891F, 0.2818F, 2.6500F, 0.3300F, 0.8200F, 0.8913F, 0.0660F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+		return true;
+	}
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::long_passage = {1.0000F, 1.0000F, 0.3162F, 0.1000F, 0.3162F, 1.9900F, 0.4000F, 0.7900F, 1.0000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.4467F, 0.0360F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+	void calc_panning_and_filters(
+		Source& source,
+		const float distance,
+		const float* dir,
+		const float spread,
+		const float dry_gain,
+		const float dry_gain_hf,
+		const float dry_gain_lf,
+		const WetGains& wet_gain,
+		const WetGains& wet_gain_lf,
+		const WetGains& wet_gain_hf)
+	{
+		static_cast<void>(distance);
+		static_cast<void>(dir);
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::hall = {1.0000F, 1.0000F, 0.3162F, 0.0794F, 0.2818F, 3.4500F, 0.3000F, 0.8200F, 0.8913F, 0.0880F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0630F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+		const auto frequency = device_.sampling_rate_;
+		const ChannelMap* channel_map = nullptr;
+		auto channel_count = 0;
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::cupboard = {1.0000F, 1.0000F, 0.3162F, 0.1413F, 0.3162F, 0.5600F, 0.4600F, 0.9100F, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0280F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+		switch (device_.channel_format_)
+		{
+		case ChannelFormat::mono:
+			channel_map = mono_map;
+			channel_count = 1;
+			break;
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::courtyard = {1.0000F, 0.6500F, 0.3162F, 0.0794F, 0.3162F, 1.7900F, 0.3500F, 0.7900F, 0.5623F, 0.1230F, {0.0000F, 0.0000F, 0.0000F}, 0.1000F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+		case ChannelFormat::stereo:
+			channel_map = stereo_map;
+			channel_count = 2;
+			break;
 
-const EffectProps::Reverb ReverbPresets::WoodenGaleon::alcove = {1.0000F, 1.0000F, 0.3162F, 0.1259F, 0.3162F, 1.2200F, 0.6200F, 0.9100F, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 4705.0000F, 99.6000F, 0.0000F, true, };
+		case ChannelFormat::quad:
+			channel_map = quad_map;
+			channel_count = 4;
+			break;
 
-// Sports
-//
-const EffectProps::Reverb ReverbPresets::Sports::empty_stadium = {1.0000F, 1.0000F, 0.3162F, 0.4467F, 0.7943F, 6.2600F, 0.5100F, 1.1000F, 0.0631F, 0.1830F, {0.0000F, 0.0000F, 0.0000F}, 0.3981F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		case ChannelFormat::five_point_one:
+			channel_map = x5_1_map;
+			channel_count = 6;
+			break;
 
-const EffectProps::Reverb ReverbPresets::Sports::squash_court = {1.0000F, 0.7500F, 0.3162F, 0.3162F, 0.7943F, 2.2200F, 0.9100F, 1.1600F, 0.4467F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.1260F, 0.1900F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+		case ChannelFormat::six_point_one:
+			channel_map = x6_1_map;
+			channel_count = 7;
+			break;
 
-const EffectProps::Reverb ReverbPresets::Sports::small_swimming_pool = {1.0000F, 0.7000F, 0.3162F, 0.7943F, 0.8913F, 2.7600F, 1.2500F, 1.1400F, 0.6310F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1790F, 0.1500F, 0.8950F, 0.1900F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+		case ChannelFormat::seven_point_one:
+			channel_map = x7_1_map;
+			channel_count = 8;
+			break;
 
-const EffectProps::Reverb ReverbPresets::Sports::large_swimming_pool = {1.0000F, 0.8200F, 0.3162F, 0.7943F, 1.0000F, 5.4900F, 1.3100F, 1.1400F, 0.4467F, 0.0390F, {0.0000F, 0.0000F, 0.0000F}, 0.5012F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2220F, 0.5500F, 1.1590F, 0.2100F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+		case ChannelFormat::none:
+		default:
+			break;
+		}
 
-const EffectProps::Reverb ReverbPresets::Sports::gymnasium = {1.0000F, 0.8100F, 0.3162F, 0.4467F, 0.8913F, 3.1400F, 1.0600F, 1.3500F, 0.3981F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.5623F, 0.0450F, {0.0000F, 0.0000F, 0.0000F}, 0.1460F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+		// Non-HRTF rendering. Use normal panning to the output.
+		for (int c = 0; c < channel_count; ++c)
+		{
+			AmbiCoeffs coeffs;
 
-const EffectProps::Reverb ReverbPresets::Sports::full_stadium = {1.0000F, 1.0000F, 0.3162F, 0.0708F, 0.7943F, 5.2500F, 0.1700F, 0.8000F, 0.1000F, 0.1880F, {0.0000F, 0.0000F, 0.0000F}, 0.2818F, 0.0380F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			// Special-case LFE
+			if (channel_map[c].channel_id_ == ChannelId::lfe)
+			{
+				source.direct_.channels_[c].target_gains_.fill(0.0F);
 
-const EffectProps::Reverb ReverbPresets::Sports::stadium_tannoy = {1.0000F, 0.7800F, 0.3162F, 0.5623F, 0.5012F, 2.5300F, 0.8800F, 0.6800F, 0.2818F, 0.2300F, {0.0000F, 0.0000F, 0.0000F}, 0.5012F, 0.0630F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+				const auto idx = device_.get_channel_index(channel_map[c].channel_id_);
 
-// Prefab
-//
-const EffectProps::Reverb ReverbPresets::Prefab::workshop = {0.4287F, 1.0000F, 0.3162F, 0.1413F, 0.3981F, 0.7600F, 1.0000F, 1.0000F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+				if (idx != -1)
+				{
+					source.direct_.channels_[c].target_gains_[idx] = dry_gain;
+				}
 
-const EffectProps::Reverb ReverbPresets::Prefab::school_room = {0.4022F, 0.6900F, 0.3162F, 0.6310F, 0.5012F, 0.9800F, 0.4500F, 0.1800F, 1.4125F, 0.0170F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.0950F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+				for (auto& aux : source.auxes_)
+				{
+					aux.channels_[c].target_gains_.fill(0.0F);
+				}
 
-const EffectProps::Reverb ReverbPresets::Prefab::practise_room = {0.4022F, 0.8700F, 0.3162F, 0.3981F, 0.5012F, 1.1200F, 0.5600F, 0.1800F, 1.2589F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0110F, {0.0000F, 0.0000F, 0.0000F}, 0.0950F, 0.1400F, 0.2500F, 0.0000F, 0.9943F, 7176.8999F, 211.2000F, 0.0000F, true, };
+				continue;
+			}
 
-const EffectProps::Reverb ReverbPresets::Prefab::outhouse = {1.0000F, 0.8200F, 0.3162F, 0.1122F, 0.1585F, 1.3800F, 0.3800F, 0.3500F, 0.8913F, 0.0240F, {0.0000F, 0.0000F, -0.0000F}, 0.6310F, 0.0440F, {0.0000F, 0.0000F, 0.0000F}, 0.1210F, 0.1700F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+			Panning::calc_angle_coeffs(channel_map[c].angle_, channel_map[c].elevation_, spread, coeffs);
 
-const EffectProps::Reverb ReverbPresets::Prefab::caravan = {1.0000F, 1.0000F, 0.3162F, 0.0891F, 0.1259F, 0.4300F, 1.5000F, 1.0000F, 1.0000F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 1.9953F, 0.0120F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			Panning::compute_panning_gains(
+				device_.channel_count_,
+				device_.dry_,
+				coeffs,
+				dry_gain,
+				source.direct_.channels_[c].target_gains_);
 
-// Dome
-//
-const EffectProps::Reverb ReverbPresets::Dome::tomb = {1.0000F, 0.7900F, 0.3162F, 0.3548F, 0.2239F, 4.1800F, 0.2100F, 0.1000F, 0.3868F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 1.6788F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.1770F, 0.1900F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, false, };
-const EffectProps::Reverb ReverbPresets::Dome::saint_pauls = {1.0000F, 0.8700F, 0.3162F, 0.3548F, 0.2239F, 10.4800F, 0.1900F, 0.1000F, 0.1778F, 0.0900F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0420F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.1200F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, true, };
+			for (int i = 0; i < effect_count_; ++i)
+			{
+				Panning::compute_panning_gains_bf(
+					max_effect_channels,
+					coeffs,
+					wet_gain[i],
+					source.auxes_[i].channels_[c].target_gains_);
+			}
+		}
 
-// Pipe
-//
-const EffectProps::Reverb ReverbPresets::Pipe::small = {1.0000F, 1.0000F, 0.3162F, 0.3548F, 0.2239F, 5.0400F, 0.1000F, 0.1000F, 0.5012F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 2.5119F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, true, };
+		const auto hf_scale = SendProps::hp_frequency_reference / frequency;
+		const auto lf_scale = SendProps::lp_frequency_reference / frequency;
+		auto gain_hf = std::max(dry_gain_hf, 0.001F); // Limit -60dB
+		auto gain_lf = std::max(dry_gain_lf, 0.001F);
 
-const EffectProps::Reverb ReverbPresets::Pipe::long_thin = {0.2560F, 0.9100F, 0.3162F, 0.4467F, 0.2818F, 9.2100F, 0.1800F, 0.1000F, 0.7079F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, false, };
+		source.direct_.filter_type_ = ActiveFilters::none;
 
-const EffectProps::Reverb ReverbPresets::Pipe::large = {1.0000F, 1.0000F, 0.3162F, 0.3548F, 0.2239F, 8.4500F, 0.1000F, 0.1000F, 0.3981F, 0.0460F, {0.0000F, 0.0000F, 0.0000F}, 1.5849F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, true, };
+		if (gain_hf != 1.0F)
+		{
+			source.direct_.filter_type_ = static_cast<ActiveFilters>(
+				static_cast<int>(source.direct_.filter_type_) | static_cast<int>(ActiveFilters::low_pass));
+		}
 
-const EffectProps::Reverb ReverbPresets::Pipe::resonant = {0.1373F, 0.9100F, 0.3162F, 0.4467F, 0.2818F, 6.8100F, 0.1800F, 0.1000F, 0.7079F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.0000F, 0.0220F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 20.0000F, 0.0000F, false, };
+		if (gain_lf != 1.0F)
+		{
+			source.direct_.filter_type_ = static_cast<ActiveFilters>(
+				static_cast<int>(source.direct_.filter_type_) | static_cast<int>(ActiveFilters::high_pass));
+		}
 
-// Outdoors
-//
-const EffectProps::Reverb ReverbPresets::Outdoors::backyard = {1.0000F, 0.4500F, 0.3162F, 0.2512F, 0.5012F, 1.1200F, 0.3400F, 0.4600F, 0.4467F, 0.0690F, {0.0000F, 0.0000F, -0.0000F}, 0.7079F, 0.0230F, {0.0000F, 0.0000F, 0.0000F}, 0.2180F, 0.3400F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+		FilterState filter;
 
-const EffectProps::Reverb ReverbPresets::Outdoors::rolling_plains = {1.0000F, 0.0000F, 0.3162F, 0.0112F, 0.6310F, 2.1300F, 0.2100F, 0.4600F, 0.1778F, 0.3000F, {0.0000F, 0.0000F, -0.0000F}, 0.4467F, 0.0190F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+		filter.set_params(
+			FilterType::high_shelf,
+			gain_hf,
+			hf_scale,
+			FilterState::calc_rcp_q_from_slope(gain_hf, 1.0F));
 
-const EffectProps::Reverb ReverbPresets::Outdoors::deep_canyon = {1.0000F, 0.7400F, 0.3162F, 0.1778F, 0.6310F, 3.8900F, 0.2100F, 0.4600F, 0.3162F, 0.2230F, {0.0000F, 0.0000F, -0.0000F}, 0.3548F, 0.0190F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+		source.direct_.low_pass_.copy_params(filter);
 
-const EffectProps::Reverb ReverbPresets::Outdoors::creek = {1.0000F, 0.3500F, 0.3162F, 0.1778F, 0.5012F, 2.1300F, 0.2100F, 0.4600F, 0.3981F, 0.1150F, {0.0000F, 0.0000F, -0.0000F}, 0.1995F, 0.0310F, {0.0000F, 0.0000F, 0.0000F}, 0.2180F, 0.3400F, 0.2500F, 0.0000F, 0.9943F, 4399.1001F, 242.9000F, 0.0000F, false, };
+		filter.set_params(
+			FilterType::low_shelf,
+			gain_lf,
+			lf_scale,
+			FilterState::calc_rcp_q_from_slope(gain_lf, 1.0F));
 
-const EffectProps::Reverb ReverbPresets::Outdoors::valley = {1.0000F, 0.2800F, 0.3162F, 0.0282F, 0.1585F, 2.8800F, 0.2600F, 0.3500F, 0.1413F, 0.2630F, {0.0000F, 0.0000F, -0.0000F}, 0.3981F, 0.1000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.3400F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+		source.direct_.high_pass_.copy_params(filter);
 
-// Mood
-//
-const EffectProps::Reverb ReverbPresets::Mood::heaven = {1.0000F, 0.9400F, 0.3162F, 0.7943F, 0.4467F, 5.0400F, 1.1200F, 0.5600F, 0.2427F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0290F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0800F, 2.7420F, 0.0500F, 0.9977F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		for (int i = 0; i < effect_count_; ++i)
+		{
+			auto& aux = source.auxes_[i];
+			gain_hf = std::max(wet_gain_hf[i], 0.001F);
+			gain_lf = std::max(wet_gain_lf[i], 0.001F);
 
-const EffectProps::Reverb ReverbPresets::Mood::hell = {1.0000F, 0.5700F, 0.3162F, 0.3548F, 0.4467F, 3.5700F, 0.4900F, 2.0000F, 0.0000F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1100F, 0.0400F, 2.1090F, 0.5200F, 0.9943F, 5000.0000F, 139.5000F, 0.0000F, false, };
+			aux.filter_type_ = ActiveFilters::none;
 
-const EffectProps::Reverb ReverbPresets::Mood::memory = {1.0000F, 0.8500F, 0.3162F, 0.6310F, 0.3548F, 4.0600F, 0.8200F, 0.5600F, 0.0398F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 1.1220F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.4740F, 0.4500F, 0.9886F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			if (gain_hf != 1.0F)
+			{
+				aux.filter_type_ = static_cast<ActiveFilters>(
+					static_cast<int>(aux.filter_type_) | static_cast<int>(ActiveFilters::low_pass));
+			}
 
-// Driving
-//
-const EffectProps::Reverb ReverbPresets::Driving::commentator = {1.0000F, 0.0000F, 0.3162F, 0.5623F, 0.5012F, 2.4200F, 0.8800F, 0.6800F, 0.1995F, 0.0930F, {0.0000F, 0.0000F, 0.0000F}, 0.2512F, 0.0170F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 1.0000F, 0.2500F, 0.0000F, 0.9886F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			if (gain_lf != 1.0F)
+			{
+				aux.filter_type_ = static_cast<ActiveFilters>(
+					static_cast<int>(aux.filter_type_) | static_cast<int>(ActiveFilters::high_pass));
+			}
 
-const EffectProps::Reverb ReverbPresets::Driving::pit_garage = {0.4287F, 0.5900F, 0.3162F, 0.7079F, 0.5623F, 1.7200F, 0.9300F, 0.8700F, 0.5623F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0160F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.1100F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, false, };
+			filter.set_params(
+				FilterType::high_shelf,
+				gain_hf,
+				hf_scale,
+				FilterState::calc_rcp_q_from_slope(gain_hf, 1.0F));
 
-const EffectProps::Reverb ReverbPresets::Driving::incar_racer = {0.0832F, 0.8000F, 0.3162F, 1.0000F, 0.7943F, 0.1700F, 2.0000F, 0.4100F, 1.7783F, 0.0070F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0150F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10268.2002F, 251.0000F, 0.0000F, true, };
+			aux.low_pass_.copy_params(filter);
 
-const EffectProps::Reverb ReverbPresets::Driving::incar_sports = {0.0832F, 0.8000F, 0.3162F, 0.6310F, 1.0000F, 0.1700F, 0.7500F, 0.4100F, 1.0000F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.5623F, 0.0000F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10268.2002F, 251.0000F, 0.0000F, true, };
+			filter.set_params(
+				FilterType::low_shelf,
+				gain_lf,
+				lf_scale,
+				FilterState::calc_rcp_q_from_slope(gain_lf, 1.0F));
 
-const EffectProps::Reverb ReverbPresets::Driving::incar_luxury = {0.2560F, 1.0000F, 0.3162F, 0.1000F, 0.5012F, 0.1300F, 0.4100F, 0.4600F, 0.7943F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 1.5849F, 0.0100F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10268.2002F, 251.0000F, 0.0000F, true, };
+			aux.high_pass_.copy_params(filter);
+		}
+	}
 
-const EffectProps::Reverb ReverbPresets::Driving::full_grand_stand = {1.0000F, 1.0000F, 0.3162F, 0.2818F, 0.6310F, 3.0100F, 1.3700F, 1.2800F, 0.3548F, 0.0900F, {0.0000F, 0.0000F, 0.0000F}, 0.1778F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10420.2002F, 250.0000F, 0.0000F, false, };
+	void calc_non_attn_source_params(
+		Source& source)
+	{
+		source.direct_.buffers_ = &device_.sample_buffers_;
+		source.direct_.channel_count_ = device_.channel_count_;
 
-const EffectProps::Reverb ReverbPresets::Driving::empty_grand_stand = {1.0000F, 1.0000F, 0.3162F, 1.0000F, 0.7943F, 4.6200F, 1.7500F, 1.4000F, 0.2082F, 0.0900F, {0.0000F, 0.0000F, 0.0000F}, 0.2512F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.0000F, 0.9943F, 10420.2002F, 250.0000F, 0.0000F, false, };
+		for (int i = 0; i < effect_count_; ++i)
+		{
+			auto& aux = source.auxes_[i];
 
-const EffectProps::Reverb ReverbPresets::Driving::tunnel = {1.0000F, 0.8100F, 0.3162F, 0.3981F, 0.8913F, 3.4200F, 0.9400F, 1.3100F, 0.7079F, 0.0510F, {0.0000F, 0.0000F, 0.0000F}, 0.7079F, 0.0470F, {0.0000F, 0.0000F, 0.0000F}, 0.2140F, 0.0500F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 155.3000F, 0.0000F, true, };
+			const auto& effect_slot = effect_contexts_[i].effect_slot_;
 
-// City
-//
-const EffectProps::Reverb ReverbPresets::City::streets = {1.0000F, 0.7800F, 0.3162F, 0.7079F, 0.8913F, 1.7900F, 1.1200F, 0.9100F, 0.2818F, 0.0460F, {0.0000F, 0.0000F, 0.0000F}, 0.1995F, 0.0280F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2000F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			const auto is_routed =
+				!effect_slot.is_suspended_ &&
+				effect_slot.effect_.type_ != EffectType::null &&
+				aux.props_.gain_ > silence_threshold_gain;
 
-const EffectProps::Reverb ReverbPresets::City::subway = {1.0000F, 0.7400F, 0.3162F, 0.7079F, 0.8913F, 3.0100F, 1.2300F, 0.9100F, 0.7079F, 0.0460F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0280F, {0.0000F, 0.0000F, 0.0000F}, 0.1250F, 0.2100F, 0.2500F, 0.0000F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+			if (!is_routed)
+			{
+				aux.buffers_ = nullptr;
+				aux.channel_count_ = 0;
+			}
+			else
+			{
+				if (!aux.buffers_)
+				{
+					// The filters were not running while the send was idle.
+					aux.low_pass_.clear();
+					aux.high_pass_.clear();
+				}
 
-const EffectProps::Reverb ReverbPresets::City::museum = {1.0000F, 0.8200F, 0.3162F, 0.1778F, 0.1778F, 3.2800F, 1.4000F, 0.5700F, 0.2512F, 0.0390F, {0.0000F, 0.0000F, -0.0000F}, 0.8913F, 0.0340F, {0.0000F, 0.0000F, 0.0000F}, 0.1300F, 0.1700F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+				aux.buffers_ = &effect_contexts_[i].effect_slot_.wet_buffer_;
+				aux.channel_count_ = max_effect_channels;
+			}
+		}
 
-const EffectProps::Reverb ReverbPresets::City::library = {1.0000F, 0.8200F, 0.3162F, 0.2818F, 0.0891F, 2.7600F, 0.8900F, 0.4100F, 0.3548F, 0.0290F, {0.0000F, 0.0000F, -0.0000F}, 0.8913F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 0.1300F, 0.1700F, 0.2500F, 0.0000F, 0.9943F, 2854.3999F, 107.5000F, 0.0000F, false, };
+		// Calculate gains
+		const auto dry_gain = std::min(source.direct_.props_.gain_, max_mix_gain);
+		const auto dry_gain_hf = source.direct_.props_.gain_hf_;
+		const auto dry_gain_lf = source.direct_.props_.gain_lf_;
 
-const EffectProps::Reverb ReverbPresets::City::underpass = {1.0000F, 0.8200F, 0.3162F, 0.4467F, 0.8913F, 3.5700F, 1.1200F, 0.9100F, 0.3981F, 0.0590F, {0.0000F, 0.0000F, 0.0000F}, 0.8913F, 0.0370F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.1400F, 0.2500F, 0.0000F, 0.9920F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		constexpr float dir[3] = {0.0F, 0.0F, -1.0F};
 
-const EffectProps::Reverb ReverbPresets::City::abandoned = {1.0000F, 0.6900F, 0.3162F, 0.7943F, 0.8913F, 3.2800F, 1.1700F, 0.9100F, 0.4467F, 0.0440F, {0.0000F, 0.0000F, 0.0000F}, 0.2818F, 0.0240F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.2000F, 0.2500F, 0.0000F, 0.9966F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		auto wet_gain = WetGains{};
+		auto wet_gain_hf = WetGains{};
+		auto wet_gain_lf = WetGains{};
 
-// Misc
-//
-const EffectProps::Reverb ReverbPresets::Misc::dusty_room = {0.3645F, 0.5600F, 0.3162F, 0.7943F, 0.7079F, 1.7900F, 0.3800F, 0.2100F, 0.5012F, 0.0020F, {0.0000F, 0.0000F, 0.0000F}, 1.2589F, 0.0060F, {0.0000F, 0.0000F, 0.0000F}, 0.2020F, 0.0500F, 0.2500F, 0.0000F, 0.9886F, 13046.0000F, 163.3000F, 0.0000F, true, };
+		for (int i = 0; i < effect_count_; ++i)
+		{
+			wet_gain[i] = std::min(source.auxes_[i].props_.gain_, max_mix_gain);
+			wet_gain_hf[i] = source.auxes_[i].props_.gain_hf_;
+			wet_gain_lf[i] = source.auxes_[i].props_.gain_lf_;
+		}
 
-const EffectProps::Reverb ReverbPresets::Misc::chapel = {1.0000F, 0.8400F, 0.3162F, 0.5623F, 1.0000F, 4.6200F, 0.6400F, 1.2300F, 0.4467F, 0.0320F, {0.0000F, 0.0000F, 0.0000F}, 0.7943F, 0.0490F, {0.0000F, 0.0000F, 0.0000F}, 0.2500F, 0.0000F, 0.2500F, 0.1100F, 0.9943F, 5000.0000F, 250.0000F, 0.0000F, true, };
+		calc_panning_and_filters(
+			source,
+			0.0F,
+			dir,
+			0.0F,
+			dry_gain,
+			dry_gain_hf,
+			dry_gain_lf,
+			wet_gain,
+			wet_gain_lf,
+			wet_gain_hf);
+	}
 
-const EffectProps::Reverb ReverbPresets::Misc::small_water_room = {1.0000F, 0.7000F, 0.3162F, 0.4477F, 1.0000F, 1.5100F, 1.2500F, 1.1400F, 0.8913F, 0.0200F, {0.0000F, 0.0000F, 0.0000F}, 1.4125F, 0.0300F, {0.0000F, 0.0000F, 0.0000F}, 0.1790F, 0.1500F, 0.8950F, 0.1900F, 0.9920F, 5000.0000F, 250.0000F, 0.0000F, false, };
+	// Marks effect slots with a non-silent send or with a remaining tail as active.
+	template<typename TReader>
+	void update_effect_slots_activity(
+		const TReader& reader)
+	{
+		const auto source_count = static_cast<int>(sources_.size());
 
-// Reverb presets
-// ==========================================================================
+		for (int i = 0; i < effect_count_; ++i)
+		{
+			auto& effect_slot = effect_contexts_[i].effect_slot_;
 
+			auto is_fed = false;
 
-class EffectState
-{
-public:
-	EffectState(
-		const EffectState& that) = delete;
+			for (int j = 0; j < source_count && !is_fed; ++j)
+			{
+				is_fed = reader.has_source(j) && sources_[j].auxes_[i].buffers_;
+			}
 
-	EffectState& operator=(
-		const EffectState& that) = delete;
+			effect_slot.is_fed_ = is_fed;
 
-	virtual ~EffectState()
-	{
+			effect_slot.is_active_ =
+				!effect_slot.is_suspended_ &&
+				effect_slot.effect_.type_ != EffectType::null &&
+				(is_fed || effect_slot.remaining_tail_sample_count_ > 0);
+		}
 	}
 
+	// Decides whether to process the active effect slot, and advances its tail.
+	//
+	// Returns true if the slot should be processed or false otherwise.
+	static bool update_effect_slot_tail(
+		EffectSlot& effect_slot,
+		const int sample_count)
+	{
+		const auto is_input_silent =
+			!effect_slot.is_fed_ ||
+			is_silent(effect_slot.wet_buffer_, max_effect_channels, sample_count);
 
-	SampleBuffers* dst_buffers_;
-	int dst_channel_count_;
+		if (!is_input_silent)
+		{
+			effect_slot.remaining_tail_sample_count_ = effect_slot.tail_sample_count_;
+			return true;
+		}
 
+		auto& remaining_count = effect_slot.remaining_tail_sample_count_;
 
-	void construct()
-	{
-		do_construct();
-	}
+		if (remaining_count == 0)
+		{
+			return false;
+		}
 
-	void destruct()
-	{
-		do_destruct();
-	}
+		if (remaining_count != EffectState::infinite_tail_sample_count)
+		{
+			remaining_count = std::max(remaining_count - sample_count, 0);
+		}
 
-	void update_device(
-		Device& device)
-	{
-		do_update_device(device);
+		return true;
 	}
 
-	void update(
-		Device& device,
-		const EffectSlot& effect_slot,
-		const EffectProps& props)
+	static bool is_silent(
+		const SampleBuffers& buffers,
+		const int channel_count,
+		const int sample_count)
 	{
-		do_update(device, effect_slot, props);
-	}
+		for (int c = 0; c < channel_count; ++c)
+		{
+			const auto& buffer = buffers[c];
 
-	void process(
-		int sample_count,
-		const SampleBuffers& src_samples,
-		SampleBuffers& dst_samples,
-		const int channel_count)
-	{
-		do_process(sample_count, src_samples, dst_samples, channel_count);
+			for (int i = 0; i < sample_count; ++i)
+			{
+				if (std::abs(buffer[i]) > silence_threshold_gain)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
 	}
 
-	static void destroy(
-		EffectState*& effect_state)
+	void update_context_sources()
 	{
-		if (!effect_state)
+		auto is_props_updated = false;
+
+		for (auto& effect_context : effect_contexts_)
 		{
-			return;
+			is_props_updated |= calc_effect_slot_params(effect_context.effect_slot_);
 		}
 
-		effect_state->destruct();
-		delete effect_state;
-		effect_state = nullptr;
+		for (auto& source : sources_)
+		{
+			if (calc_source_params(source) || is_props_updated)
+			{
+				calc_non_attn_source_params(source);
+			}
+		}
 	}
+}; // Impl
 
 
-protected:
-	EffectState()
-		:
-		dst_buffers_{},
-		dst_channel_count_{}
-	{
-	}
+constexpr std::size_t Api::Impl::memory_header_size;
 
+constexpr Api::Impl::ChannelMap Api::Impl::mono_map[1];
+constexpr Api::Impl::ChannelMap Api::Impl::stereo_map[2];
+constexpr Api::Impl::ChannelMap Api::Impl::quad_map[4];
+constexpr Api::Impl::ChannelMap Api::Impl::x5_1_map[6];
+constexpr Api::Impl::ChannelMap Api::Impl::x6_1_map[7];
+constexpr Api::Impl::ChannelMap Api::Impl::x7_1_map[8];
 
-	virtual void do_construct() = 0;
+// Api::Impl
+// ==========================================================================
 
-	virtual void do_destruct() = 0;
 
-	virtual void do_update_device(
-		Device& device) = 0;
+// ==========================================================================
+// Api
 
-	virtual void do_update(
-		Device& device,
-		const EffectSlot& effect_slot,
-		const EffectProps& props) = 0;
+struct ApiErrorMessages
+{
+	static constexpr auto no_error = "";
+	static constexpr auto allocate_impl = "Failed to allocate implementaion class.";
+	static constexpr auto not_initialized = "Not initialized.";
+	static constexpr auto effect_index_out_of_range = "Effect index is out of range.";
+	static constexpr auto source_index_out_of_range = "Source index is out of range.";
+	static constexpr auto no_src_samples = "No source samples.";
+	static constexpr auto no_dst_samples = "No destination samples.";
+	static constexpr auto sample_offset_out_of_range = "Sample offset is out of range.";
+}; // ApiErrorMessages
 
-	virtual void do_process(
-		const int sample_count,
-		const SampleBuffers& src_samples,
-		SampleBuffers& dst_samples,
-		const int channel_count) = 0;
-}; // EffectState
 
-class EffectStateFactory
+constexpr const char* ApiErrorMessages::no_error;
+constexpr const char* ApiErrorMessages::allocate_impl;
+constexpr const char* ApiErrorMessages::not_initialized;
+constexpr const char* ApiErrorMessages::effect_index_out_of_range;
+constexpr const char* ApiErrorMessages::source_index_out_of_range;
+constexpr const char* ApiErrorMessages::no_src_samples;
+constexpr const char* ApiErrorMessages::no_dst_samples;
+constexpr const char* ApiErrorMessages::sample_offset_out_of_range;
+
+
+Api::Api()
+	:
+	pimpl_{},
+	error_message_{ApiErrorMessages::no_error}
 {
-public:
-	static EffectState* create_by_type(
-		const EffectType type)
-	{
-		switch (type)
-		{
-		case EffectType::null:
-			return create_null();
+}
 
-		case EffectType::chorus:
-			return create_chorus();
+Api::~Api()
+{
+	uninitialize();
+}
 
-		case EffectType::compressor:
-			return create_compressor();
+bool Api::initialize(
+	const ChannelFormat channel_format,
+	const int sampling_rate,
+	const int effect_count)
+{
+	auto init_params = InitParams{};
+	init_params.set_defaults();
+	init_params.channel_format_ = channel_format;
+	init_params.sampling_rate_ = sampling_rate;
+	init_params.effect_count_ = effect_count;
 
-		case EffectType::dedicated_dialog:
-		case EffectType::dedicated_low_frequency:
-			return create_dedicated();
+	return initialize(init_params);
+}
 
-		case EffectType::distortion:
-			return create_distortion();
+bool Api::initialize(
+	const InitParams& init_params)
+{
+	uninitialize();
 
-		case EffectType::echo:
-			return create_echo();
+	const auto memory_resource = init_params.memory_resource_ ?
+		init_params.memory_resource_ : MemoryResource::get_default();
 
-		case EffectType::equalizer:
-			return create_equalizer();
+	pimpl_.reset(new (*memory_resource, std::nothrow) Impl{*memory_resource});
 
-		case EffectType::flanger:
-			return create_flanger();
+	if (!pimpl_)
+	{
+		error_message_ = ApiErrorMessages::allocate_impl;
+		return false;
+	}
 
-		case EffectType::eax_reverb:
-		case EffectType::reverb:
-			return create_reverb();
+	const auto initialize_result = pimpl_->initialize(init_params);
 
-		case EffectType::ring_modulator:
-			return create_ring_modulator();
+	if (!initialize_result)
+	{
+		error_message_ = pimpl_->error_message_;
+		uninitialize();
+	}
+
+	return initialize_result;
+}
+
+bool Api::is_initialized() const
+{
+	return pimpl_ != nullptr;
+}
 
-		default:
-			return nullptr;
-		}
+int Api::get_sampling_rate() const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return 0;
 	}
 
+	return pimpl_->device_.sampling_rate_;
+}
 
-private:
-	static EffectState* create_null();
-	static EffectState* create_chorus();
-	static EffectState* create_compressor();
-	static EffectState* create_dedicated();
-	static EffectState* create_distortion();
-	static EffectState* create_echo();
-	static EffectState* create_equalizer();
-	static EffectState* create_flanger();
-	static EffectState* create_reverb();
-	static EffectState* create_ring_modulator();
+ChannelFormat Api::get_channel_format() const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return ChannelFormat::none;
+	}
 
+	return pimpl_->device_.channel_format_;
+}
 
-	template<typename T>
-	static EffectState* create()
+int Api::get_channel_count() const
+{
+	if (!is_initialized())
 	{
-		auto result = static_cast<EffectState*>(new (std::nothrow) T{});
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-		if (result)
-		{
-			result->construct();
-		}
+	return pimpl_->device_.channel_count_;
+}
 
-		return result;
+int Api::get_effect_count() const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
-}; // EffectStateFactory
 
-struct EffectStateDeleter
+	return pimpl_->effect_count_;
+}
+
+int Api::get_source_count() const
 {
-	void operator()(
-		EffectState* effect_state)
+	if (!is_initialized())
 	{
-		if (!effect_state)
-		{
-			return;
-		}
-
-		effect_state->destruct();
-		delete effect_state;
+		error_message_ = ApiErrorMessages::not_initialized;
+		return 0;
 	}
-}; // EffectStateDeleter
 
-struct Device
+	return static_cast<int>(pimpl_->sources_.size());
+}
+
+int Api::get_block_size() const
 {
-	using ChannelIds = std::array<ChannelId, max_channels>;
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return 0;
+	}
 
+	return pimpl_->device_.block_size_;
+}
 
-	int sampling_rate_;
-	int channel_count_;
-	ChannelFormat channel_format_;
-	ChannelIds channel_ids_;
-	SampleBuffers sample_buffers_;
+int Api::get_worker_count() const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return 0;
+	}
 
-	// Temp storage used for each source when mixing.
-	SampleBuffer resampled_data_;
-	SampleBuffer filtered_data_;
+	return pimpl_->worker_pool_.get_worker_count();
+}
 
-	// The "dry" path corresponds to the main output.
-	AmbiOutput dry_;
+int Api::get_distortion_oversampling_factor() const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return 0;
+	}
 
-	// First-order ambisonics output, to be upsampled to the dry buffer if different.
-	AmbiOutput foa_;
+	return pimpl_->device_.distortion_oversampling_factor_;
+}
 
-	const float* source_samples_;
+std::size_t Api::get_memory_size() const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return 0;
+	}
 
+	return pimpl_->arena_.get_size();
+}
 
-	void initialize(
-		const ChannelFormat channel_format,
-		const int sampling_rate)
+bool Api::get_effect(
+	const int effect_index,
+	Effect& effect) const
+{
+	if (!is_initialized())
 	{
-		channel_count_ = channel_format_to_channel_count(channel_format);
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-		// Set output format
-		channel_format_ = channel_format;
-		sampling_rate_ = sampling_rate;
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		alu_init_renderer();
+	effect = pimpl_->effect_contexts_[effect_index].applied_effect_;
 
-		sample_buffers_.clear();
-		sample_buffers_.resize(channel_count_);
-	}
+	return true;
+}
 
-	void uninitialize()
+bool Api::get_deferred_effect(
+	const int effect_index,
+	Effect& effect) const
+{
+	if (!is_initialized())
 	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
 
-	void set_default_wfx_channel_order()
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
 	{
-		channel_ids_.fill(ChannelId::none);
-
-		switch (channel_format_)
-		{
-		case ChannelFormat::mono:
-			channel_ids_[0] = ChannelId::front_center;
-			break;
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		case ChannelFormat::stereo:
-			channel_ids_[0] = ChannelId::front_left;
-			channel_ids_[1] = ChannelId::front_right;
-			break;
+	effect = pimpl_->effect_contexts_[effect_index].deferred_effect_;
 
-		case ChannelFormat::quad:
-			channel_ids_[0] = ChannelId::front_left;
-			channel_ids_[1] = ChannelId::front_right;
-			channel_ids_[2] = ChannelId::back_left;
-			channel_ids_[3] = ChannelId::back_right;
-			break;
+	return true;
+}
 
-		case ChannelFormat::five_point_one:
-			channel_ids_[0] = ChannelId::front_left;
-			channel_ids_[1] = ChannelId::front_right;
-			channel_ids_[2] = ChannelId::front_center;
-			channel_ids_[3] = ChannelId::lfe;
-			channel_ids_[4] = ChannelId::side_left;
-			channel_ids_[5] = ChannelId::side_right;
-			break;
+bool Api::set_effect_type(
+	const int effect_index,
+	const EffectType effect_type)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-		case ChannelFormat::five_point_one_rear:
-			channel_ids_[0] = ChannelId::front_left;
-			channel_ids_[1] = ChannelId::front_right;
-			channel_ids_[2] = ChannelId::front_center;
-			channel_ids_[3] = ChannelId::lfe;
-			channel_ids_[4] = ChannelId::back_left;
-			channel_ids_[5] = ChannelId::back_right;
-			break;
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		case ChannelFormat::six_point_one:
-			channel_ids_[0] = ChannelId::front_left;
-			channel_ids_[1] = ChannelId::front_right;
-			channel_ids_[2] = ChannelId::front_center;
-			channel_ids_[3] = ChannelId::lfe;
-			channel_ids_[4] = ChannelId::back_center;
-			channel_ids_[5] = ChannelId::side_left;
-			channel_ids_[6] = ChannelId::side_right;
-			break;
+	pimpl_->effect_contexts_[effect_index].deferred_effect_.set_type_and_defaults(effect_type);
 
-		case ChannelFormat::seven_point_one:
-			channel_ids_[0] = ChannelId::front_left;
-			channel_ids_[1] = ChannelId::front_right;
-			channel_ids_[2] = ChannelId::front_center;
-			channel_ids_[3] = ChannelId::lfe;
-			channel_ids_[4] = ChannelId::back_left;
-			channel_ids_[5] = ChannelId::back_right;
-			channel_ids_[6] = ChannelId::side_left;
-			channel_ids_[7] = ChannelId::side_right;
-			break;
+	return true;
+}
 
-		case ChannelFormat::none:
-		default:
-			break;
-		}
+bool Api::set_effect_props(
+	const int effect_index,
+	const EffectProps& effect_props)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
 
-	void alu_init_renderer()
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
 	{
-		dry_.ambi_.reset();
-		dry_.coeff_count_ = 0;
-		set_default_wfx_channel_order();
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		const ChannelPanning *channel_map = nullptr;
-		auto coeff_count = 0;
-		auto count = 0;
+	pimpl_->effect_contexts_[effect_index].deferred_effect_.props_ = effect_props;
+
+	return true;
+}
+
+bool Api::set_effect(
+	const int effect_index,
+	const Effect& effect)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-		switch (channel_format_)
-		{
-		case ChannelFormat::mono:
-			count = get_array_extents(Panning::mono_panning);
-			channel_map = Panning::mono_panning;
-			coeff_count = 1;
-			break;
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		case ChannelFormat::stereo:
-			count = get_array_extents(Panning::stereo_panning);
-			channel_map = Panning::stereo_panning;
-			coeff_count = 4;
-			break;
+	pimpl_->effect_contexts_[effect_index].deferred_effect_ = effect;
 
-		case ChannelFormat::quad:
-			count = get_array_extents(Panning::quad_panning);
-			channel_map = Panning::quad_panning;
-			coeff_count = 4;
-			break;
+	return false;
+}
 
-		case ChannelFormat::five_point_one:
-			count = get_array_extents(Panning::x5_1_side_panning);
-			channel_map = Panning::x5_1_side_panning;
-			coeff_count = 9;
-			break;
+bool Api::get_send_props(
+	const int effect_index,
+	SendProps& send_props) const
+{
+	return get_source_send_props(0, effect_index, send_props);
+}
 
-		case ChannelFormat::five_point_one_rear:
-			count = get_array_extents(Panning::x5_1_rear_panning);
-			channel_map = Panning::x5_1_rear_panning;
-			coeff_count = 9;
-			break;
+bool Api::get_deferred_send_props(
+	const int effect_index,
+	SendProps& send_props) const
+{
+	return get_deferred_source_send_props(0, effect_index, send_props);
+}
 
-		case ChannelFormat::six_point_one:
-			count = get_array_extents(Panning::x6_1_panning);
-			channel_map = Panning::x6_1_panning;
-			coeff_count = 9;
-			break;
+bool Api::set_send_props(
+	const int effect_index,
+	const SendProps& send_props)
+{
+	return set_source_send_props(0, effect_index, send_props);
+}
 
-		case ChannelFormat::seven_point_one:
-			count = get_array_extents(Panning::x7_1_panning);
-			channel_map = Panning::x7_1_panning;
-			coeff_count = 16;
-			break;
+bool Api::get_source_send_props(
+	const int source_index,
+	const int effect_index,
+	SendProps& send_props) const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-		case ChannelFormat::none:
-		default:
-			break;
-		}
+	if (source_index < 0 || source_index >= static_cast<int>(pimpl_->sources_.size()))
+	{
+		error_message_ = ApiErrorMessages::source_index_out_of_range;
+		return false;
+	}
 
-		Panning::set_channel_map(
-			channel_ids_.data(),
-			dry_.ambi_.coeffs_.data(),
-			channel_map,
-			count,
-			&channel_count_);
+	if (effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		dry_.coeff_count_ = coeff_count;
+	const auto& source = pimpl_->sources_[source_index];
 
-		foa_.ambi_.reset();
+	const auto& props = (
+		effect_index < 0 ?
+		source.direct_.applied_props_ :
+		source.auxes_[effect_index].applied_props_);
 
-		for (int i = 0; i < channel_count_; ++i)
-		{
-			foa_.ambi_.coeffs_[i][0] = dry_.ambi_.coeffs_[i][0];
+	send_props = props;
 
-			for (int j = 1; j < 4; ++j)
-			{
-				foa_.ambi_.coeffs_[i][j] = dry_.ambi_.coeffs_[i][j];
-			}
-		}
+	return true;
+}
 
-		foa_.coeff_count_ = 4;
+bool Api::get_deferred_source_send_props(
+	const int source_index,
+	const int effect_index,
+	SendProps& send_props) const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
 
-	// Returns the index for the given channel name (e.g. FrontCenter), or -1 if it
-	// doesn't exist.
-	int get_channel_index(
-		const ChannelId channel_id_to_find)
+	if (source_index < 0 || source_index >= static_cast<int>(pimpl_->sources_.size()))
 	{
-		const auto it_begin = channel_ids_.cbegin();
-		const auto it_end = channel_ids_.cbegin();
+		error_message_ = ApiErrorMessages::source_index_out_of_range;
+		return false;
+	}
 
-		const auto it = std::find_if(
-			it_begin,
-			it_end,
-			[=](const ChannelId channel_id)
-			{
-				return channel_id == channel_id_to_find;
-			}
-		);
+	if (effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		if (it == it_end)
-		{
-			return -1;
-		}
+	const auto& source = pimpl_->sources_[source_index];
 
-		return static_cast<int>(it - it_begin);
+	const auto& props = (
+		effect_index < 0 ?
+		source.direct_.deferred_props_ :
+		source.auxes_[effect_index].deferred_props_);
+
+	send_props = props;
+
+	return true;
+}
+
+bool Api::set_source_send_props(
+	const int source_index,
+	const int effect_index,
+	const SendProps& send_props)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
 
-	static int channel_format_to_channel_count(
-		const ChannelFormat channel_format)
+	if (source_index < 0 || source_index >= static_cast<int>(pimpl_->sources_.size()))
 	{
-		switch (channel_format)
-		{
-		case ChannelFormat::mono:
-			return 1;
+		error_message_ = ApiErrorMessages::source_index_out_of_range;
+		return false;
+	}
 
-		case ChannelFormat::stereo:
-			return 2;
+	if (effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-		case ChannelFormat::quad:
-			return 4;
+	auto& source = pimpl_->sources_[source_index];
 
-		case ChannelFormat::five_point_one:
-		case ChannelFormat::five_point_one_rear:
-			return 6;
+	auto& props = (
+		effect_index < 0 ?
+		source.direct_.deferred_props_ :
+		source.auxes_[effect_index].deferred_props_);
 
-		case ChannelFormat::six_point_one:
-			return 7;
+	props = send_props;
 
-		case ChannelFormat::seven_point_one:
-			return 8;
+	return true;
+}
 
-		default:
-			return 0;
-		}
+bool Api::apply_changes()
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
-}; // Device
 
-struct EffectSlot
+	if (!pimpl_->apply_changes())
+	{
+		error_message_ = pimpl_->error_message_;
+		return false;
+	}
+
+	return true;
+}
+
+bool Api::suspend_effect(
+	const int effect_index)
 {
-	using EffectStateUPtr = std::unique_ptr<EffectState, EffectStateDeleter>;
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-	Effect effect_;
-	EffectStateUPtr effect_state_;
-	bool is_props_changed_;
+	pimpl_->effect_contexts_[effect_index].is_suspended_.store(true, std::memory_order_relaxed);
 
-	// Wet buffer configuration is ACN channel order with N3D scaling:
-	// * Channel 0 is the unattenuated mono signal.
-	// * Channel 1 is OpenAL -X
-	// * Channel 2 is OpenAL Y
-	// * Channel 3 is OpenAL -Z
-	// Consequently, effects that only want to work with mono input can use
-	// channel 0 by itself. Effects that want multichannel can process the
-	// ambisonics signal and make a B-Format pan (ComputeFirstOrderGains) for
-	// first-order device output (FOAOut).
-	SampleBuffers wet_buffer_;
+	return true;
+}
 
+bool Api::resume_effect(
+	const int effect_index)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-	EffectSlot()
-		:
-		effect_{},
-		effect_state_{},
-		is_props_changed_{},
-		wet_buffer_{SampleBuffers::size_type{max_effect_channels}}
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
 	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
 	}
 
-	EffectSlot(
-		const EffectSlot& that) = delete;
+	pimpl_->effect_contexts_[effect_index].is_suspended_.store(false, std::memory_order_relaxed);
 
-	EffectSlot(
-		EffectSlot&& that) = default;
+	return true;
+}
+
+bool Api::is_effect_suspended(
+	const int effect_index,
+	bool& is_suspended) const
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
+
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
+	}
 
-	EffectSlot& operator=(
-		const EffectSlot& that) = delete;
+	is_suspended = pimpl_->effect_contexts_[effect_index].is_suspended_.load(std::memory_order_relaxed);
 
-	EffectSlot& operator=(
-		EffectSlot&& that) = default;
+	return true;
+}
 
-	~EffectSlot()
+bool Api::schedule_effect_props(
+	const int sample_offset,
+	const int effect_index,
+	const EffectProps& effect_props)
+{
+	if (!is_initialized())
 	{
-		uninitialize();
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
 
-	void initialize()
+	if (sample_offset < 0)
 	{
-		uninitialize();
-
-		effect_.type_ = EffectType::null;
-		effect_state_.reset(EffectStateFactory::create_by_type(EffectType::null));
-		is_props_changed_ = true;
+		error_message_ = ApiErrorMessages::sample_offset_out_of_range;
+		return false;
 	}
 
-	void uninitialize()
+	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
 	{
-		effect_state_.reset(nullptr);
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
 	}
 
-	void set_effect(
-		Device& device,
-		Effect& effect)
-	{
-		if (effect_.type_ != effect.type_)
-		{
-			effect_state_.reset(EffectStateFactory::create_by_type(effect.type_));
+	auto& effect_context = pimpl_->effect_contexts_[effect_index];
+	auto& applied_effect = effect_context.applied_effect_;
+	auto& deferred_effect = effect_context.deferred_effect_;
 
-			effect_state_->dst_buffers_ = &device.sample_buffers_;
-			effect_state_->dst_channel_count_ = device.channel_count_;
-			effect_state_->update_device(device);
+	auto event = ScheduledEvent{};
+	event.type_ = ScheduledEvent::Type::effect_props;
+	event.sample_offset_ = sample_offset;
+	event.effect_index_ = effect_index;
+	event.effect_.type_ = applied_effect.type_;
+	event.effect_.props_ = effect_props;
+	event.effect_.normalize();
 
-			effect_.type_ = effect.type_;
-			effect_.props_ = effect.props_;
-		}
-		else
-		{
-			effect_.props_ = effect.props_;
-		}
+	if (!pimpl_->schedule_event(event))
+	{
+		error_message_ = pimpl_->error_message_;
+		return false;
+	}
 
-		is_props_changed_ = true;
+	// Keep the deferred properties in sync, so the next "apply_changes" doesn't revert them.
+	if (deferred_effect.type_ == applied_effect.type_)
+	{
+		deferred_effect.props_ = event.effect_.props_;
 	}
-}; // EffectSlot
 
-struct EffectContext
-{
-	Effect deferred_effect_;
-	EffectSlot effect_slot_;
-}; // EffectContext
+	applied_effect.props_ = event.effect_.props_;
 
-using EffectContexts = std::vector<EffectContext>;
+	return true;
+}
 
+bool Api::schedule_send_props(
+	const int sample_offset,
+	const int effect_index,
+	const SendProps& send_props)
+{
+	return schedule_source_send_props(sample_offset, 0, effect_index, send_props);
+}
 
-struct MixHelpers
+bool Api::schedule_source_send_props(
+	const int sample_offset,
+	const int source_index,
+	const int effect_index,
+	const SendProps& send_props)
 {
-	// Basically the inverse of the "mix". Rather than one input going to multiple
-	// outputs (each with its own gain), it's multiple inputs (each with its own
-	// gain) going to one output. This applies one row (vs one column) of a matrix
-	// transform. And as the matrices are more or less static once set up, no
-	// stepping is necessary.
-	static void mix_row(
-		float* dst_buffer,
-		const float* gains,
-		const SampleBuffers& src_buffers,
-		const int channel_count,
-		const int src_position,
-		const int buffer_size)
+	if (!is_initialized())
 	{
-		for (int c = 0; c < channel_count; ++c)
-		{
-			const auto gain = gains[c];
-
-			if (!(std::abs(gain) > silence_threshold_gain))
-			{
-				continue;
-			}
-
-			for (int i = 0; i < buffer_size; ++i)
-			{
-				dst_buffer[i] += src_buffers[c][src_position + i] * gain;
-			}
-		}
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
 
-	static void mix(
-		const float* data,
-		const int channel_count,
-		SampleBuffers& dst_buffers,
-		float* current_gains,
-		const float* target_gains,
-		const int counter,
-		const int dst_position,
-		const int buffer_size)
+	if (sample_offset < 0)
 	{
-		const auto delta = ((counter > 0) ? 1.0F / static_cast<float>(counter) : 0.0F);
-
-		for (int c = 0; c < channel_count; ++c)
-		{
-			auto pos = 0;
-			auto gain = current_gains[c];
-			const auto step = (target_gains[c] - gain) * delta;
-
-			if (std::abs(step) > Math::get_epsilon())
-			{
-				const auto size = std::min(buffer_size, counter);
-
-				for (; pos < size; ++pos)
-				{
-					dst_buffers[c][dst_position + pos] += data[pos] * gain;
-					gain += step;
-				}
-
-				if (pos == counter)
-				{
-					gain = target_gains[c];
-				}
-
-				current_gains[c] = gain;
-			}
+		error_message_ = ApiErrorMessages::sample_offset_out_of_range;
+		return false;
+	}
 
-			if (!(std::abs(gain) > silence_threshold_gain))
-			{
-				continue;
-			}
+	if (source_index < 0 || source_index >= static_cast<int>(pimpl_->sources_.size()))
+	{
+		error_message_ = ApiErrorMessages::source_index_out_of_range;
+		return false;
+	}
 
-			for (; pos < buffer_size; ++pos)
-			{
-				dst_buffers[c][dst_position + pos] += data[pos] * gain;
-			}
-		}
+	if (effect_index >= pimpl_->effect_count_)
+	{
+		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		return false;
 	}
-}; // MixHelpers
 
+	auto& source = pimpl_->sources_[source_index];
 
-// ==========================================================================
-// Api::Impl
+	auto& send = (
+		effect_index < 0 ?
+		source.direct_ :
+		source.auxes_[effect_index]);
 
-struct ApiImplErrorMessages
-{
-	static constexpr auto no_error = "";
-	static constexpr auto invalid_channel_format = "Invalid channel format.";
-	static constexpr auto sampling_rate_out_of_range = "Sampling rate is out of range.";
-	static constexpr auto effect_count_out_of_range = "Effect count is out of range.";
-}; // ApiImplErrorMessages
+	auto event = ScheduledEvent{};
+	event.type_ = ScheduledEvent::Type::send_props;
+	event.sample_offset_ = sample_offset;
+	event.source_index_ = source_index;
+	event.effect_index_ = effect_index;
+	event.send_props_ = send_props;
+	event.send_props_.normalize();
 
+	if (!pimpl_->schedule_event(event))
+	{
+		error_message_ = pimpl_->error_message_;
+		return false;
+	}
 
-constexpr const char* ApiImplErrorMessages::no_error;
-constexpr const char* ApiImplErrorMessages::invalid_channel_format;
-constexpr const char* ApiImplErrorMessages::sampling_rate_out_of_range;
-constexpr const char* ApiImplErrorMessages::effect_count_out_of_range;
+	// Keep the deferred properties in sync, so the next "apply_changes" doesn't revert them.
+	send.deferred_props_ = event.send_props_;
+	send.applied_props_ = event.send_props_;
 
+	return true;
+}
 
-class Api::Impl
+bool Api::mix(
+	const int sample_count,
+	const float* src_samples,
+	float* dst_samples)
 {
-public:
-	Device device_;
-	Source source_;
-	EffectContexts effect_contexts_;
-	int effect_count_;
-	const char* error_message_;
-
-
-	Impl()
-		:
-		device_{},
-		source_{},
-		effect_contexts_{},
-		effect_count_{},
-		error_message_{ApiImplErrorMessages::no_error}
+	if (!is_initialized())
 	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
 	}
 
-	~Impl()
+	if (sample_count == 0)
 	{
-		uninitialize();
+		return true;
 	}
 
-
-	bool initialize(
-		const ChannelFormat channel_format,
-		const int sampling_rate,
-		const int effect_count)
+	if (!src_samples)
 	{
-		uninitialize();
+		error_message_ = ApiErrorMessages::no_src_samples;
+		return false;
+	}
 
-		const auto channel_count = Device::channel_format_to_channel_count(channel_format);
+	if (!dst_samples)
+	{
+		error_message_ = ApiErrorMessages::no_dst_samples;
+		return false;
+	}
 
-		if (channel_count == 0)
-		{
-			error_message_ = ApiImplErrorMessages::invalid_channel_format;
-			return false;
-		}
+	const float* const src_sources[] = {src_samples};
 
-		if (sampling_rate < min_sampling_rate)
-		{
-			error_message_ = ApiImplErrorMessages::sampling_rate_out_of_range;
-			return false;
-		}
+	const auto reader = Impl::InterleavedReader<float>{src_sources, 1, pimpl_->device_.channel_count_};
+	const auto writer = Impl::InterleavedWriter<float>{dst_samples, nullptr};
 
-		if (effect_count <= 0 || effect_count > max_effects)
-		{
-			error_message_ = ApiImplErrorMessages::effect_count_out_of_range;
-			return false;
-		}
+	pimpl_->mix_data(sample_count, reader, writer);
 
-		device_.initialize(channel_format, sampling_rate);
+	return true;
+}
 
-		effect_count_ = effect_count;
+bool Api::mix_sources(
+	const int sample_count,
+	const float* const* src_samples,
+	float* dst_samples)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-		effect_contexts_.clear();
-		effect_contexts_.resize(effect_count_);
+	if (sample_count == 0)
+	{
+		return true;
+	}
 
-		for (auto& effect_context : effect_contexts_)
-		{
-			effect_context.deferred_effect_.set_type_and_defaults(EffectType::null);
-			effect_context.effect_slot_.initialize();
+	if (!src_samples)
+	{
+		error_message_ = ApiErrorMessages::no_src_samples;
+		return false;
+	}
 
-			auto effect_state = effect_context.effect_slot_.effect_state_.get();
-			effect_state->dst_buffers_ = &device_.sample_buffers_;
-			effect_state->dst_channel_count_ = device_.channel_count_;
-			effect_state->update_device(device_);
-			effect_context.effect_slot_.is_props_changed_ = true;
-		}
+	if (!dst_samples)
+	{
+		error_message_ = ApiErrorMessages::no_dst_samples;
+		return false;
+	}
 
-		source_.initialize(effect_count);
+	const auto source_count = static_cast<int>(pimpl_->sources_.size());
 
-		for (int i = 0; i < device_.channel_count_; ++i)
-		{
-			source_.direct_.channels_[i].reset();
+	const auto reader = Impl::InterleavedReader<float>{src_samples, source_count, pimpl_->device_.channel_count_};
+	const auto writer = Impl::InterleavedWriter<float>{dst_samples, nullptr};
 
-			for (auto& aux : source_.auxes_)
-			{
-				aux.channels_[i].reset();
-			}
-		}
+	pimpl_->mix_data(sample_count, reader, writer);
 
-		return true;
-	}
+	return true;
+}
 
-	void uninitialize()
+bool Api::mix_s16(
+	const int sample_count,
+	const std::int16_t* src_samples,
+	std::int16_t* dst_samples,
+	const bool is_dithered)
+{
+	if (!is_initialized())
 	{
-		for (auto& effect_context : effect_contexts_)
-		{
-			effect_context.effect_slot_.uninitialize();
-		}
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-		device_.uninitialize();
+	if (sample_count == 0)
+	{
+		return true;
 	}
 
-	void mix_source(
-		const int sample_count)
+	if (!src_samples)
 	{
-		const auto channel_count = device_.channel_count_;
-
-		for (int chan = 0; chan < channel_count; ++chan)
-		{
-			for (int i = 0; i < sample_count; ++i)
-			{
-				device_.resampled_data_[i] = device_.source_samples_[(i * channel_count) + chan];
-			}
-
-
-			auto parms = &source_.direct_.channels_[chan];
+		error_message_ = ApiErrorMessages::no_src_samples;
+		return false;
+	}
 
-			auto samples = apply_filters(
-				&parms->low_pass_,
-				&parms->high_pass_,
-				device_.filtered_data_.data(),
-				device_.resampled_data_.data(),
-				sample_count,
-				source_.direct_.filter_type_);
+	if (!dst_samples)
+	{
+		error_message_ = ApiErrorMessages::no_dst_samples;
+		return false;
+	}
 
-			parms->current_gains_ = parms->target_gains_;
+	const std::int16_t* const src_sources[] = {src_samples};
 
-			MixHelpers::mix(
-				samples,
-				source_.direct_.channel_count_,
-				*source_.direct_.buffers_,
-				parms->current_gains_.data(),
-				parms->target_gains_.data(),
-				0,
-				0,
-				sample_count);
+	const auto reader = Impl::InterleavedReader<std::int16_t>{src_sources, 1, pimpl_->device_.channel_count_};
+	const auto writer = Impl::InterleavedWriter<std::int16_t>{dst_samples, is_dithered ? &pimpl_->dither_ : nullptr};
 
-			for (auto& aux : source_.auxes_)
-			{
-				if (!aux.buffers_)
-				{
-					continue;
-				}
+	pimpl_->mix_data(sample_count, reader, writer);
 
-				parms = &aux.channels_[chan];
+	return true;
+}
 
-				samples = apply_filters(
-					&parms->low_pass_,
-					&parms->high_pass_,
-					device_.filtered_data_.data(),
-					device_.resampled_data_.data(),
-					sample_count,
-					aux.filter_type_);
+bool Api::mix_s32(
+	const int sample_count,
+	const std::int32_t* src_samples,
+	std::int32_t* dst_samples)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-				parms->current_gains_ = parms->target_gains_;
+	if (sample_count == 0)
+	{
+		return true;
+	}
 
-				MixHelpers::mix(
-					samples,
-					aux.channel_count_,
-					*aux.buffers_,
-					parms->current_gains_.data(),
-					parms->target_gains_.data(),
-					0,
-					0,
-					sample_count);
-			}
-		}
+	if (!src_samples)
+	{
+		error_message_ = ApiErrorMessages::no_src_samples;
+		return false;
 	}
 
-	void mix_data(
-		const int sample_count,
-		const float* src_samples,
-		float* dst_samples)
+	if (!dst_samples)
 	{
-		device_.source_samples_ = src_samples;
+		error_message_ = ApiErrorMessages::no_dst_samples;
+		return false;
+	}
 
-		for (int samples_done = 0; samples_done < sample_count; )
-		{
-			const auto samples_to_do = std::min(sample_count - samples_done, max_sample_buffer_size);
+	const std::int32_t* const src_sources[] = {src_samples};
 
-			for (int c = 0; c < device_.channel_count_; ++c)
-			{
-				std::fill_n(device_.sample_buffers_[c].begin(), samples_to_do, 0.0F);
-			}
+	const auto reader = Impl::InterleavedReader<std::int32_t>{src_sources, 1, pimpl_->device_.channel_count_};
+	const auto writer = Impl::InterleavedWriter<std::int32_t>{dst_samples, nullptr};
 
-			update_context_sources();
+	pimpl_->mix_data(sample_count, reader, writer);
 
-			for (auto& effect_context : effect_contexts_)
-			{
-				for (int c = 0; c < max_effect_channels; ++c)
-				{
-					std::fill_n(effect_context.effect_slot_.wet_buffer_[c].begin(), samples_to_do, 0.0F);
-				}
-			}
+	return true;
+}
 
-			// source processing
-			mix_source(samples_to_do);
+bool Api::mix_planar(
+	const int sample_count,
+	const float* const* src_channels,
+	float* const* dst_channels)
+{
+	if (!is_initialized())
+	{
+		error_message_ = ApiErrorMessages::not_initialized;
+		return false;
+	}
 
-			// effect slot processing
-			for (auto& effect_context : effect_contexts_)
-			{
-				auto state = effect_context.effect_slot_.effect_state_.get();
+	if (sample_count == 0)
+	{
+		return true;
+	}
 
-				state->process(
-					samples_to_do,
-					effect_context.effect_slot_.wet_buffer_,
-					*state->dst_buffers_,
-					state->dst_channel_count_);
-			}
+	const auto channel_count = pimpl_->device_.channel_count_;
 
-			if (dst_samples)
-			{
-				write_f32(
-					device_.sample_buffers_,
-					dst_samples,
-					samples_done,
-					samples_to_do,
-					device_.channel_count_);
-			}
+	if (!Impl::are_channels_valid(src_channels, channel_count))
+	{
+		error_message_ = ApiErrorMessages::no_src_samples;
+		return false;
+	}
 
-			samples_done += samples_to_do;
-		}
+	if (!Impl::are_channels_valid(dst_channels, channel_count))
+	{
+		error_message_ = ApiErrorMessages::no_dst_samples;
+		return false;
 	}
 
+	const auto reader = Impl::PlanarReader{src_channels};
+	const auto writer = Impl::PlanarWriter{dst_channels};
 
-private:
-	struct ChannelMap
-	{
-		ChannelId channel_id_;
-		float angle_;
-		float elevation_;
-	}; // ChannelMap
+	pimpl_->mix_data(sample_count, reader, writer);
 
-	static constexpr ChannelMap mono_map[1] =
-	{
-		{ChannelId::front_center, 0.0F, 0.0F, },
-	};
+	return true;
+}
 
-	static constexpr ChannelMap stereo_map[2] =
-	{
-		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
-	};
+void Api::uninitialize()
+{
+	pimpl_ = nullptr;
+}
 
-	static constexpr ChannelMap quad_map[4] =
-	{
-		{ChannelId::front_left, Math::deg_to_rad(-45.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_right, Math::deg_to_rad(45.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::back_left, Math::deg_to_rad(-135.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::back_right, Math::deg_to_rad(135.0F), Math::deg_to_rad(0.0F), },
-	};
+const char* Api::get_error_message() const
+{
+	return error_message_;
+}
 
-	static constexpr ChannelMap x5_1_map[6] =
-	{
-		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_center, Math::deg_to_rad(0.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::lfe, 0.0F, 0.0F, },
-		{ChannelId::side_left, Math::deg_to_rad(-110.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::side_right, Math::deg_to_rad(110.0F), Math::deg_to_rad(0.0F), },
-	};
+int Api::get_min_channels()
+{
+	return 1;
+}
 
-	static constexpr ChannelMap x6_1_map[7] =
-	{
-		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_center, Math::deg_to_rad(0.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::lfe, 0.0F, 0.0F, },
-		{ChannelId::back_center, Math::deg_to_rad(180.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::side_left, Math::deg_to_rad(-90.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::side_right, Math::deg_to_rad(90.0F), Math::deg_to_rad(0.0F), },
-	};
+int Api::get_max_channels()
+{
+	return max_channels;
+}
 
-	static constexpr ChannelMap x7_1_map[8] =
-	{
-		{ChannelId::front_left, Math::deg_to_rad(-30.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_right, Math::deg_to_rad(30.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::front_center, Math::deg_to_rad(0.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::lfe, 0.0F, 0.0F, },
-		{ChannelId::back_left, Math::deg_to_rad(-150.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::back_right, Math::deg_to_rad(150.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::side_left, Math::deg_to_rad(-90.0F), Math::deg_to_rad(0.0F), },
-		{ChannelId::side_right, Math::deg_to_rad(90.0F), Math::deg_to_rad(0.0F), },
-	};
+int Api::get_min_sampling_rate()
+{
+	return min_sampling_rate;
+}
 
+int Api::get_max_sampling_rate()
+{
+	return max_sampling_rate;
+}
 
-	static const float* apply_filters(
-		FilterState* lp_filter,
-		FilterState* hp_filter,
-		float* dst_samples,
-		const float* src_samples,
-		const int sample_count,
-		const ActiveFilters filter_type)
-	{
-		switch (filter_type)
-		{
-		case ActiveFilters::none:
-			lp_filter->process_pass_through(sample_count, src_samples);
-			hp_filter->process_pass_through(sample_count, src_samples);
-			break;
+int Api::get_min_effects()
+{
+	return min_effects;
+}
 
-		case ActiveFilters::low_pass:
-			lp_filter->process(sample_count, src_samples, dst_samples);
-			hp_filter->process_pass_through(sample_count, dst_samples);
-			return dst_samples;
+int Api::get_max_effects()
+{
+	return max_effects;
+}
 
-		case ActiveFilters::high_pass:
-			lp_filter->process_pass_through(sample_count, src_samples);
-			hp_filter->process(sample_count, src_samples, dst_samples);
-			return dst_samples;
+int Api::get_min_sources()
+{
+	return min_sources;
+}
 
-		case ActiveFilters::band_pass:
-			for (int i = 0; i < sample_count; )
-			{
-				float temp[256];
+int Api::get_max_sources()
+{
+	return max_sources;
+}
 
-				const auto todo = std::min(256, sample_count - i);
+int Api::get_min_block_size()
+{
+	return min_block_size;
+}
 
-				lp_filter->process(todo, src_samples + i, temp);
-				hp_filter->process(todo, temp, dst_samples + i);
+int Api::get_max_block_size()
+{
+	return max_block_size;
+}
 
-				i += todo;
-			}
+int Api::get_min_workers()
+{
+	return min_workers;
+}
 
-			return dst_samples;
-		}
+int Api::get_max_workers()
+{
+	return max_workers;
+}
 
-		return src_samples;
-	}
+int Api::get_max_scheduled_events()
+{
+	return max_scheduled_events;
+}
 
-	bool calc_effect_slot_params(
-		EffectSlot& effect_slot)
+ChannelFormat Api::channel_count_to_channel_format(
+	const int channel_count)
+{
+	switch (channel_count)
 	{
-		if (!effect_slot.is_props_changed_)
-		{
-			return false;
-		}
+	case 1:
+		return ChannelFormat::mono;
 
-		effect_slot.is_props_changed_ = false;
-		effect_slot.effect_state_->update(device_, effect_slot, effect_slot.effect_.props_);
+	case 2:
+		return ChannelFormat::stereo;
 
-		return true;
-	}
+	case 4:
+		return ChannelFormat::quad;
 
-	bool calc_source_params(
-		Source& source)
-	{
-		if (!source.are_props_changed_)
-		{
-			return false;
-		}
+	case 6:
+		return ChannelFormat::five_point_one;
 
-		source.are_props_changed_ = false;
+	case 7:
+		return ChannelFormat::six_point_one;
 
-		return true;
-	}
+	case 8:
+		return ChannelFormat::seven_point_one;
 
-	void calc_panning_and_filters(
-		const float distance,
-		const float* dir,
-		const float spread,
-		const float dry_gain,
-		const float dry_gain_hf,
-		const float dry_gain_lf,
-		const WetGains& wet_gain,
-		const WetGains& wet_gain_lf,
-		const WetGains& wet_gain_hf)
-	{
-		static_cast<void>(distance);
-		static_cast<void>(dir);
+	default:
+		return ChannelFormat::none;
+	}
+}
 
-		const auto frequency = device_.sampling_rate_;
-		const ChannelMap* channel_map = nullptr;
-		auto channel_count = 0;
+int Api::channel_format_to_channel_count(
+	const ChannelFormat channel_format)
+{
+	return Device::channel_format_to_channel_count(channel_format);
+}
 
-		switch (device_.channel_format_)
-		{
-		case ChannelFormat::mono:
-			channel_map = mono_map;
-			channel_count = 1;
-			break;
+// Api
+// ==========================================================================
 
-		case ChannelFormat::stereo:
-			channel_map = stereo_map;
-			channel_count = 2;
-			break;
 
-		case ChannelFormat::quad:
-			channel_map = quad_map;
-			channel_count = 4;
-			break;
+// ==========================================================================
+// Scheduler::Impl
 
-		case ChannelFormat::five_point_one:
-			channel_map = x5_1_map;
-			channel_count = 6;
-			break;
+struct SchedulerImplErrorMessages
+{
+	static constexpr auto no_error = "";
+	static constexpr auto worker_count_out_of_range = "Worker count is out of range.";
+	static constexpr auto start_workers = "Failed to start worker threads.";
+	static constexpr auto initialize_instance = "Failed to initialize an instance.";
+	static constexpr auto mix_instance = "Failed to mix an instance.";
+}; // SchedulerImplErrorMessages
 
-		case ChannelFormat::six_point_one:
-			channel_map = x6_1_map;
-			channel_count = 7;
-			break;
 
-		case ChannelFormat::seven_point_one:
-			channel_map = x7_1_map;
-			channel_count = 8;
-			break;
+constexpr const char* SchedulerImplErrorMessages::no_error;
+constexpr const char* SchedulerImplErrorMessages::worker_count_out_of_range;
+constexpr const char* SchedulerImplErrorMessages::start_workers;
+constexpr const char* SchedulerImplErrorMessages::initialize_instance;
+constexpr const char* SchedulerImplErrorMessages::mix_instance;
 
-		case ChannelFormat::none:
-		default:
-			break;
-		}
 
-		// Non-HRTF rendering. Use normal panning to the output.
-		for (int c = 0; c < channel_count; ++c)
-		{
-			AmbiCoeffs coeffs;
+class Scheduler::Impl
+{
+public:
+	using ApiUPtr = std::unique_ptr<Api>;
 
-			// Special-case LFE
-			if (channel_map[c].channel_id_ == ChannelId::lfe)
-			{
-				source_.direct_.channels_[c].target_gains_.fill(0.0F);
+	struct Instance
+	{
+		ApiUPtr api_;
 
-				const auto idx = device_.get_channel_index(channel_map[c].channel_id_);
+		// The queued block (zero sample count if none).
+		int sample_count_;
+		const float* src_samples_;
+		float* dst_samples_;
 
-				if (idx != -1)
-				{
-					source_.direct_.channels_[c].target_gains_[idx] = dry_gain;
-				}
+		// An average time of mixing one sample frame (in seconds).
+		double cost_;
 
-				for (auto& aux : source_.auxes_)
-				{
-					aux.channels_[c].target_gains_.fill(0.0F);
-				}
+		bool is_mix_failed_;
+	}; // Instance
 
-				continue;
-			}
+	using Instances = std::vector<Instance>;
 
-			Panning::calc_angle_coeffs(channel_map[c].angle_, channel_map[c].elevation_, spread, coeffs);
 
-			Panning::compute_panning_gains(
-				device_.channel_count_,
-				device_.dry_,
-				coeffs,
-				dry_gain,
-				source_.direct_.channels_[c].target_gains_);
+	Instances instances_;
+	SchedulerStats stats_;
+	const char* error_message_;
 
-			for (int i = 0; i < effect_count_; ++i)
-			{
-				Panning::compute_panning_gains_bf(
-					max_effect_channels,
-					coeffs,
-					wet_gain[i],
-					source_.auxes_[i].channels_[c].target_gains_);
-			}
-		}
 
-		const auto hf_scale = SendProps::hp_frequency_reference / frequency;
-		const auto lf_scale = SendProps::lp_frequency_reference / frequency;
-		auto gain_hf = std::max(dry_gain_hf, 0.001F); // Limit -60dB
-		auto gain_lf = std::max(dry_gain_lf, 0.001F);
+	Impl()
+		:
+		instances_{},
+		stats_{},
+		error_message_{SchedulerImplErrorMessages::no_error},
+		worker_pool_{},
+		job_queues_{},
+		job_indices_{}
+	{
+	}
 
-		source_.direct_.filter_type_ = ActiveFilters::none;
 
-		if (gain_hf != 1.0F)
+	bool initialize(
+		const int worker_count)
+	{
+		if (worker_count < min_scheduler_workers || worker_count > max_scheduler_workers)
 		{
-			source_.direct_.filter_type_ = static_cast<ActiveFilters>(
-				static_cast<int>(source_.direct_.filter_type_) | static_cast<int>(ActiveFilters::low_pass));
+			error_message_ = SchedulerImplErrorMessages::worker_count_out_of_range;
+			return false;
 		}
 
-		if (gain_lf != 1.0F)
+		if (!worker_pool_.initialize(worker_count))
 		{
-			source_.direct_.filter_type_ = static_cast<ActiveFilters>(
-				static_cast<int>(source_.direct_.filter_type_) | static_cast<int>(ActiveFilters::high_pass));
+			error_message_ = SchedulerImplErrorMessages::start_workers;
+			return false;
 		}
 
-		source_.direct_.channels_[0].low_pass_.set_params(
-			FilterType::high_shelf,
-			gain_hf,
-			hf_scale,
-			FilterState::calc_rcp_q_from_slope(gain_hf, 1.0F));
+		job_queues_ = JobQueues(worker_count + 1);
 
-		source_.direct_.channels_[0].high_pass_.set_params(
-			FilterType::low_shelf,
-			gain_lf,
-			lf_scale,
-			FilterState::calc_rcp_q_from_slope(gain_lf, 1.0F));
+		return true;
+	}
 
-		for (int c = 1; c < channel_count; ++c)
-		{
-			FilterState::copy_params(source_.direct_.channels_[0].low_pass_, source_.direct_.channels_[c].low_pass_);
-			FilterState::copy_params(source_.direct_.channels_[0].high_pass_, source_.direct_.channels_[c].high_pass_);
-		}
+	int add_instance(
+		const InitParams& init_params)
+	{
+		auto api = ApiUPtr{new (std::nothrow) Api{}};
 
-		for (int i = 0; i < effect_count_; ++i)
+		if (!api || !api->initialize(init_params))
 		{
-			auto& aux = source_.auxes_[i];
-			gain_hf = std::max(wet_gain_hf[i], 0.001F);
-			gain_lf = std::max(wet_gain_lf[i], 0.001F);
+			error_message_ = SchedulerImplErrorMessages::initialize_instance;
+			return -1;
+		}
 
-			aux.filter_type_ = ActiveFilters::none;
+		instances_.emplace_back();
 
-			if (gain_hf != 1.0F)
-			{
-				aux.filter_type_ = static_cast<ActiveFilters>(
-					static_cast<int>(aux.filter_type_) | static_cast<int>(ActiveFilters::low_pass));
-			}
+		auto& instance = instances_.back();
+		instance.api_ = std::move(api);
+		instance.sample_count_ = 0;
+		instance.src_samples_ = nullptr;
+		instance.dst_samples_ = nullptr;
+		instance.cost_ = 0.0;
+		instance.is_mix_failed_ = false;
 
-			if (gain_lf != 1.0F)
-			{
-				aux.filter_type_ = static_cast<ActiveFilters>(
-					static_cast<int>(aux.filter_type_) | static_cast<int>(ActiveFilters::high_pass));
-			}
+		return static_cast<int>(instances_.size()) - 1;
+	}
 
-			aux.channels_[0].low_pass_.set_params(
-				FilterType::high_shelf,
-				gain_hf,
-				hf_scale,
-				FilterState::calc_rcp_q_from_slope(gain_hf, 1.0F));
+	bool render()
+	{
+		const auto begin_time = Clock::now();
 
-			aux.channels_[0].high_pass_.set_params(
-				FilterType::low_shelf,
-				gain_lf,
-				lf_scale,
-				FilterState::calc_rcp_q_from_slope(gain_lf, 1.0F));
+		job_indices_.clear();
 
-			for (int c = 1; c < channel_count; ++c)
+		for (int i = 0, n = static_cast<int>(instances_.size()); i < n; ++i)
+		{
+			if (instances_[i].sample_count_ > 0)
 			{
-				FilterState::copy_params(aux.channels_[0].low_pass_, aux.channels_[c].low_pass_);
-				FilterState::copy_params(aux.channels_[0].high_pass_, aux.channels_[c].high_pass_);
+				job_indices_.emplace_back(i);
 			}
 		}
-	}
 
-	void calc_non_attn_source_params()
-	{
-		source_.direct_.buffers_ = &device_.sample_buffers_;
-		source_.direct_.channel_count_ = device_.channel_count_;
-
-		for (int i = 0; i < effect_count_; ++i)
+		if (job_indices_.empty())
 		{
-			if (effect_contexts_[i].effect_slot_.effect_.type_ == EffectType::null)
-			{
-				source_.auxes_[i].buffers_ = nullptr;
-				source_.auxes_[i].channel_count_ = 0;
-			}
-			else
-			{
-				source_.auxes_[i].buffers_ = &effect_contexts_[i].effect_slot_.wet_buffer_;
-				source_.auxes_[i].channel_count_ = max_effect_channels;
-			}
+			return true;
 		}
 
-		// Calculate gains
-		const auto dry_gain = std::min(source_.direct_.props_.gain_, max_mix_gain);
-		const auto dry_gain_hf = source_.direct_.props_.gain_hf_;
-		const auto dry_gain_lf = source_.direct_.props_.gain_lf_;
+		distribute_jobs();
 
-		constexpr float dir[3] = {0.0F, 0.0F, -1.0F};
+		worker_pool_.run(static_cast<int>(job_queues_.size()), run_job_queue_task, this);
 
-		auto wet_gain = WetGains{};
-		auto wet_gain_hf = WetGains{};
-		auto wet_gain_lf = WetGains{};
+		auto is_mix_failed = false;
 
-		for (int i = 0; i < effect_count_; ++i)
+		for (const auto instance_index : job_indices_)
 		{
-			wet_gain[i] = std::min(source_.auxes_[i].props_.gain_, max_mix_gain);
-			wet_gain_hf[i] = source_.auxes_[i].props_.gain_hf_;
-			wet_gain_lf[i] = source_.auxes_[i].props_.gain_lf_;
-		}
+			auto& instance = instances_[instance_index];
 
-		calc_panning_and_filters(
-			0.0F,
-			dir,
-			0.0F,
-			dry_gain,
-			dry_gain_hf,
-			dry_gain_lf,
-			wet_gain,
-			wet_gain_lf,
-			wet_gain_hf);
-	}
+			stats_.block_count_ += 1;
+			stats_.sample_count_ += instance.sample_count_;
 
-	void update_context_sources()
-	{
-		auto is_props_updated = false;
+			is_mix_failed |= instance.is_mix_failed_;
 
-		for (auto& effect_context : effect_contexts_)
-		{
-			is_props_updated |= calc_effect_slot_params(effect_context.effect_slot_);
+			instance.sample_count_ = 0;
 		}
 
-		is_props_updated |= calc_source_params(source_);
-
-		if (is_props_updated)
+		for (auto& job_queue : job_queues_)
 		{
-			calc_non_attn_source_params();
+			stats_.busy_time_ += job_queue.busy_time_;
 		}
-	}
 
-	static void write_f32(
-		const SampleBuffers& src_buffers,
-		float* dst_buffer,
-		const int offset,
-		const int sample_count,
-		const int channel_count)
-	{
-		for (int j = 0; j < channel_count; ++j)
-		{
-			const auto& src_buffer = src_buffers[j];
-			auto out = &dst_buffer[(offset * channel_count) + j];
+		stats_.render_count_ += 1;
+		stats_.wall_time_ += Seconds{Clock::now() - begin_time}.count();
 
-			for (int i = 0; i < sample_count; ++i)
-			{
-				out[i * channel_count] = src_buffer[i];
-			}
+		if (is_mix_failed)
+		{
+			error_message_ = SchedulerImplErrorMessages::mix_instance;
+			return false;
 		}
-	}
-}; // Impl
-
-
-constexpr Api::Impl::ChannelMap Api::Impl::mono_map[1];
-constexpr Api::Impl::ChannelMap Api::Impl::stereo_map[2];
-constexpr Api::Impl::ChannelMap Api::Impl::quad_map[4];
-constexpr Api::Impl::ChannelMap Api::Impl::x5_1_map[6];
-constexpr Api::Impl::ChannelMap Api::Impl::x6_1_map[7];
-constexpr Api::Impl::ChannelMap Api::Impl::x7_1_map[8];
-
-// Api::Impl
-// ==========================================================================
-
-
-// ==========================================================================
-// Api
-
-struct ApiErrorMessages
-{
-	static constexpr auto no_error = "";
-	static constexpr auto allocate_impl = "Failed to allocate implementaion class.";
-	static constexpr auto not_initialized = "Not initialized.";
-	static constexpr auto effect_index_out_of_range = "Effect index is out of range.";
-	static constexpr auto no_src_samples = "No source samples.";
-	static constexpr auto no_dst_samples = "No destination samples.";
-}; // ApiErrorMessages
 
+		return true;
+	}
 
-constexpr const char* ApiErrorMessages::no_error;
-constexpr const char* ApiErrorMessages::allocate_impl;
-constexpr const char* ApiErrorMessages::not_initialized;
-constexpr const char* ApiErrorMessages::effect_index_out_of_range;
-constexpr const char* ApiErrorMessages::no_src_samples;
-constexpr const char* ApiErrorMessages::no_dst_samples;
 
+private:
+	using Clock = std::chrono::steady_clock;
+	using Seconds = std::chrono::duration<double>;
+	using Indices = std::vector<int>;
 
-Api::Api()
-	:
-	pimpl_{},
-	error_message_{ApiErrorMessages::no_error}
-{
-}
+	// The jobs of one thread.
+	//
+	// The owner takes the jobs from the front, the others take them from the back.
+	struct JobQueue
+	{
+		std::mutex mutex_;
+		Indices instance_indices_;
+		int begin_;
+		int end_;
 
-Api::~Api()
-{
-	uninitialize();
-}
+		// An estimated cost of the assigned jobs.
+		double load_;
 
-bool Api::initialize(
-	const ChannelFormat channel_format,
-	const int sampling_rate,
-	const int effect_count)
-{
-	uninitialize();
+		// A time spent by the jobs taken from any queue.
+		double busy_time_;
+	}; // JobQueue
 
-	pimpl_.reset(new (std::nothrow) Impl{});
+	using JobQueues = std::vector<JobQueue>;
 
-	if (!pimpl_)
-	{
-		error_message_ = ApiErrorMessages::allocate_impl;
-		return false;
-	}
 
-	const auto initialize_result = pimpl_->initialize(channel_format, sampling_rate, effect_count);
+	// A weight of the latest measurement in the instance's cost.
+	static constexpr auto cost_smoothing_factor = 0.25;
 
-	if (!initialize_result)
-	{
-		error_message_ = pimpl_->error_message_;
-		uninitialize();
-	}
 
-	return initialize_result;
-}
+	WorkerPool worker_pool_;
+	JobQueues job_queues_;
+	Indices job_indices_;
 
-bool Api::is_initialized() const
-{
-	return pimpl_ != nullptr;
-}
 
-int Api::get_sampling_rate() const
-{
-	if (!is_initialized())
+	// Assigns the heaviest jobs first, each to the least loaded queue.
+	void distribute_jobs()
 	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return 0;
-	}
+		auto known_cost_sum = 0.0;
+		auto known_cost_count = 0;
 
-	return pimpl_->device_.sampling_rate_;
-}
+		for (const auto& instance : instances_)
+		{
+			if (instance.cost_ > 0.0)
+			{
+				known_cost_sum += instance.cost_;
+				known_cost_count += 1;
+			}
+		}
 
-ChannelFormat Api::get_channel_format() const
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return ChannelFormat::none;
-	}
+		// The instances without a measured cost are assumed to be average.
+		const auto default_cost = (known_cost_count > 0 ? known_cost_sum / known_cost_count : 1.0);
 
-	return pimpl_->device_.channel_format_;
-}
+		const auto estimate_cost = [&](const int instance_index)
+		{
+			const auto& instance = instances_[instance_index];
 
-int Api::get_channel_count() const
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
-	}
+			return (instance.cost_ > 0.0 ? instance.cost_ : default_cost) * instance.sample_count_;
+		};
 
-	return pimpl_->device_.channel_count_;
-}
+		std::stable_sort(
+			job_indices_.begin(),
+			job_indices_.end(),
+			[&](const int lhs, const int rhs)
+			{
+				return estimate_cost(lhs) > estimate_cost(rhs);
+			}
+		);
 
-int Api::get_effect_count() const
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
-	}
+		for (auto& job_queue : job_queues_)
+		{
+			job_queue.instance_indices_.clear();
+			job_queue.begin_ = 0;
+			job_queue.end_ = 0;
+			job_queue.load_ = 0.0;
+			job_queue.busy_time_ = 0.0;
+		}
 
-	return pimpl_->effect_count_;
-}
+		for (const auto instance_index : job_indices_)
+		{
+			auto& job_queue = *std::min_element(
+				job_queues_.begin(),
+				job_queues_.end(),
+				[](const JobQueue& lhs, const JobQueue& rhs)
+				{
+					return lhs.load_ < rhs.load_;
+				}
+			);
 
-bool Api::get_effect(
-	const int effect_index,
-	Effect& effect) const
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
+			job_queue.instance_indices_.emplace_back(instance_index);
+			job_queue.end_ += 1;
+			job_queue.load_ += estimate_cost(instance_index);
+		}
 	}
 
-	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	// Takes a job from the queue.
+	//
+	// Returns an instance index or a negative value if the queue is empty.
+	static int take_job(
+		JobQueue& job_queue,
+		const bool is_owner)
 	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
-		return false;
-	}
+		std::lock_guard<std::mutex> lock{job_queue.mutex_};
 
-	effect = pimpl_->effect_contexts_[effect_index].effect_slot_.effect_;
-
-	return true;
-}
+		if (job_queue.begin_ == job_queue.end_)
+		{
+			return -1;
+		}
 
-bool Api::get_deferred_effect(
-	const int effect_index,
-	Effect& effect) const
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
+		if (is_owner)
+		{
+			return job_queue.instance_indices_[job_queue.begin_++];
+		}
+		else
+		{
+			return job_queue.instance_indices_[--job_queue.end_];
+		}
 	}
 
-	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	void mix_instance(
+		Instance& instance,
+		JobQueue& job_queue)
 	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
-		return false;
-	}
+		const auto begin_time = Clock::now();
 
-	effect = pimpl_->effect_contexts_[effect_index].deferred_effect_;
+		instance.is_mix_failed_ = !instance.api_->mix(
+			instance.sample_count_,
+			instance.src_samples_,
+			instance.dst_samples_);
 
-	return true;
-}
+		const auto time = Seconds{Clock::now() - begin_time}.count();
+		const auto cost = time / instance.sample_count_;
 
-bool Api::set_effect_type(
-	const int effect_index,
-	const EffectType effect_type)
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
+		if (instance.cost_ > 0.0)
+		{
+			instance.cost_ += cost_smoothing_factor * (cost - instance.cost_);
+		}
+		else
+		{
+			instance.cost_ = cost;
+		}
+
+		job_queue.busy_time_ += time;
 	}
 
-	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+	static void run_job_queue_task(
+		void* context,
+		const int task_index)
 	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
-		return false;
-	}
+		auto& impl = *static_cast<Impl*>(context);
+		auto& job_queues = impl.job_queues_;
+		const auto queue_count = static_cast<int>(job_queues.size());
+		auto& own_queue = job_queues[task_index];
 
-	pimpl_->effect_contexts_[effect_index].deferred_effect_.set_type_and_defaults(effect_type);
+		while (true)
+		{
+			auto instance_index = take_job(own_queue, true);
 
-	return true;
-}
+			for (int i = 1; i < queue_count && instance_index < 0; ++i)
+			{
+				instance_index = take_job(job_queues[(task_index + i) % queue_count], false);
+			}
 
-bool Api::set_effect_props(
-	const int effect_index,
-	const EffectProps& effect_props)
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
-	}
+			if (instance_index < 0)
+			{
+				break;
+			}
 
-	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
-	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
-		return false;
+			impl.mix_instance(impl.instances_[instance_index], own_queue);
+		}
 	}
+}; // Scheduler::Impl
 
-	pimpl_->effect_contexts_[effect_index].deferred_effect_.props_ = effect_props;
 
-	return true;
-}
+constexpr double Scheduler::Impl::cost_smoothing_factor;
 
-bool Api::set_effect(
-	const int effect_index,
-	const Effect& effect)
-{
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
-	}
+// Scheduler::Impl
+// ==========================================================================
 
-	if (effect_index < 0 || effect_index >= pimpl_->effect_count_)
+
+// ==========================================================================
+// SchedulerStats
+
+double SchedulerStats::get_throughput() const
+{
+	if (wall_time_ <= 0.0)
 	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
-		return false;
+		return 0.0;
 	}
 
-	pimpl_->effect_contexts_[effect_index].deferred_effect_ = effect;
-
-	return false;
+	return sample_count_ / wall_time_;
 }
 
-bool Api::get_send_props(
-	const int effect_index,
-	SendProps& send_props) const
+double SchedulerStats::get_parallelism() const
 {
-	if (!is_initialized())
+	if (wall_time_ <= 0.0)
 	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
+		return 0.0;
 	}
 
-	if (effect_index >= pimpl_->effect_count_)
-	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
-		return false;
-	}
+	return busy_time_ / wall_time_;
+}
 
-	const auto& props = (
-		effect_index < 0 ?
-		pimpl_->source_.direct_.props_ :
-		pimpl_->source_.auxes_[effect_index].props_);
+// SchedulerStats
+// ==========================================================================
 
-	send_props = props;
 
-	return true;
-}
+// ==========================================================================
+// Scheduler
 
-bool Api::get_deferred_send_props(
-	const int effect_index,
-	SendProps& send_props) const
+struct SchedulerErrorMessages
 {
-	if (!is_initialized())
-	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
-	}
+	static constexpr auto no_error = "";
+	static constexpr auto allocate_impl = "Failed to allocate implementaion class.";
+	static constexpr auto not_initialized = "Not initialized.";
+	static constexpr auto instance_index_out_of_range = "Instance index is out of range.";
+	static constexpr auto sample_count_out_of_range = "Sample count is out of range.";
+}; // SchedulerErrorMessages
 
-	if (effect_index >= pimpl_->effect_count_)
-	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
-		return false;
-	}
 
-	const auto& props = (
-		effect_index < 0 ?
-		pimpl_->source_.direct_.deferred_props_ :
-		pimpl_->source_.auxes_[effect_index].deferred_props_);
+constexpr const char* SchedulerErrorMessages::no_error;
+constexpr const char* SchedulerErrorMessages::allocate_impl;
+constexpr const char* SchedulerErrorMessages::not_initialized;
+constexpr const char* SchedulerErrorMessages::instance_index_out_of_range;
+constexpr const char* SchedulerErrorMessages::sample_count_out_of_range;
 
-	send_props = props;
 
-	return true;
+Scheduler::Scheduler()
+	:
+	pimpl_{},
+	error_message_{SchedulerErrorMessages::no_error}
+{
 }
 
-bool Api::set_send_props(
-	const int effect_index,
-	const SendProps& send_props)
+Scheduler::~Scheduler()
 {
-	if (!is_initialized())
+	uninitialize();
+}
+
+bool Scheduler::initialize(
+	const int worker_count)
+{
+	uninitialize();
+
+	pimpl_.reset(new (std::nothrow) Impl{});
+
+	if (!pimpl_)
 	{
-		error_message_ = ApiErrorMessages::not_initialized;
+		error_message_ = SchedulerErrorMessages::allocate_impl;
 		return false;
 	}
 
-	if (effect_index >= pimpl_->effect_count_)
+	if (!pimpl_->initialize(worker_count))
 	{
-		error_message_ = ApiErrorMessages::effect_index_out_of_range;
+		error_message_ = pimpl_->error_message_;
+		uninitialize();
 		return false;
 	}
 
-	auto& props = (
-		effect_index < 0 ?
-		pimpl_->source_.direct_.deferred_props_ :
-		pimpl_->source_.auxes_[effect_index].props_);
+	return true;
+}
 
-	props = send_props;
+bool Scheduler::is_initialized() const
+{
+	return pimpl_ != nullptr;
+}
 
-	return true;
+void Scheduler::uninitialize()
+{
+	pimpl_ = nullptr;
 }
 
-bool Api::apply_changes()
+const char* Scheduler::get_error_message() const
+{
+	return error_message_;
+}
+
+int Scheduler::add_instance(
+	const InitParams& init_params)
 {
 	if (!is_initialized())
 	{
-		error_message_ = ApiErrorMessages::not_initialized;
-		return false;
+		error_message_ = SchedulerErrorMessages::not_initialized;
+		return -1;
 	}
 
-	// Effects
-	//
-	for (auto& effect_context : pimpl_->effect_contexts_)
+	const auto instance_index = pimpl_->add_instance(init_params);
+
+	if (instance_index < 0)
 	{
-		effect_context.deferred_effect_.normalize();
+		error_message_ = pimpl_->error_message_;
+	}
 
-		if (!Effect::are_equal(effect_context.deferred_effect_, effect_context.effect_slot_.effect_))
-		{
-			effect_context.effect_slot_.set_effect(pimpl_->device_, effect_context.deferred_effect_);
-		}
+	return instance_index;
+}
+
+int Scheduler::get_instance_count() const
+{
+	if (!is_initialized())
+	{
+		error_message_ = SchedulerErrorMessages::not_initialized;
+		return 0;
 	}
 
-	// Direct send
-	//
-	auto& source = pimpl_->source_;
-	auto& direct_send = source.direct_;
-	direct_send.deferred_props_.normalize();
+	return static_cast<int>(pimpl_->instances_.size());
+}
 
-	if (!SendProps::are_equal(direct_send.deferred_props_, direct_send.props_))
+Api* Scheduler::get_instance(
+	const int instance_index)
+{
+	if (!is_initialized())
 	{
-		source.are_props_changed_ = true;
-		direct_send.props_ = direct_send.deferred_props_;
+		error_message_ = SchedulerErrorMessages::not_initialized;
+		return nullptr;
 	}
 
-	// Aux sends
-	//
-	for (auto& aux_send : source.auxes_)
+	if (instance_index < 0 || instance_index >= static_cast<int>(pimpl_->instances_.size()))
 	{
-		aux_send.deferred_props_.normalize();
-
-		if (!SendProps::are_equal(aux_send.props_, aux_send.deferred_props_))
-		{
-			source.are_props_changed_ = true;
-		}
+		error_message_ = SchedulerErrorMessages::instance_index_out_of_range;
+		return nullptr;
 	}
 
-	return true;
+	return pimpl_->instances_[instance_index].api_.get();
 }
 
-bool Api::mix(
+bool Scheduler::set_block(
+	const int instance_index,
 	const int sample_count,
-	const float* src_samples,
-	float* dst_samples)
+	const float* const src_samples,
+	float* const dst_samples)
 {
 	if (!is_initialized())
 	{
-		error_message_ = ApiErrorMessages::not_initialized;
+		error_message_ = SchedulerErrorMessages::not_initialized;
 		return false;
 	}
 
-	if (sample_count == 0)
-	{
-		return true;
-	}
-
-	if (!src_samples)
+	if (instance_index < 0 || instance_index >= static_cast<int>(pimpl_->instances_.size()))
 	{
-		error_message_ = ApiErrorMessages::no_src_samples;
+		error_message_ = SchedulerErrorMessages::instance_index_out_of_range;
 		return false;
 	}
 
-	if (!dst_samples)
+	if (sample_count < 0)
 	{
-		error_message_ = ApiErrorMessages::no_dst_samples;
+		error_message_ = SchedulerErrorMessages::sample_count_out_of_range;
 		return false;
 	}
 
-	const auto channel_count = pimpl_->device_.channel_count_;
+	auto& instance = pimpl_->instances_[instance_index];
+	instance.sample_count_ = sample_count;
+	instance.src_samples_ = src_samples;
+	instance.dst_samples_ = dst_samples;
 
-	auto buffer_offset = 0;
-	auto remain_count = sample_count;
+	return true;
+}
 
-	while (remain_count > 0)
+bool Scheduler::render()
+{
+	if (!is_initialized())
 	{
-		const auto count = std::min(remain_count, max_sample_buffer_size);
-
-		pimpl_->mix_data(count, &src_samples[buffer_offset], &dst_samples[buffer_offset]);
+		error_message_ = SchedulerErrorMessages::not_initialized;
+		return false;
+	}
 
-		buffer_offset += count * channel_count;
-		remain_count -= count;
+	if (!pimpl_->render())
+	{
+		error_message_ = pimpl_->error_message_;
+		return false;
 	}
 
 	return true;
 }
 
-void Api::uninitialize()
-{
-	pimpl_ = nullptr;
-}
-
-const char* Api::get_error_message() const
-{
-	return pimpl_->error_message_;
-}
-
-int Api::get_min_channels()
+double Scheduler::get_instance_cost(
+	const int instance_index) const
 {
-	return 1;
-}
+	if (!is_initialized())
+	{
+		error_message_ = SchedulerErrorMessages::not_initialized;
+		return 0.0;
+	}
 
-int Api::get_max_channels()
-{
-	return max_channels;
-}
+	if (instance_index < 0 || instance_index >= static_cast<int>(pimpl_->instances_.size()))
+	{
+		error_message_ = SchedulerErrorMessages::instance_index_out_of_range;
+		return 0.0;
+	}
 
-int Api::get_min_sampling_rate()
-{
-	return min_sampling_rate;
+	return pimpl_->instances_[instance_index].cost_;
 }
 
-int Api::get_max_sampling_rate()
+bool Scheduler::get_stats(
+	SchedulerStats& stats) const
 {
-	return max_sampling_rate;
-}
+	if (!is_initialized())
+	{
+		error_message_ = SchedulerErrorMessages::not_initialized;
+		return false;
+	}
 
-int Api::get_min_effects()
-{
-	return min_effects;
-}
+	stats = pimpl_->stats_;
 
-int Api::get_max_effects()
-{
-	return max_effects;
+	return true;
 }
 
-ChannelFormat Api::channel_count_to_channel_format(
-	const int channel_count)
+bool Scheduler::reset_stats()
 {
-	switch (channel_count)
+	if (!is_initialized())
 	{
-	case 1:
-		return ChannelFormat::mono;
-
-	case 2:
-		return ChannelFormat::stereo;
-
-	case 4:
-		return ChannelFormat::quad;
-
-	case 6:
-		return ChannelFormat::five_point_one;
+		error_message_ = SchedulerErrorMessages::not_initialized;
+		return false;
+	}
 
-	case 7:
-		return ChannelFormat::six_point_one;
+	pimpl_->stats_ = SchedulerStats{};
 
-	case 8:
-		return ChannelFormat::seven_point_one;
+	return true;
+}
 
-	default:
-		return ChannelFormat::none;
-	}
+int Scheduler::get_min_workers()
+{
+	return min_scheduler_workers;
 }
 
-int Api::channel_format_to_channel_count(
-	const ChannelFormat channel_format)
+int Scheduler::get_max_workers()
 {
-	return Device::channel_format_to_channel_count(channel_format);
+	return max_scheduler_workers;
 }
 
-// Api
+// Scheduler
 // ==========================================================================
 
 
@@ -3949,6 +8947,11 @@ protected:
 		static_cast<void>(effect_props);
 	}
 
+	int do_get_tail_sample_count() const final
+	{
+		return 0;
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
@@ -3969,28 +8972,140 @@ EffectState* EffectStateFactory::create_null()
 }
 
 
-class ChorusEffectState :
+// A low-frequency oscillator of the modulated delay effects (chorus and flanger).
+//
+// Generates a block of modulated delays at once. The position in the period is
+// stepped without the modulus, and the sinus comes from a quadrature oscillator
+// restarted at each period, so no transcendental functions are called per sample.
+struct ModulationLfo
+{
+	enum class Waveform
+	{
+		triangle,
+		sinusoid,
+	}; // Waveform
+
+
+	Waveform waveform_;
+
+	// The period (in samples).
+	int range_;
+
+	// The position in the period (in samples).
+	int index_;
+
+	// Maps the position to the waveform's argument.
+	float scale_;
+
+	QuadratureOscillator oscillator_;
+
+
+	void reset()
+	{
+		waveform_ = Waveform::triangle;
+		range_ = 1;
+		index_ = 0;
+		scale_ = 0.0F;
+		oscillator_.reset();
+		oscillator_.set_step(0.0F);
+	}
+
+	void set_params(
+		const Waveform waveform,
+		const int range,
+		const float scale)
+	{
+		waveform_ = waveform;
+		range_ = range;
+		scale_ = scale;
+
+		oscillator_.set_step(scale);
+	}
+
+	// Sets the position in the period.
+	void set_index(
+		const int index)
+	{
+		index_ = index;
+
+		oscillator_.set_phase(scale_ * index);
+	}
+
+	// Generates the (fractional) delays modulated by the depth around the base delay.
+	void generate(
+		float* delays,
+		const float depth,
+		const float delay,
+		const int count)
+	{
+		for (int i = 0; i < count; )
+		{
+			// Up to the end of the period.
+			const auto run = std::min(count - i, range_ - index_);
+
+			switch (waveform_)
+			{
+			case Waveform::triangle:
+				for (int k = 0; k < run; ++k)
+				{
+					delays[i + k] = ((1.0F - std::abs(2.0F - (scale_ * (index_ + k)))) * depth) + delay;
+				}
+
+				break;
+
+			case Waveform::sinusoid:
+				for (int k = 0; k < run; ++k)
+				{
+					delays[i + k] = (oscillator_.get_sin() * depth) + delay;
+					oscillator_.advance();
+				}
+
+				break;
+			}
+
+			i += run;
+			index_ += run;
+
+			if (index_ == range_)
+			{
+				index_ = 0;
+				oscillator_.reset();
+			}
+		}
+
+		oscillator_.normalize();
+	}
+}; // ModulationLfo
+
+
+// A modulated delay effect (chorus and flanger).
+//
+// Both sides delay the same input by their own LFO, so they share one buffer
+// with the sides interleaved, and are stepped at once (one side per SIMD lane).
+//
+// The props ("TProps") define the ranges of the effect.
+template<typename TProps, TProps EffectProps::* TPropsMember>
+class ModulatedDelayEffectState :
 	public EffectState
 {
 public:
-	ChorusEffectState()
+	ModulatedDelayEffectState()
 		:
 		EffectState{},
-		sample_buffers_{},
+		sample_buffer_{},
 		buffer_length_{},
 		offset_{},
-		lfo_range_{},
-		lfo_scale_{},
-		lfo_disp_{},
+		lfos_{},
 		sides_gains_{},
 		waveform_{},
 		delay_{},
 		depth_{},
-		feedback_{}
+		feedback_{},
+		is_vectorized_{}
 	{
 	}
 
-	virtual ~ChorusEffectState()
+	virtual ~ModulatedDelayEffectState()
 	{
 	}
 
@@ -3998,45 +9113,47 @@ public:
 protected:
 	void do_construct() final
 	{
+		// Note: The memory is kept to recycle the state.
 		buffer_length_ = 0;
+		sample_buffer_.clear();
+
+		offset_ = 0;
 
-		for (auto& buffer : sample_buffers_)
+		for (auto& lfo : lfos_)
 		{
-			buffer = SampleBuffer{};
+			lfo.reset();
 		}
 
-		offset_ = 0;
-		lfo_range_ = 1;
 		waveform_ = Waveform::triangle;
+
+#ifdef OALSFXPP_X86_SIMD
+		is_vectorized_ = CpuFeatures::get().has_sse2_;
+#else
+		is_vectorized_ = false;
+#endif
 	}
 
 	void do_destruct() final
 	{
-		for (auto& buffer : sample_buffers_)
-		{
-			buffer = SampleBuffer{};
-		}
+		sample_buffer_ = SampleBuffer{};
 	}
 
 	void do_update_device(
 		Device& device) final
 	{
-		auto max_len = static_cast<int>(EffectProps::Chorus::max_delay * 2.0F * device.sampling_rate_) + 1;
+		// Plus one sample for the interpolation.
+		auto max_len = static_cast<int>(TProps::max_delay * 2.0F * device.sampling_rate_) + 2;
 
 		max_len = Math::next_power_of_2(max_len);
 
 		if (max_len != buffer_length_)
 		{
-			sample_buffers_[0].resize(max_len);
-			sample_buffers_[1].resize(max_len);
+			sample_buffer_.resize(side_count * max_len);
 
 			buffer_length_ = max_len;
 		}
 
-		for (auto& buffer : sample_buffers_)
-		{
-			std::fill(buffer.begin(), buffer.end(), 0.0F);
-		}
+		std::fill(sample_buffer_.begin(), sample_buffer_.end(), 0.0F);
 	}
 
 	void do_update(
@@ -4046,24 +9163,25 @@ protected:
 	{
 		static_cast<void>(effect_slot);
 
+		const auto& props = effect_props.*TPropsMember;
 		const auto frequency = static_cast<float>(device.sampling_rate_);
 
-		switch (effect_props.chorus_.waveform_)
+		switch (props.waveform_)
 		{
-		case EffectProps::Chorus::waveform_triangle:
+		case TProps::waveform_triangle:
 			waveform_ = Waveform::triangle;
 			break;
 
-		case EffectProps::Chorus::waveform_sinusoid:
+		case TProps::waveform_sinusoid:
 			waveform_ = Waveform::sinusoid;
 			break;
 		}
 
-		feedback_ = effect_props.chorus_.feedback_;
-		delay_ = static_cast<int>(effect_props.chorus_.delay_ * frequency);
+		feedback_ = props.feedback_;
+		delay_ = static_cast<int>(props.delay_ * frequency);
 
 		// The LFO depth is scaled to be relative to the sample delay.
-		depth_ = effect_props.chorus_.depth_ * delay_;
+		depth_ = props.depth_ * delay_;
 
 		AmbiCoeffs coeffs;
 
@@ -4073,41 +9191,53 @@ protected:
 		Panning::calc_angle_coeffs(Math::pi_2, 0.0F, 0.0F, coeffs);
 		Panning::compute_panning_gains(device.channel_count_, device.dry_, coeffs, 1.0F, sides_gains_[1]);
 
-		const auto phase = effect_props.chorus_.phase_;
-		const auto rate = effect_props.chorus_.rate_;
+		const auto phase = props.phase_;
+		const auto rate = props.rate_;
 
-		if (!(rate > 0.0F))
-		{
-			lfo_scale_ = 0.0F;
-			lfo_range_ = 1;
-			lfo_disp_ = 0;
-		}
-		else
+		auto lfo_range = 1;
+		auto lfo_scale = 0.0F;
+		auto lfo_disp = 0;
+
+		if (rate > 0.0F)
 		{
 			// Calculate LFO coefficient
-			lfo_range_ = static_cast<int>(frequency / rate + 0.5F);
+			lfo_range = static_cast<int>(frequency / rate + 0.5F);
 
 			switch (waveform_)
 			{
 			case Waveform::triangle:
-				lfo_scale_ = 4.0F / lfo_range_;
+				lfo_scale = 4.0F / lfo_range;
 				break;
 
 			case Waveform::sinusoid:
-				lfo_scale_ = Math::tau / lfo_range_;
+				lfo_scale = Math::tau / lfo_range;
 				break;
 			}
 
 			// Calculate lfo phase displacement
 			if (phase >= 0)
 			{
-				lfo_disp_ = static_cast<int>(lfo_range_ * (phase / 360.0F));
+				lfo_disp = static_cast<int>(lfo_range * (phase / 360.0F));
 			}
 			else
 			{
-				lfo_disp_ = static_cast<int>(lfo_range_ * ((360 + phase) / 360.0F));
+				lfo_disp = static_cast<int>(lfo_range * ((360 + phase) / 360.0F));
 			}
 		}
+
+		for (auto& lfo : lfos_)
+		{
+			lfo.set_params(waveform_, lfo_range, lfo_scale);
+		}
+
+		// The right side is displaced by the phase.
+		lfos_[0].set_index(offset_ % lfo_range);
+		lfos_[1].set_index((offset_ + lfo_disp) % lfo_range);
+	}
+
+	int do_get_tail_sample_count() const final
+	{
+		return calc_feedback_tail_sample_count(delay_ + static_cast<int>(std::ceil(depth_)) + 1, feedback_);
 	}
 
 	void do_process(
@@ -4116,93 +9246,36 @@ protected:
 		SampleBuffers& dst_samples,
 		const int channel_count) final
 	{
-		auto& left_buf = sample_buffers_[0];
-		auto& right_buf = sample_buffers_[1];
-		const auto buf_mask = buffer_length_ - 1;
-
 		for (int base = 0; base < sample_count; )
 		{
-			float temps[128][2];
-			int mod_delays[2][128];
-			const auto todo = std::min(128, sample_count - base);
+			SidesSamples sides_samples;
+			SidesSamples mod_delays;
 
-			switch (waveform_)
-			{
-			case Waveform::triangle:
-				get_triangle_delays(
-					mod_delays[0],
-					offset_ % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
-
-				get_triangle_delays(
-					mod_delays[1],
-					(offset_ + lfo_disp_) % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
-
-				break;
+			const auto todo = std::min(max_update_samples, sample_count - base);
 
-			case Waveform::sinusoid:
-				get_sinusoid_delays(
-					mod_delays[0],
-					offset_ % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
-
-				get_sinusoid_delays(
-					mod_delays[1],
-					(offset_ + lfo_disp_) % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
+			lfos_[0].generate(mod_delays[0].data(), depth_, static_cast<float>(delay_), todo);
+			lfos_[1].generate(mod_delays[1].data(), depth_, static_cast<float>(delay_), todo);
 
-				break;
+#ifdef OALSFXPP_X86_SIMD
+			if (is_vectorized_)
+			{
+				process_sides_sse2(todo, &src_samples[0][base], mod_delays, sides_samples);
 			}
-
-			for (int i = 0; i < todo; ++i)
+			else
+#endif
 			{
-				left_buf[offset_ & buf_mask] = src_samples[0][base + i];
-				temps[i][0] = left_buf[(offset_ - mod_delays[0][i]) & buf_mask] * feedback_;
-				left_buf[offset_ & buf_mask] += temps[i][0];
-
-				right_buf[offset_ & buf_mask] = src_samples[0][base + i];
-				temps[i][1] = right_buf[(offset_ - mod_delays[1][i]) & buf_mask] * feedback_;
-				right_buf[offset_ & buf_mask] += temps[i][1];
-
-				offset_ += 1;
+				process_sides(todo, &src_samples[0][base], mod_delays, sides_samples);
 			}
 
 			for (int c = 0; c < channel_count; ++c)
 			{
-				auto channel_gain = sides_gains_[0][c];
-
-				if (std::abs(channel_gain) > silence_threshold_gain)
+				for (int side = 0; side < side_count; ++side)
 				{
-					for (int i = 0; i < todo; ++i)
-					{
-						dst_samples[c][i + base] += temps[i][0] * channel_gain;
-					}
-				}
+					const auto channel_gain = sides_gains_[side][c];
 
-				channel_gain = sides_gains_[1][c];
-
-				if (std::abs(channel_gain) > silence_threshold_gain)
-				{
-					for (int i = 0; i < todo; ++i)
+					if (std::abs(channel_gain) > silence_threshold_gain)
 					{
-						dst_samples[c][i + base] += temps[i][1] * channel_gain;
+						MixHelpers::mul_add(sides_samples[side].data(), channel_gain, &dst_samples[c][base], todo);
 					}
 				}
 			}
@@ -4213,25 +9286,29 @@ protected:
 
 
 private:
-	enum class Waveform
-	{
-		triangle = EffectProps::Chorus::waveform_triangle,
-		sinusoid = EffectProps::Chorus::waveform_sinusoid
-	}; // Waveform
+	// The maximum number of sample frames per update.
+	static constexpr auto max_update_samples = 128;
+
+	// Left and right.
+	static constexpr auto side_count = 2;
 
 
+	using Waveform = ModulationLfo::Waveform;
+
 	using SampleBuffer = EffectSampleBuffer;
-	using SampleBuffers = std::array<SampleBuffer, 2>;
+	using SidesSamples = std::array<std::array<float, max_update_samples>, side_count>;
 
-	using SidesGains = std::array<Gains, 2>;
+	using SidesGains = std::array<Gains, side_count>;
+	using Lfos = std::array<ModulationLfo, side_count>;
 
 
-	SampleBuffers sample_buffers_;
+	// The delayed samples of the sides (interleaved)
+	SampleBuffer sample_buffer_;
 	int buffer_length_;
 	int offset_;
-	int lfo_range_;
-	float lfo_scale_;
-	int lfo_disp_;
+
+	// LFOs for left and right sides
+	Lfos lfos_;
 
 	// Gains for left and right sides
 	SidesGains sides_gains_;
@@ -4242,39 +9319,114 @@ private:
 	float depth_;
 	float feedback_;
 
+	bool is_vectorized_;
 
-	static void get_triangle_delays(
-		int* delays,
-		int offset,
-		const int lfo_range,
-		const float lfo_scale,
-		const float depth,
-		const int delay,
-		const int todo)
+
+	// Delays the input of the sides by the modulated delays, interpolating
+	// between the two nearest samples, and feeds the delayed samples back.
+	//
+	// Note: The input is written before the delayed samples are read, so
+	// delays shorter than a sample read the input itself.
+	void process_sides(
+		const int sample_count,
+		const float* src_samples,
+		const SidesSamples& mod_delays,
+		SidesSamples& sides_samples)
 	{
-		for (int i = 0; i < todo; ++i)
+		const auto mask = buffer_length_ - 1;
+		const auto samples = sample_buffer_.data();
+
+		for (int i = 0; i < sample_count; ++i)
 		{
-			delays[i] = static_cast<int>((1.0F - std::abs(2.0F - (lfo_scale * offset))) * depth) + delay;
-			offset = (offset + 1) % lfo_range;
+			const auto position = side_count * (offset_ & mask);
+
+			for (int side = 0; side < side_count; ++side)
+			{
+				samples[position + side] = src_samples[i];
+			}
+
+			for (int side = 0; side < side_count; ++side)
+			{
+				const auto delay = mod_delays[side][i];
+				const auto whole_delay = static_cast<int>(delay);
+				const auto fraction = delay - static_cast<float>(whole_delay);
+
+				const auto sample = samples[(side_count * ((offset_ - whole_delay) & mask)) + side];
+				const auto next_sample = samples[(side_count * ((offset_ - whole_delay - 1) & mask)) + side];
+
+				const auto delayed_sample = (sample + (fraction * (next_sample - sample))) * feedback_;
+
+				samples[position + side] += delayed_sample;
+				sides_samples[side][i] = delayed_sample;
+			}
+
+			offset_ += 1;
 		}
 	}
 
-	static void get_sinusoid_delays(
-		int* delays,
-		int offset,
-		const int lfo_range,
-		const float lfo_scale,
-		const float depth,
-		const int delay,
-		const int todo)
+#ifdef OALSFXPP_X86_SIMD
+	// Same as "process_sides" with the sides in the two lower lanes.
+	OALSFXPP_TARGET("sse2")
+	void process_sides_sse2(
+		const int sample_count,
+		const float* src_samples,
+		const SidesSamples& mod_delays,
+		SidesSamples& sides_samples)
 	{
-		for (int i = 0; i < todo; ++i)
+		const auto mask = buffer_length_ - 1;
+		const auto samples = sample_buffer_.data();
+		const auto feedback = _mm_set1_ps(feedback_);
+
+		for (int i = 0; i < sample_count; ++i)
 		{
-			delays[i] = static_cast<int>(std::sin(lfo_scale * offset) * depth) + delay;
-			offset = (offset + 1) % lfo_range;
+			const auto position = side_count * (offset_ & mask);
+			const auto src_sample = _mm_set1_ps(src_samples[i]);
+
+			_mm_storel_pi(reinterpret_cast<__m64*>(&samples[position]), src_sample);
+
+			const auto delays = _mm_setr_ps(mod_delays[0][i], mod_delays[1][i], 0.0F, 0.0F);
+			const auto whole_delays = _mm_cvttps_epi32(delays);
+			const auto fractions = _mm_sub_ps(delays, _mm_cvtepi32_ps(whole_delays));
+
+			const auto left_delay = _mm_cvtsi128_si32(whole_delays);
+			const auto right_delay = _mm_cvtsi128_si32(_mm_shuffle_epi32(whole_delays, _MM_SHUFFLE(1, 1, 1, 1)));
+
+			const auto left_position = side_count * ((offset_ - left_delay) & mask);
+			const auto right_position = (side_count * ((offset_ - right_delay) & mask)) + 1;
+			const auto next_left_position = side_count * ((offset_ - left_delay - 1) & mask);
+			const auto next_right_position = (side_count * ((offset_ - right_delay - 1) & mask)) + 1;
+
+			const auto delayed = _mm_setr_ps(
+				samples[left_position],
+				samples[right_position],
+				samples[next_left_position],
+				samples[next_right_position]);
+
+			const auto next_delayed = _mm_movehl_ps(delayed, delayed);
+
+			const auto delayed_samples = _mm_mul_ps(
+				_mm_add_ps(delayed, _mm_mul_ps(fractions, _mm_sub_ps(next_delayed, delayed))),
+				feedback);
+
+			_mm_storel_pi(reinterpret_cast<__m64*>(&samples[position]), _mm_add_ps(src_sample, delayed_samples));
+			_mm_store_ss(&sides_samples[0][i], delayed_samples);
+			_mm_store_ss(&sides_samples[1][i], _mm_shuffle_ps(delayed_samples, delayed_samples, _MM_SHUFFLE(1, 1, 1, 1)));
+
+			offset_ += 1;
 		}
 	}
-}; // ChorusEffectState
+#endif // OALSFXPP_X86_SIMD
+}; // ModulatedDelayEffectState
+
+template<typename TProps, TProps EffectProps::* TPropsMember>
+constexpr int ModulatedDelayEffectState<TProps, TPropsMember>::max_update_samples;
+
+template<typename TProps, TProps EffectProps::* TPropsMember>
+constexpr int ModulatedDelayEffectState<TProps, TPropsMember>::side_count;
+
+
+using ChorusEffectState = ModulatedDelayEffectState<EffectProps::Chorus, &EffectProps::chorus_>;
+using FlangerEffectState = ModulatedDelayEffectState<EffectProps::Flanger, &EffectProps::flanger_>;
 
 
 EffectState* EffectStateFactory::create_chorus()
@@ -4282,6 +9434,11 @@ EffectState* EffectStateFactory::create_chorus()
 	return create<ChorusEffectState>();
 }
 
+EffectState* EffectStateFactory::create_flanger()
+{
+	return create<FlangerEffectState>();
+}
+
 
 class CompressorEffectState :
 	public EffectState
@@ -4349,6 +9506,11 @@ protected:
 		}
 	}
 
+	int do_get_tail_sample_count() const final
+	{
+		return 0;
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
@@ -4553,6 +9715,11 @@ protected:
 		}
 	}
 
+	int do_get_tail_sample_count() const final
+	{
+		return 0;
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
@@ -4587,6 +9754,313 @@ EffectState* EffectStateFactory::create_dedicated()
 }
 
 
+// Changes the sampling rate of the distortion by a power of two.
+//
+// Each octave is a polyphase halfband FIR stage. A halfband filter has zero taps at the even
+// offsets from the center one (0.5), so the interpolator computes the odd output samples only,
+// and the decimator computes the kept output samples only. The stage next to the device rate
+// has a narrow transition band. The other ones only keep the device band, so they are short.
+struct Oversampler
+{
+	static constexpr auto max_factor = max_distortion_oversampling_factor;
+
+	// A maximum number of the samples at the device rate per call.
+	static constexpr auto max_sample_count = 64;
+
+	// A maximum number of the samples at the lower rate of a stage
+	// (a multiple of the vector block).
+	static constexpr auto max_stage_count = (max_sample_count * max_factor) / 2;
+
+	static constexpr auto sharp_coeff_count = 8;
+	static constexpr auto wide_coeff_count = 3;
+
+	static constexpr auto max_wide_stages = 2;
+
+
+	// The taps at the offsets 1, 3, 5, ... from the center (the filter is symmetric).
+	template<int TCoeffCount>
+	using Coeffs = std::array<float, TCoeffCount>;
+
+
+	// The state of a stage which doubles the sampling rate.
+	template<int TCoeffCount>
+	struct Interpolator
+	{
+		static constexpr auto history_size = (2 * TCoeffCount) - 1;
+
+
+		// The history followed by the input.
+		std::array<float, history_size + max_stage_count> samples_;
+
+
+		void reset()
+		{
+			samples_.fill(0.0F);
+		}
+	}; // Interpolator
+
+	// The state of a stage which halves the sampling rate.
+	//
+	// The center tap is at the even phase, and the other ones are at the odd phase.
+	template<int TCoeffCount>
+	struct Decimator
+	{
+		static constexpr auto even_history_size = TCoeffCount - 1;
+		static constexpr auto odd_history_size = (2 * TCoeffCount) - 1;
+
+
+		// The history followed by the input (per phase).
+		std::array<float, even_history_size + max_stage_count> even_samples_;
+		std::array<float, odd_history_size + max_stage_count> odd_samples_;
+
+
+		void reset()
+		{
+			even_samples_.fill(0.0F);
+			odd_samples_.fill(0.0F);
+		}
+	}; // Decimator
+
+
+	static const Coeffs<sharp_coeff_count> sharp_coeffs;
+	static const Coeffs<wide_coeff_count> wide_coeffs;
+
+
+	int factor_;
+
+	// A number of the wide stages in each direction.
+	int wide_stage_count_;
+
+	bool is_vectorized_;
+
+	Interpolator<sharp_coeff_count> sharp_interpolator_;
+	std::array<Interpolator<wide_coeff_count>, max_wide_stages> wide_interpolators_;
+
+	Decimator<sharp_coeff_count> sharp_decimator_;
+	std::array<Decimator<wide_coeff_count>, max_wide_stages> wide_decimators_;
+
+
+	void reset(
+		const int factor)
+	{
+		factor_ = factor;
+		wide_stage_count_ = 0;
+
+		for (auto i = factor; i > 2; i /= 2)
+		{
+			wide_stage_count_ += 1;
+		}
+
+#ifdef OALSFXPP_X86_SIMD
+		is_vectorized_ = CpuFeatures::get().has_sse2_;
+#else
+		is_vectorized_ = false;
+#endif
+
+		sharp_interpolator_.reset();
+		sharp_decimator_.reset();
+
+		for (int i = 0; i < max_wide_stages; ++i)
+		{
+			wide_interpolators_[i].reset();
+			wide_decimators_[i].reset();
+		}
+	}
+
+	// Upsamples "count" samples into "count * factor" ones (in place).
+	void upsample(
+		const int count,
+		float* samples)
+	{
+		if (factor_ == 1)
+		{
+			return;
+		}
+
+		interpolate(sharp_interpolator_, sharp_coeffs.data(), count, samples);
+
+		for (int i = 0; i < wide_stage_count_; ++i)
+		{
+			interpolate(wide_interpolators_[i], wide_coeffs.data(), count << (i + 1), samples);
+		}
+	}
+
+	// Downsamples "count * factor" samples into "count" ones (in place).
+	void downsample(
+		const int count,
+		float* samples)
+	{
+		if (factor_ == 1)
+		{
+			return;
+		}
+
+		for (int i = wide_stage_count_ - 1; i >= 0; --i)
+		{
+			decimate(wide_decimators_[i], wide_coeffs.data(), count << (i + 1), samples);
+		}
+
+		decimate(sharp_decimator_, sharp_coeffs.data(), count, samples);
+	}
+
+	// Interpolates "count" samples into "2 * count" ones (in place).
+	template<int TCoeffCount>
+	void interpolate(
+		Interpolator<TCoeffCount>& stage,
+		const float* coeffs,
+		const int count,
+		float* samples)
+	{
+		using Stage = Interpolator<TCoeffCount>;
+
+		std::copy_n(samples, count, &stage.samples_[Stage::history_size]);
+
+		// The odd output samples are halfway between the input ones.
+		const auto center = &stage.samples_[TCoeffCount - 1];
+
+		float sums[max_stage_count];
+
+		convolve<TCoeffCount>(coeffs, count, center, sums);
+
+		// Zero stuffing halves the gain.
+		for (int i = 0; i < count; ++i)
+		{
+			samples[(2 * i) + 0] = center[i];
+			samples[(2 * i) + 1] = 2.0F * sums[i];
+		}
+
+		std::copy_n(&stage.samples_[count], Stage::history_size, stage.samples_.begin());
+	}
+
+	// Decimates "2 * count" samples into "count" ones (in place).
+	template<int TCoeffCount>
+	void decimate(
+		Decimator<TCoeffCount>& stage,
+		const float* coeffs,
+		const int count,
+		float* samples)
+	{
+		using Stage = Decimator<TCoeffCount>;
+
+		for (int i = 0; i < count; ++i)
+		{
+			stage.even_samples_[Stage::even_history_size + i] = samples[(2 * i) + 0];
+			stage.odd_samples_[Stage::odd_history_size + i] = samples[(2 * i) + 1];
+		}
+
+		float sums[max_stage_count];
+
+		convolve<TCoeffCount>(coeffs, count, &stage.odd_samples_[TCoeffCount - 1], sums);
+
+		for (int i = 0; i < count; ++i)
+		{
+			samples[i] = (0.5F * stage.even_samples_[i]) + sums[i];
+		}
+
+		std::copy_n(&stage.even_samples_[count], Stage::even_history_size, stage.even_samples_.begin());
+		std::copy_n(&stage.odd_samples_[count], Stage::odd_history_size, stage.odd_samples_.begin());
+	}
+
+	// Convolves the points halfway between the consecutive samples with the taps.
+	template<int TCoeffCount>
+	void convolve(
+		const float* coeffs,
+		const int count,
+		const float* samples,
+		float* sums)
+	{
+#ifdef OALSFXPP_X86_SIMD
+		if (is_vectorized_)
+		{
+			convolve_sse2<TCoeffCount>(coeffs, count, samples, sums);
+			return;
+		}
+#endif
+
+		for (int i = 0; i < count; ++i)
+		{
+			auto sum = 0.0F;
+
+			for (int k = 0; k < TCoeffCount; ++k)
+			{
+				sum += coeffs[k] * (samples[i - k] + samples[i + 1 + k]);
+			}
+
+			sums[i] = sum;
+		}
+	}
+
+#ifdef OALSFXPP_X86_SIMD
+	// Convolves eight points at once, in two vectors to overlap the dependency chains.
+	//
+	// The count is rounded up to eight; the windows have room for it.
+	template<int TCoeffCount>
+	OALSFXPP_TARGET("sse2")
+	static void convolve_sse2(
+		const float* coeffs,
+		const int count,
+		const float* samples,
+		float* sums)
+	{
+		for (int i = 0; i < count; i += 8)
+		{
+			auto sum_0 = _mm_setzero_ps();
+			auto sum_1 = _mm_setzero_ps();
+
+			for (int k = 0; k < TCoeffCount; ++k)
+			{
+				const auto coeff = _mm_set1_ps(coeffs[k]);
+
+				const auto pair_0 = _mm_add_ps(
+					_mm_loadu_ps(&samples[i - k]),
+					_mm_loadu_ps(&samples[i + 1 + k]));
+
+				const auto pair_1 = _mm_add_ps(
+					_mm_loadu_ps(&samples[i + 4 - k]),
+					_mm_loadu_ps(&samples[i + 5 + k]));
+
+				sum_0 = _mm_add_ps(sum_0, _mm_mul_ps(coeff, pair_0));
+				sum_1 = _mm_add_ps(sum_1, _mm_mul_ps(coeff, pair_1));
+			}
+
+			_mm_storeu_ps(&sums[i + 0], sum_0);
+			_mm_storeu_ps(&sums[i + 4], sum_1);
+		}
+	}
+#endif // OALSFXPP_X86_SIMD
+}; // Oversampler
+
+
+constexpr int Oversampler::max_factor;
+constexpr int Oversampler::max_sample_count;
+constexpr int Oversampler::max_stage_count;
+constexpr int Oversampler::sharp_coeff_count;
+constexpr int Oversampler::wide_coeff_count;
+constexpr int Oversampler::max_wide_stages;
+
+// Equiripple designs; about 57 dB of the stopband attenuation for the sharp stage
+// (the band edges are at 80% and 120% of the lower rate's Nyquist frequency),
+// and about 68 dB for the wide ones (40% and 160%).
+const Oversampler::Coeffs<Oversampler::sharp_coeff_count> Oversampler::sharp_coeffs =
+{
+	0.315678414F,
+	-0.0984185534F,
+	0.0515235142F,
+	-0.0297830101F,
+	0.0172080125F,
+	-0.0094264236F,
+	0.00464942576F,
+	-0.00210805654F,
+}; // sharp_coeffs
+
+const Oversampler::Coeffs<Oversampler::wide_coeff_count> Oversampler::wide_coeffs =
+{
+	0.298594877F,
+	-0.0581235452F,
+	0.00971330949F,
+}; // wide_coeffs
+
+
 class DistortionEffectState :
 	public EffectState
 {
@@ -4597,8 +10071,10 @@ public:
 		gains_{},
 		low_pass_{},
 		band_pass_{},
+		oversampler_{},
 		attenuation_{},
-		edge_coeff_{}
+		edge_coeff_{},
+		tail_sample_count_{}
 	{
 	}
 
@@ -4608,10 +10084,19 @@ public:
 
 
 protected:
+	// The filters run at the device rate, but were designed at this oversampling factor,
+	// so their Q is derived at it to keep the response independent of the factor.
+	static constexpr auto design_factor = 4.0F;
+
+	// A maximum filter frequency relative to the device rate.
+	static constexpr auto max_freq_mult = 0.49F;
+
+
 	void do_construct() final
 	{
 		low_pass_.clear();
 		band_pass_.clear();
+		oversampler_.reset(1);
 	}
 
 	void do_destruct() final
@@ -4621,7 +10106,11 @@ protected:
 	void do_update_device(
 		Device& device) final
 	{
-		static_cast<void>(device);
+		low_pass_.clear();
+		band_pass_.clear();
+		oversampler_.reset(device.distortion_oversampling_factor_);
+
+		tail_sample_count_ = calc_filter_tail_sample_count(device.sampling_rate_);
 	}
 
 	void do_update(
@@ -4646,13 +10135,11 @@ protected:
 		// Bandwidth value is constant in octaves.
 		auto bandwidth = (cutoff / 2.0F) / (cutoff * 0.67F);
 
-		// Multiply sampling frequency by the amount of oversampling done during
-		// processing.
 		low_pass_.set_params(
 			FilterType::low_pass,
 			1.0F,
-			cutoff / (frequency * 4.0F),
-			FilterState::calc_rcp_q_from_bandwidth(cutoff / (frequency * 4.0F), bandwidth));
+			std::min(cutoff / frequency, max_freq_mult),
+			FilterState::calc_rcp_q_from_bandwidth(cutoff / (frequency * design_factor), bandwidth));
 
 		cutoff = effect_props.distortion_.eq_center_;
 
@@ -4662,8 +10149,8 @@ protected:
 		band_pass_.set_params(
 			FilterType::band_pass,
 			1.0F,
-			cutoff / (frequency * 4.0F),
-			FilterState::calc_rcp_q_from_bandwidth(cutoff / (frequency * 4.0F), bandwidth));
+			std::min(cutoff / frequency, max_freq_mult),
+			FilterState::calc_rcp_q_from_bandwidth(cutoff / (frequency * design_factor), bandwidth));
 
 		Panning::compute_ambient_gains(
 			device.channel_count_,
@@ -4672,65 +10159,46 @@ protected:
 			gains_);
 	}
 
+	int do_get_tail_sample_count() const final
+	{
+		return tail_sample_count_;
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
 		SampleBuffers& dst_samples,
 		const int channel_count) final
 	{
-		const auto fc = edge_coeff_;
+		const auto factor = oversampler_.factor_;
 
 		for (int base = 0; base < sample_count; )
 		{
-			float buffer[2][64 * 4];
-
-			const auto td = std::min(64, sample_count - base);
-
-			// Perform 4x oversampling to avoid aliasing. Oversampling greatly
-			// improves distortion quality and allows to implement lowpass and
-			// bandpass filters using high frequencies, at which classic IIR
-			// filters became unstable.
+			float buffer[2][Oversampler::max_sample_count * Oversampler::max_factor];
 
-			// Fill oversample buffer using zero stuffing.
-			for (int it = 0; it < td; ++it)
-			{
-				// Multiply the sample by the amount of oversampling to maintain
-				// the signal's power.
+			const auto td = std::min(Oversampler::max_sample_count, sample_count - base);
 
-				buffer[0][(it * 4) + 0] = src_samples[0][it + base] * 4.0F;
-				buffer[0][(it * 4) + 1] = 0.0F;
-				buffer[0][(it * 4) + 2] = 0.0F;
-				buffer[0][(it * 4) + 3] = 0.0F;
-			}
+			// First step, do lowpass filtering of original signal.
+			low_pass_.process(td, &src_samples[0][base], buffer[0]);
 
-			// First step, do lowpass filtering of original signal. Additionally
-			// perform buffer interpolation and lowpass cutoff for oversampling
-			// (which is fortunately first step of distortion). So combine three
-			// operations into the one.
-			low_pass_.process(td * 4, buffer[0], buffer[1]);
+			// Oversample to avoid aliasing of the harmonics produced by
+			// the waveshaper. Oversampling greatly improves distortion quality.
+			oversampler_.upsample(td, buffer[0]);
 
 			// Second step, do distortion using waveshaper function to emulate
 			// signal processing during tube overdriving. Three steps of
 			// waveshaping are intended to modify waveform without boost/clipping/
 			// attenuation process.
-			for (int it = 0; it < td * 4; it++)
-			{
-				auto smp = buffer[1][it];
-
-				smp = (1.0F + fc) * smp / (1.0F + (fc * std::abs(smp)));
-				smp = (1.0F + fc) * smp / (1.0F + (fc * std::abs(smp))) * -1.0F;
-				smp = (1.0F + fc) * smp / (1.0F + (fc * std::abs(smp)));
+			WaveshaperHelpers::process(edge_coeff_, td * factor, buffer[0]);
 
-				buffer[0][it] = smp;
-			}
+			oversampler_.downsample(td, buffer[0]);
 
 			// Third step, do bandpass filtering of distorted signal.
-			band_pass_.process(td * 4, buffer[0], buffer[1]);
+			band_pass_.process(td, buffer[0], buffer[1]);
 
 			for (int kt = 0; kt < channel_count; ++kt)
 			{
-				// Fourth step, final, do attenuation and perform decimation,
-				// store only one sample out of 4.
+				// Fourth step, final, do attenuation.
 
 				const auto gain = gains_[kt] * attenuation_;
 
@@ -4741,7 +10209,7 @@ protected:
 
 				for (int it = 0; it < td; ++it)
 				{
-					dst_samples[kt][base + it] += gain * buffer[1][it * 4];
+					dst_samples[kt][base + it] += gain * buffer[1][it];
 				}
 			}
 
@@ -4757,11 +10225,17 @@ private:
 	// Effect parameters
 	FilterState low_pass_;
 	FilterState band_pass_;
+	Oversampler oversampler_;
 	float attenuation_;
 	float edge_coeff_;
+	int tail_sample_count_;
 }; // DistortionEffectState
 
 
+constexpr float DistortionEffectState::design_factor;
+constexpr float DistortionEffectState::max_freq_mult;
+
+
 EffectState* EffectStateFactory::create_distortion()
 {
 	return create<DistortionEffectState>();
@@ -4799,8 +10273,9 @@ public:
 protected:
 	void do_construct() final
 	{
+		// Note: The memory is kept to recycle the state.
 		buffer_length_ = 0;
-		sample_buffer_ = EffectSampleBuffer{};
+		sample_buffer_.clear();
 
 		taps_[0].delay = 0;
 		taps_[1].delay = 0;
@@ -4884,106 +10359,241 @@ protected:
 		Panning::compute_panning_gains(device.channel_count_, device.dry_, coeffs, effect_gain, taps_gains_[1]);
 	}
 
+	int do_get_tail_sample_count() const final
+	{
+		// The second tap is the end of the feedback loop.
+		return calc_feedback_tail_sample_count(taps_[1].delay, feed_gain_);
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
 		SampleBuffers& dst_samples,
 		const int channel_count) final
+	{
+		for (int base = 0; base < sample_count; )
+		{
+			TapsSamples taps_samples;
+
+			const auto td = std::min(max_update_samples, sample_count - base);
+			const auto src = &src_samples[0][base];
+
+			// The second tap is never shorter than the first one, so with the first tap
+			// at least one update long the taps read only the samples of the previous updates.
+			if (taps_[0].delay >= td)
+			{
+				process_block(td, src, taps_samples);
+			}
+			else
+			{
+				process_samples(td, src, taps_samples);
+			}
+
+			for (int k = 0; k < channel_count; ++k)
+			{
+				auto channel_gain = taps_gains_[0][k];
+
+				if (std::abs(channel_gain) > silence_threshold_gain)
+				{
+					for (int i = 0; i < td; ++i)
+					{
+						dst_samples[k][i + base] += taps_samples[0][i] * channel_gain;
+					}
+				}
+
+				channel_gain = taps_gains_[1][k];
+
+				if (std::abs(channel_gain) > silence_threshold_gain)
+				{
+					for (int i = 0; i < td; ++i)
+					{
+						dst_samples[k][i + base] += taps_samples[1][i] * channel_gain;
+					}
+				}
+			}
+
+			base += td;
+		}
+	}
+
+
+private:
+	// The maximum number of sample frames per update.
+	static constexpr auto max_update_samples = 128;
+
+
+	using Taps = std::array<Tap, 2>;
+	using TapsGains = std::array<Gains, 2>;
+	using UpdateSamples = std::array<float, max_update_samples>;
+	using TapsSamples = std::array<UpdateSamples, 2>;
+
+
+	EffectSampleBuffer sample_buffer_;
+	int buffer_length_;
+
+	// The echo is two tap. The delay is the number of samples from before the
+	// current offset
+	Taps taps_;
+
+	int offset_;
+
+	// The panning gains for the two taps
+	TapsGains taps_gains_;
+
+	float feed_gain_;
+
+	FilterState filter_;
+
+
+	// Processes the update sample by sample, so the taps may read the samples
+	// written during the update.
+	void process_samples(
+		const int sample_count,
+		const float* src_samples,
+		TapsSamples& taps_samples)
 	{
 		const auto mask = buffer_length_ - 1;
 		const auto tap1 = taps_[0].delay;
 		const auto tap2 = taps_[1].delay;
-		float x[2] = {filter_.x_[0], filter_.x_[1], };
-		float y[2] = {filter_.y_[0], filter_.y_[1], };
+		const auto feed_gain = feed_gain_;
 
-		for (int base = 0; base < sample_count; )
+		const auto b0 = filter_.b0_;
+		const auto b1 = filter_.b1_;
+		const auto b2 = filter_.b2_;
+		const auto a1 = filter_.a1_;
+		const auto a2 = filter_.a2_;
+
+		auto x1 = filter_.x_[0];
+		auto x2 = filter_.x_[1];
+		auto y1 = filter_.y_[0];
+		auto y2 = filter_.y_[1];
+
+		for (int i = 0; i < sample_count; ++i)
 		{
-			float temps[128][2];
+			// First tap
+			taps_samples[0][i] = sample_buffer_[(offset_ - tap1) & mask];
 
-			const auto td = std::min(128, sample_count - base);
+			// Second tap
+			taps_samples[1][i] = sample_buffer_[(offset_ - tap2) & mask];
 
-			for (int i = 0; i < td; ++i)
-			{
-				// First tap
-				temps[i][0] = sample_buffer_[(offset_ - tap1) & mask];
+			// Apply damping and feedback gain to the second tap, and mix in the
+			// new sample. The last output sample is subtracted last, which keeps
+			// the other terms out of the dependency chain between the samples.
+			const auto in = taps_samples[1][i] + src_samples[i];
+			const auto out = ((b0 * in) + (b1 * x1) + (b2 * x2) - (a2 * y2)) - (a1 * y1);
+
+			x2 = x1;
+			x1 = in;
+			y2 = y1;
+			y1 = out;
+
+			sample_buffer_[offset_&mask] = out * feed_gain;
+
+			offset_ += 1;
+		}
 
-				// Second tap
-				temps[i][1] = sample_buffer_[(offset_ - tap2) & mask];
+		filter_.x_[0] = x1;
+		filter_.x_[1] = x2;
+		filter_.y_[0] = y1;
+		filter_.y_[1] = y2;
+	}
 
-				// Apply damping and feedback gain to the second tap, and mix in the
-				// new sample
-				auto in = temps[i][1] + src_samples[0][i + base];
+	// Processes the update as a whole.
+	//
+	// Note: The taps should be at least as long as the update.
+	void process_block(
+		const int sample_count,
+		const float* src_samples,
+		TapsSamples& taps_samples)
+	{
+		UpdateSamples out_samples;
 
-				auto out = (in * filter_.b0_) +
-					(x[0] * filter_.b1_) + (x[1] * filter_.b2_) -
-					(y[0] * filter_.a1_) - (y[1] * filter_.a2_);
+		read_tap(taps_[0].delay, sample_count, taps_samples[0].data());
+		read_tap(taps_[1].delay, sample_count, taps_samples[1].data());
 
-				x[1] = x[0];
-				x[0] = in;
+		const auto b0 = filter_.b0_;
+		const auto b1 = filter_.b1_;
+		const auto b2 = filter_.b2_;
+		const auto a1 = filter_.a1_;
+		const auto a2 = filter_.a2_;
 
-				y[1] = y[0];
-				y[0] = out;
+		// The first output sample of a pair is substituted into the feedback of
+		// the second one, so both samples depend on the previous pair only.
+		const auto a1_ahead = (a1 * a1) - a2;
+		const auto a2_ahead = a1 * a2;
 
-				sample_buffer_[offset_&mask] = out * feed_gain_;
+		auto x1 = filter_.x_[0];
+		auto x2 = filter_.x_[1];
+		auto y1 = filter_.y_[0];
+		auto y2 = filter_.y_[1];
 
-				offset_ += 1;
-			}
+		// Apply damping to the second tap, and mix in the new samples
+		auto i = 0;
 
-			for (int k = 0; k < channel_count; ++k)
-			{
-				auto channel_gain = taps_gains_[0][k];
+		for ( ; (i + 2) <= sample_count; i += 2)
+		{
+			const auto in0 = taps_samples[1][i] + src_samples[i];
+			const auto in1 = taps_samples[1][i + 1] + src_samples[i + 1];
 
-				if (std::abs(channel_gain) > silence_threshold_gain)
-				{
-					for (int i = 0; i < td; ++i)
-					{
-						dst_samples[k][i + base] += temps[i][0] * channel_gain;
-					}
-				}
+			const auto f0 = (b0 * in0) + (b1 * x1) + (b2 * x2);
+			const auto f1 = (b0 * in1) + (b1 * in0) + (b2 * x1);
 
-				channel_gain = taps_gains_[1][k];
+			const auto out0 = (f0 - (a2 * y2)) - (a1 * y1);
+			const auto out1 = (f1 - (a1 * f0) + (a2_ahead * y2)) + (a1_ahead * y1);
 
-				if (std::abs(channel_gain) > silence_threshold_gain)
-				{
-					for (int i = 0; i < td; ++i)
-					{
-						dst_samples[k][i + base] += temps[i][1] * channel_gain;
-					}
-				}
-			}
+			x2 = in0;
+			x1 = in1;
+			y2 = out0;
+			y1 = out1;
 
-			base += td;
+			out_samples[i] = out0;
+			out_samples[i + 1] = out1;
 		}
 
-		filter_.x_[0] = x[0];
-		filter_.x_[1] = x[1];
-		filter_.y_[0] = y[0];
-		filter_.y_[1] = y[1];
-	}
-
+		if (i < sample_count)
+		{
+			const auto in = taps_samples[1][i] + src_samples[i];
+			const auto out = ((b0 * in) + (b1 * x1) + (b2 * x2) - (a2 * y2)) - (a1 * y1);
 
-private:
-	using Taps = std::array<Tap, 2>;
-	using TapsGains = std::array<Gains, 2>;
+			x2 = x1;
+			x1 = in;
+			y2 = y1;
+			y1 = out;
 
+			out_samples[i] = out;
+		}
 
-	EffectSampleBuffer sample_buffer_;
-	int buffer_length_;
+		filter_.x_[0] = x1;
+		filter_.x_[1] = x2;
+		filter_.y_[0] = y1;
+		filter_.y_[1] = y2;
 
-	// The echo is two tap. The delay is the number of samples from before the
-	// current offset
-	Taps taps_;
+		// Apply feedback gain, wrapping around the end of the buffer
+		const auto offset = offset_ & (buffer_length_ - 1);
+		const auto head_count = std::min(sample_count, buffer_length_ - offset);
 
-	int offset_;
+		MixHelpers::mul(out_samples.data(), feed_gain_, &sample_buffer_[offset], head_count);
+		MixHelpers::mul(out_samples.data() + head_count, feed_gain_, &sample_buffer_[0], sample_count - head_count);
 
-	// The panning gains for the two taps
-	TapsGains taps_gains_;
+		offset_ += sample_count;
+	}
 
-	float feed_gain_;
+	// Copies the samples of the tap, wrapping around the end of the buffer.
+	void read_tap(
+		const int delay,
+		const int sample_count,
+		float* samples) const
+	{
+		const auto offset = (offset_ - delay) & (buffer_length_ - 1);
+		const auto head_count = std::min(sample_count, buffer_length_ - offset);
 
-	FilterState filter_;
+		std::copy_n(&sample_buffer_[offset], head_count, samples);
+		std::copy_n(&sample_buffer_[0], sample_count - head_count, &samples[head_count]);
+	}
 }; // EchoEffectState
 
+constexpr int EchoEffectState::max_update_samples;
+
 
 EffectState* EffectStateFactory::create_echo()
 {
@@ -5040,7 +10650,10 @@ public:
 		EffectState{},
 		channels_gains_{},
 		filter_{},
-		sample_buffer_{}
+		active_filters_{},
+		active_filter_count_{},
+		sample_buffer_{},
+		tail_sample_count_{}
 	{
 	}
 
@@ -5054,502 +10667,249 @@ protected:
 	{
 		// Initialize sample history only on filter creation to avoid
 		// sound clicks if filter settings were changed in runtime.
-		for (int it = 0; it < 4; ++it)
+		for (auto& filter : filter_)
 		{
-			for (int ft = 0; ft < max_effect_channels; ++ft)
-			{
-				filter_[it][ft].clear();
-			}
+			filter.clear();
 		}
 	}
 
 	void do_destruct()
-	{
-	}
-
-	void do_update_device(
-		Device& device)
-	{
-		static_cast<void>(device);
-	}
-
-	void do_update(
-		Device& device,
-		const EffectSlot& effect_slot,
-		const EffectProps& effect_props)
-	{
-		static_cast<void>(effect_slot);
-
-		const auto frequency = static_cast<float>(device.sampling_rate_);
-		float gain;
-		float freq_mult;
-
-		dst_buffers_ = &device.sample_buffers_;
-		dst_channel_count_ = device.channel_count_;
-
-		for (int i = 0; i < max_effect_channels; ++i)
-		{
-			Panning::compute_first_order_gains(
-				device.channel_count_,
-				device.foa_,
-				mat4f_identity.m_[i],
-				1.0F,
-				channels_gains_[i]);
-		}
-
-		// Calculate coefficients for the each type of filter. Note that the shelf
-		// filters' gain is for the reference frequency, which is the centerpoint
-		// of the transition band.
-		gain = std::max(std::sqrt(effect_props.equalizer_.low_gain_), 0.0625F); // Limit -24dB
-		freq_mult = effect_props.equalizer_.low_cutoff_ / frequency;
-
-		filter_[0][0].set_params(
-			FilterType::low_shelf,
-			gain,
-			freq_mult,
-			FilterState::calc_rcp_q_from_slope(gain, 0.75F));
-
-		// Copy the filter coefficients for the other input channels.
-		for (int i = 1; i < max_effect_channels; ++i)
-		{
-			FilterState::copy_params(filter_[0][0], filter_[0][i]);
-		}
-
-		gain = std::max(effect_props.equalizer_.mid1_gain_, 0.0625F);
-		freq_mult = effect_props.equalizer_.mid1_center_ / frequency;
-
-		filter_[1][0].set_params(
-			FilterType::peaking,
-			gain,
-			freq_mult,
-			FilterState::calc_rcp_q_from_bandwidth(freq_mult, effect_props.equalizer_.mid1_width_));
-
-		for (int i = 1; i < max_effect_channels; ++i)
-		{
-			FilterState::copy_params(filter_[1][0], filter_[1][i]);
-		}
-
-		gain = std::max(effect_props.equalizer_.mid2_gain_, 0.0625F);
-		freq_mult = effect_props.equalizer_.mid2_center_ / frequency;
-
-		filter_[2][0].set_params(
-			FilterType::peaking,
-			gain,
-			freq_mult,
-			FilterState::calc_rcp_q_from_bandwidth(freq_mult, effect_props.equalizer_.mid2_width_));
-
-		for (int i = 1; i < max_effect_channels; ++i)
-		{
-			FilterState::copy_params(filter_[2][0], filter_[2][i]);
-		}
-
-		gain = std::max(std::sqrt(effect_props.equalizer_.high_gain_), 0.0625F);
-		freq_mult = effect_props.equalizer_.high_cutoff_ / frequency;
-
-		filter_[3][0].set_params(
-			FilterType::high_shelf,
-			gain,
-			freq_mult,
-			FilterState::calc_rcp_q_from_slope(gain, 0.75F));
-
-		for (int i = 1; i < max_effect_channels; ++i)
-		{
-			FilterState::copy_params(filter_[3][0], filter_[3][i]);
-		}
-	}
-
-	void do_process(
-		const int sample_count,
-		const SampleBuffers& src_samples,
-		SampleBuffers& dst_samples,
-		const int channel_count)
-	{
-		auto& samples = sample_buffer_;
-
-		for (int base = 0; base < sample_count; )
-		{
-			const auto td = std::min(max_update_samples, sample_count - base);
-
-			for (int ft = 0; ft < max_effect_channels; ++ft)
-			{
-				filter_[0][ft].process(td, &src_samples[ft][base], samples[0][ft].data());
-			}
-
-			for (int ft = 0; ft < max_effect_channels; ++ft)
-			{
-				filter_[1][ft].process(td, samples[0][ft].data(), samples[1][ft].data());
-			}
-
-			for (int ft = 0; ft < max_effect_channels; ++ft)
-			{
-				filter_[2][ft].process(td, samples[1][ft].data(), samples[2][ft].data());
-			}
-
-			for (int ft = 0; ft < max_effect_channels; ++ft)
-			{
-				filter_[3][ft].process(td, samples[2][ft].data(), samples[3][ft].data());
-			}
-
-			for (int ft = 0; ft < max_effect_channels; ++ft)
-			{
-				for (int kt = 0; kt < channel_count; ++kt)
-				{
-					const auto gain = channels_gains_[ft][kt];
-
-					if (!(std::abs(gain) > silence_threshold_gain))
-					{
-						continue;
-					}
-
-					for (int it = 0; it < td; ++it)
-					{
-						dst_samples[kt][base + it] += gain * samples[3][ft][it];
-					}
-				}
-			}
-
-			base += td;
-		}
-	}
-
-
-private:
-	// The maximum number of sample frames per update.
-	static constexpr auto max_update_samples = 256;
-
-	using ChannelsGains = std::array<Gains, max_effect_channels>;
-	using Filters = MdArray<FilterState, 4, max_effect_channels>;
-	using SampleBuffers = MdArray<float, 4, max_effect_channels, max_update_samples>;
-
-
-	// Effect gains for each channel
-	ChannelsGains channels_gains_;
-
-	// Effect parameters
-	Filters filter_;
-
-	SampleBuffers sample_buffer_;
-}; // EqualizerEffectState
-
-constexpr int EqualizerEffectState::max_update_samples;
-
-
-EffectState* EffectStateFactory::create_equalizer()
-{
-	return create<EqualizerEffectState>();
-}
-
-
-class FlangerEffectState :
-	public EffectState
-{
-public:
-	FlangerEffectState()
-		:
-		EffectState{},
-		sample_buffers_{},
-		buffer_length_{},
-		offset_{},
-		lfo_range_{},
-		lfo_scale_{},
-		lfo_disp_{},
-		sides_gains_{},
-		waveform_{},
-		delay_{},
-		depth_{},
-		feedback_{}
-	{
-	}
-
-	virtual ~FlangerEffectState()
-	{
-	}
-
-
-protected:
-	void do_construct() final
-	{
-		buffer_length_ = 0;
-
-		for (auto& buffer : sample_buffers_)
-		{
-			buffer = SampleBuffer{};
-		}
-
-		offset_ = 0;
-		lfo_range_ = 1;
-		waveform_ = Waveform::triangle;
-	}
-
-	void do_destruct() final
-	{
-		for (auto& buffer : sample_buffers_)
-		{
-			buffer = SampleBuffer{};
-		}
-	}
-
-	void do_update_device(
-		Device& device) final
-	{
-		auto maxlen = static_cast<int>(EffectProps::Flanger::max_delay * 2.0F * device.sampling_rate_) + 1;
-		maxlen = Math::next_power_of_2(maxlen);
-
-		if (maxlen != buffer_length_)
-		{
-			for (auto& buffer : sample_buffers_)
-			{
-				buffer.resize(maxlen);
-			}
-
-			buffer_length_ = maxlen;
-		}
+	{
+	}
 
-		for (auto& buffer : sample_buffers_)
-		{
-			std::fill(buffer.begin(), buffer.end(), 0.0F);
-		}
+	void do_update_device(
+		Device& device)
+	{
+		tail_sample_count_ = calc_filter_tail_sample_count(device.sampling_rate_);
 	}
 
 	void do_update(
 		Device& device,
 		const EffectSlot& effect_slot,
-		const EffectProps& effect_props) final
+		const EffectProps& effect_props)
 	{
 		static_cast<void>(effect_slot);
 
 		const auto frequency = static_cast<float>(device.sampling_rate_);
-		AmbiCoeffs coeffs;
+		float gain;
+		float freq_mult;
+		FilterState filter;
 
-		switch (effect_props.flanger_.waveform_)
-		{
-		case EffectProps::Flanger::waveform_triangle:
-			waveform_ = Waveform::triangle;
-			break;
+		dst_buffers_ = &device.sample_buffers_;
+		dst_channel_count_ = device.channel_count_;
 
-		case EffectProps::Flanger::waveform_sinusoid:
-			waveform_ = Waveform::sinusoid;
-			break;
+		for (int i = 0; i < max_effect_channels; ++i)
+		{
+			Panning::compute_first_order_gains(
+				device.channel_count_,
+				device.foa_,
+				mat4f_identity.m_[i],
+				1.0F,
+				channels_gains_[i]);
 		}
 
-		feedback_ = effect_props.flanger_.feedback_;
-		delay_ = static_cast<int>(effect_props.flanger_.delay_ * frequency);
+		// Calculate coefficients for the each type of filter. Note that the shelf
+		// filters' gain is for the reference frequency, which is the centerpoint
+		// of the transition band.
+		gain = std::max(std::sqrt(effect_props.equalizer_.low_gain_), 0.0625F); // Limit -24dB
+		freq_mult = effect_props.equalizer_.low_cutoff_ / frequency;
 
-		// The LFO depth is scaled to be relative to the sample delay.
-		depth_ = effect_props.flanger_.depth_ * delay_;
+		filter.set_params(
+			FilterType::low_shelf,
+			gain,
+			freq_mult,
+			FilterState::calc_rcp_q_from_slope(gain, 0.75F));
 
-		// Gains for left and right sides
-		Panning::calc_angle_coeffs(-Math::pi_2, 0.0F, 0.0F, coeffs);
-		Panning::compute_panning_gains(device.channel_count_, device.dry_, coeffs, 1.0F, sides_gains_[0]);
-		Panning::calc_angle_coeffs(Math::pi_2, 0.0F, 0.0F, coeffs);
-		Panning::compute_panning_gains(device.channel_count_, device.dry_, coeffs, 1.0F, sides_gains_[1]);
+		// Copy the filter coefficients for all input channels.
+		filter_[0].copy_params(filter);
 
-		const auto phase = effect_props.flanger_.phase_;
-		const auto rate = effect_props.flanger_.rate_;
+		gain = std::max(effect_props.equalizer_.mid1_gain_, 0.0625F);
+		freq_mult = effect_props.equalizer_.mid1_center_ / frequency;
 
-		if (!(rate > 0.0F))
-		{
-			lfo_scale_ = 0.0F;
-			lfo_range_ = 1;
-			lfo_disp_ = 0;
-		}
-		else
-		{
-			// Calculate LFO coefficient
-			lfo_range_ = static_cast<int>(frequency / rate + 0.5F);
+		filter.set_params(
+			FilterType::peaking,
+			gain,
+			freq_mult,
+			FilterState::calc_rcp_q_from_bandwidth(freq_mult, effect_props.equalizer_.mid1_width_));
 
-			switch (waveform_)
-			{
-			case Waveform::triangle:
-				lfo_scale_ = 4.0F / lfo_range_;
-				break;
+		filter_[1].copy_params(filter);
 
-			case Waveform::sinusoid:
-				lfo_scale_ = Math::tau / lfo_range_;
-				break;
-			}
+		gain = std::max(effect_props.equalizer_.mid2_gain_, 0.0625F);
+		freq_mult = effect_props.equalizer_.mid2_center_ / frequency;
 
-			// Calculate lfo phase displacement
-			if (phase >= 0)
-			{
-				lfo_disp_ = static_cast<int>(lfo_range_ * (phase / 360.0F));
-			}
-			else
+		filter.set_params(
+			FilterType::peaking,
+			gain,
+			freq_mult,
+			FilterState::calc_rcp_q_from_bandwidth(freq_mult, effect_props.equalizer_.mid2_width_));
+
+		filter_[2].copy_params(filter);
+
+		gain = std::max(std::sqrt(effect_props.equalizer_.high_gain_), 0.0625F);
+		freq_mult = effect_props.equalizer_.high_cutoff_ / frequency;
+
+		filter.set_params(
+			FilterType::high_shelf,
+			gain,
+			freq_mult,
+			FilterState::calc_rcp_q_from_slope(gain, 0.75F));
+
+		filter_[3].copy_params(filter);
+
+		// A band with the unity gain passes the samples through.
+		const bool is_band_active[filter_count] =
+		{
+			effect_props.equalizer_.low_gain_ != 1.0F,
+			effect_props.equalizer_.mid1_gain_ != 1.0F,
+			effect_props.equalizer_.mid2_gain_ != 1.0F,
+			effect_props.equalizer_.high_gain_ != 1.0F,
+		};
+
+		active_filter_count_ = 0;
+
+		for (int i = 0; i < filter_count; ++i)
+		{
+			if (is_band_active[i])
 			{
-				lfo_disp_ = static_cast<int>(lfo_range_ * ((360 + phase) / 360.0F));
+				active_filters_[active_filter_count_++] = i;
 			}
 		}
 	}
 
+	int do_get_tail_sample_count() const
+	{
+		return tail_sample_count_;
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
 		SampleBuffers& dst_samples,
-		const int channel_count) final
+		const int channel_count)
 	{
-		auto& left_buf = sample_buffers_[0];
-		auto& right_buf = sample_buffers_[1];
-		const auto buf_mask = buffer_length_ - 1;
-
-		for (int base = 0; base < sample_count; )
-		{
-			float temps[128][2];
-			int mod_delays[2][128];
-
-			const auto todo = std::min(128, sample_count - base);
-
-			switch (waveform_)
-			{
-			case Waveform::triangle:
-				get_triangle_delays(
-					mod_delays[0],
-					offset_ % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
-
-				get_triangle_delays(
-					mod_delays[1],
-					(offset_ + lfo_disp_) % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
+		auto& samples = sample_buffer_;
 
-				break;
+		const float* src_channels[max_effect_channels];
+		float* channels[max_effect_channels];
+		FilterBank<max_effect_channels>* filters[filter_count];
 
-			case Waveform::sinusoid:
-				get_sinusoid_delays(
-					mod_delays[0],
-					offset_ % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
+		for (int ft = 0; ft < max_effect_channels; ++ft)
+		{
+			channels[ft] = samples[ft].data();
+		}
 
-				get_sinusoid_delays(
-					mod_delays[1],
-					(offset_ + lfo_disp_) % lfo_range_,
-					lfo_range_,
-					lfo_scale_,
-					depth_,
-					delay_,
-					todo);
+		for (int i = 0; i < active_filter_count_; ++i)
+		{
+			filters[i] = &filter_[active_filters_[i]];
+		}
 
-				break;
-			}
+		for (int base = 0; base < sample_count; )
+		{
+			const auto td = std::min(max_update_samples, sample_count - base);
 
-			for (int i = 0; i < todo; ++i)
+			for (int ft = 0; ft < max_effect_channels; ++ft)
 			{
-				left_buf[offset_ & buf_mask] = src_samples[0][base + i];
-				temps[i][0] = left_buf[(offset_ - mod_delays[0][i]) & buf_mask] * feedback_;
-				left_buf[offset_ & buf_mask] += temps[i][0];
+				src_channels[ft] = &src_samples[ft][base];
+			}
 
-				right_buf[offset_ & buf_mask] = src_samples[0][base + i];
-				temps[i][1] = right_buf[(offset_ - mod_delays[1][i]) & buf_mask] * feedback_;
-				right_buf[offset_ & buf_mask] += temps[i][1];
+			// All the channels go through all the active stages at once.
+			FilterBankHelpers::process_cascade(
+				filters, active_filter_count_, max_effect_channels, td, src_channels, channels);
 
-				offset_ += 1;
-			}
+			update_skipped_filters(td, src_channels);
 
-			for (int c = 0; c < channel_count; ++c)
+			for (int ft = 0; ft < max_effect_channels; ++ft)
 			{
-				auto gain = sides_gains_[0][c];
-
-				if (std::abs(gain) > silence_threshold_gain)
+				for (int kt = 0; kt < channel_count; ++kt)
 				{
-					for (int i = 0; i < todo; i++)
+					const auto gain = channels_gains_[ft][kt];
+
+					if (!(std::abs(gain) > silence_threshold_gain))
 					{
-						dst_samples[c][i + base] += temps[i][0] * gain;
+						continue;
 					}
-				}
 
-				gain = sides_gains_[1][c];
-
-				if (std::abs(gain) > silence_threshold_gain)
-				{
-					for (int i = 0; i < todo; ++i)
+					for (int it = 0; it < td; ++it)
 					{
-						dst_samples[c][i + base] += temps[i][1] * gain;
+						dst_samples[kt][base + it] += gain * samples[ft][it];
 					}
 				}
 			}
 
-			base += todo;
+			base += td;
 		}
 	}
 
 
 private:
-	enum class Waveform
-	{
-		triangle = EffectProps::Flanger::waveform_triangle,
-		sinusoid = EffectProps::Flanger::waveform_sinusoid,
-	}; // Waveform
+	// The maximum number of sample frames per update.
+	static constexpr auto max_update_samples = 256;
 
-	using SampleBuffer = EffectSampleBuffer;
-	using SampleBuffers = std::array<SampleBuffer, 2>;
-	using SidesGains = std::array<Gains, 2>;
+	static constexpr auto filter_count = max_filter_cascade_stages;
 
+	using ChannelsGains = std::array<Gains, max_effect_channels>;
+	using Filters = std::array<FilterBank<max_effect_channels>, filter_count>;
+	using FilterIndices = std::array<int, filter_count>;
+	using StageSamples = MdArray<float, max_effect_channels, max_update_samples>;
 
-	SampleBuffers sample_buffers_;
-	int buffer_length_;
-	int offset_;
-	int lfo_range_;
-	float lfo_scale_;
-	int lfo_disp_;
 
-	// Gains for left and right sides
-	SidesGains sides_gains_;
+	// Effect gains for each channel
+	ChannelsGains channels_gains_;
 
-	// effect parameters
-	Waveform waveform_;
-	int delay_;
-	float depth_;
-	float feedback_;
+	// Effect parameters
+	Filters filter_;
 
+	// Indices of the filters of the bands with non-unity gain
+	FilterIndices active_filters_;
+	int active_filter_count_;
 
-	static void get_triangle_delays(
-		int* delays,
-		int offset,
-		const int lfo_range,
-		const float lfo_scale,
-		const float depth,
-		const int delay,
-		const int todo)
-	{
-		for (int i = 0; i < todo; ++i)
-		{
-			delays[i] = static_cast<int>((1.0F - std::abs(2.0F - (lfo_scale * offset))) * depth) + delay;
-			offset = (offset + 1) % lfo_range;
-		}
-	}
+	StageSamples sample_buffer_;
+	int tail_sample_count_;
 
-	static void get_sinusoid_delays(
-		int* delays,
-		int offset,
-		const int lfo_range,
-		const float lfo_scale,
-		const float depth,
-		const int delay,
-		const int todo)
+
+	// Keeps the history of the skipped filters as if they passed their input through,
+	// so a band may become active again without a click.
+	void update_skipped_filters(
+		const int sample_count,
+		const float* const* src_samples)
 	{
-		for (int i = 0; i < todo; ++i)
+		auto active_index = 0;
+		const FilterBank<max_effect_channels>* previous_filter = nullptr;
+
+		for (int i = 0; i < filter_count; ++i)
 		{
-			delays[i] = static_cast<int>(std::sin(lfo_scale * offset) * depth) + delay;
-			offset = (offset + 1) % lfo_range;
+			auto& filter = filter_[i];
+
+			if (active_index < active_filter_count_ && active_filters_[active_index] == i)
+			{
+				active_index += 1;
+				previous_filter = &filter;
+				continue;
+			}
+
+			if (previous_filter)
+			{
+				// The input of the filter is the output of the previous active one.
+				filter.x_[0] = previous_filter->y_[0];
+				filter.x_[1] = previous_filter->y_[1];
+				filter.y_[0] = previous_filter->y_[0];
+				filter.y_[1] = previous_filter->y_[1];
+			}
+			else
+			{
+				filter.process_pass_through(max_effect_channels, sample_count, src_samples);
+			}
 		}
 	}
-}; // FlangerEffectState
+}; // EqualizerEffectState
 
+constexpr int EqualizerEffectState::max_update_samples;
+constexpr int EqualizerEffectState::filter_count;
 
-EffectState* EffectStateFactory::create_flanger()
+
+EffectState* EffectStateFactory::create_equalizer()
 {
-	return create<FlangerEffectState>();
+	return create<EqualizerEffectState>();
 }
 
 
@@ -5560,11 +10920,12 @@ public:
 	RingModulatorEffectState()
 		:
 		EffectState{},
-		process_func_{},
+		carrier_func_{},
 		index_{},
 		step_{},
 		channels_gains_{},
-		filters_{}
+		filters_{},
+		tail_sample_count_{}
 	{
 	}
 
@@ -5579,10 +10940,7 @@ protected:
 		index_ = 0;
 		step_ = 1;
 
-		for (int i = 0; i < max_effect_channels; ++i)
-		{
-			filters_[i].clear();
-		}
+		filters_.clear();
 	}
 
 	void do_destruct() final
@@ -5592,7 +10950,7 @@ protected:
 	void do_update_device(
 		Device& device) final
 	{
-		static_cast<void>(device);
+		tail_sample_count_ = calc_filter_tail_sample_count(device.sampling_rate_);
 	}
 
 	void do_update(
@@ -5604,15 +10962,15 @@ protected:
 
 		if (effect_props.ring_modulator_.waveform_ == EffectProps::RingModulator::waveform_sinusoid)
 		{
-			process_func_ = modulate_sin;
+			carrier_func_ = generate_sin;
 		}
 		else if (effect_props.ring_modulator_.waveform_ == EffectProps::RingModulator::waveform_sawtooth)
 		{
-			process_func_ = modulate_saw;
+			carrier_func_ = generate_saw;
 		}
 		else
 		{
-			process_func_ = modulate_square;
+			carrier_func_ = generate_square;
 		}
 
 		step_ = static_cast<int>(effect_props.ring_modulator_.frequency_ * waveform_frac_one / device.sampling_rate_);
@@ -5626,14 +10984,11 @@ protected:
 		const auto cw = std::cos(Math::tau * effect_props.ring_modulator_.high_pass_cutoff_ / device.sampling_rate_);
 		const auto a = (2.0F - cw) - std::sqrt(std::pow(2.0F - cw, 2.0F) - 1.0F);
 
-		for (int i = 0; i < max_effect_channels; ++i)
-		{
-			filters_[i].b0_ = a;
-			filters_[i].b1_ = -a;
-			filters_[i].b2_ = 0.0F;
-			filters_[i].a1_ = -a;
-			filters_[i].a2_ = 0.0F;
-		}
+		filters_.b0_.fill(a);
+		filters_.b1_.fill(-a);
+		filters_.b2_.fill(0.0F);
+		filters_.a1_.fill(-a);
+		filters_.a2_.fill(0.0F);
 
 		dst_buffers_ = &device.sample_buffers_;
 		dst_channel_count_ = device.channel_count_;
@@ -5649,6 +11004,11 @@ protected:
 		}
 	}
 
+	int do_get_tail_sample_count() const final
+	{
+		return tail_sample_count_;
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
@@ -5657,13 +11017,33 @@ protected:
 	{
 		for (int base = 0; base < sample_count; )
 		{
-			float temps[2][128];
+			float filtered[max_effect_channels][128];
+			float carrier[128];
+			const float* src_channels[max_effect_channels];
+			float* filtered_channels[max_effect_channels];
 			const auto td = std::min(128, sample_count - base);
 
 			for (int j = 0; j < max_effect_channels; ++j)
 			{
-				filters_[j].process(td, &src_samples[j][base], temps[0]);
-				process_func_(temps[1], temps[0], index_, step_, td);
+				src_channels[j] = &src_samples[j][base];
+				filtered_channels[j] = filtered[j];
+			}
+
+			filters_.process(max_effect_channels, td, src_channels, filtered_channels);
+
+			// The carrier is the same for all the channels.
+			carrier_func_(carrier, index_, step_, td);
+
+			index_ = static_cast<int>((index_ + (static_cast<int64_t>(step_) * td)) & waveform_frac_mask);
+
+			for (int j = 0; j < max_effect_channels; ++j)
+			{
+				auto& samples = filtered[j];
+
+				for (int i = 0; i < td; ++i)
+				{
+					samples[i] *= carrier[i];
+				}
 
 				for (int k = 0; k < channel_count; ++k)
 				{
@@ -5676,17 +11056,11 @@ protected:
 
 					for (int i = 0; i < td; ++i)
 					{
-						dst_samples[k][base + i] += gain * temps[1][i];
+						dst_samples[k][base + i] += gain * samples[i];
 					}
 				}
 			}
 
-			for (int i = 0; i < td; ++i)
-			{
-				index_ += step_;
-				index_ &= waveform_frac_mask;
-			}
-
 			base += td;
 		}
 	}
@@ -5699,32 +11073,26 @@ private:
 
 
 	using ChannelsGains = std::array<Gains, max_effect_channels>;
-	using Filters = std::array<FilterState, max_effect_channels>;
+	using Filters = FilterBank<max_effect_channels>;
 
-	using ModulateFunc = float(*)(
+	using WaveformFunc = float(*)(
 		const int index);
 
-	using ProcessFunc = void(*)(
-		float* const dst,
-		const float* const src,
+	using CarrierFunc = void(*)(
+		float* const carrier,
 		int index,
 		const int step,
 		const int todo);
 
 
-	ProcessFunc process_func_;
+	CarrierFunc carrier_func_;
 	int index_;
 	int step_;
 	ChannelsGains channels_gains_;
 	Filters filters_;
+	int tail_sample_count_;
 
 
-	static float sin_func(
-		const int index)
-	{
-		return std::sin(index * (Math::tau / waveform_frac_one) - Math::pi) * 0.5F + 0.5F;
-	}
-
 	static float saw_func(
 		const int index)
 	{
@@ -5737,10 +11105,9 @@ private:
 		return static_cast<float>((index >> (waveform_frac_bits - 1)) & 1);
 	}
 
-	static void modulate(
-		const ModulateFunc func,
-		float* const dst,
-		const float* const src,
+	static void generate(
+		const WaveformFunc func,
+		float* const carrier,
 		int index,
 		const int step,
 		const int todo)
@@ -5749,38 +11116,46 @@ private:
 		{
 			index += step;
 			index &= waveform_frac_mask;
-			dst[i] = src[i] * func(index);
+			carrier[i] = func(index);
 		}
 	}
 
-	static void modulate_sin(
-		float* const dst,
-		const float* const src,
+	// The sinus is rotated by an oscillator instead of calculated for each sample.
+	static void generate_sin(
+		float* const carrier,
 		int index,
 		const int step,
 		const int todo)
 	{
-		modulate(sin_func, dst, src, index, step, todo);
+		constexpr auto index_to_phase = Math::tau / waveform_frac_one;
+
+		auto oscillator = QuadratureOscillator{};
+		oscillator.set_step(step * index_to_phase);
+		oscillator.set_phase((((index + step) & waveform_frac_mask) * index_to_phase) - Math::pi);
+
+		for (int i = 0; i < todo; ++i)
+		{
+			carrier[i] = (oscillator.get_sin() * 0.5F) + 0.5F;
+			oscillator.advance();
+		}
 	}
 
-	static void modulate_saw(
-		float* const dst,
-		const float* const src,
+	static void generate_saw(
+		float* const carrier,
 		int index,
 		const int step,
 		const int todo)
 	{
-		modulate(saw_func, dst, src, index, step, todo);
+		generate(saw_func, carrier, index, step, todo);
 	}
 
-	static void modulate_square(
-		float* const dst,
-		const float* const src,
+	static void generate_square(
+		float* const carrier,
 		int index,
 		const int step,
 		const int todo)
 	{
-		modulate(square_func, dst, src, index, step, todo);
+		generate(square_func, carrier, index, step, todo);
 	}
 }; // RingModulatorEffectState
 
@@ -5804,6 +11179,7 @@ public:
 		:
 		EffectState{},
 		is_eax_{},
+		is_vectorized_{},
 		filters_{},
 		delay_{},
 		early_delay_taps_{},
@@ -5820,7 +11196,8 @@ public:
 		offset_{},
 		a_format_samples_{},
 		reverb_samples_{},
-		early_samples_{}
+		early_samples_{},
+		tail_sample_count_{}
 	{
 	}
 
@@ -5834,6 +11211,12 @@ protected:
 	{
 		is_eax_ = false;
 
+#ifdef OALSFXPP_X86_SIMD
+		is_vectorized_ = CpuFeatures::get().has_sse2_;
+#else
+		is_vectorized_ = false;
+#endif
+
 		for (int i = 0; i < 4; ++i)
 		{
 			filters_[i].lp_.clear();
@@ -5878,6 +11261,8 @@ protected:
 		mod_.depth_ = 0.0F;
 		mod_.coeff_ = 0.0F;
 		mod_.filter_ = 0.0F;
+		mod_.oscillator_.reset();
+		mod_.oscillator_.set_step(Math::tau);
 
 		late_.density_gain_ = 0.0F;
 
@@ -6037,6 +11422,14 @@ protected:
 		// Update the modulator line.
 		update_modulator(effect_props.reverb_.modulation_time_, effect_props.reverb_.modulation_depth_, frequency);
 
+		// The decay time is the time to decay by 60dB, so scale it up
+		// to reach the silence threshold.
+		const auto max_decay_time = std::max({lf_decay_time, effect_props.reverb_.decay_time_, hf_decay_time});
+		const auto decay_scale = std::log(silence_threshold_gain) / std::log(0.001F);
+
+		tail_sample_count_ = late_feed_tap_ + static_cast<int>(
+			(effect_props.reverb_.late_reverb_delay_ + (max_decay_time * decay_scale)) * frequency);
+
 		// Update the late lines.
 		update_late_lines(
 			effect_props.reverb_.density_,
@@ -6075,13 +11468,17 @@ protected:
 		}
 	}
 
+	int do_get_tail_sample_count() const final
+	{
+		return tail_sample_count_;
+	}
+
 	void do_process(
 		const int sample_count,
 		const SampleBuffers& src_samples,
 		SampleBuffers& dst_samples,
 		const int channel_count) final
 	{
-		const auto reverb_func = (is_eax_ ? &ReverbEffectState::eax_verb_pass : &ReverbEffectState::verb_pass);
 		auto fade = static_cast<float>(fade_count_) / fade_samples;
 
 		// Process reverb for these samples.
@@ -6113,7 +11510,14 @@ protected:
 			}
 
 			// Process the samples for reverb.
-			fade = (this->*reverb_func)(todo, fade, a_format_samples_, early_samples_, reverb_samples_);
+			if (is_eax_)
+			{
+				fade = verb_pass<true>(todo, fade, a_format_samples_, early_samples_, reverb_samples_);
+			}
+			else
+			{
+				fade = verb_pass<false>(todo, fade, a_format_samples_, early_samples_, reverb_samples_);
+			}
 
 			if (fade_count_ < fade_samples)
 			{
@@ -6193,7 +11597,7 @@ private:
 	struct DelayLineI
 	{
 		using Line = std::array<float, 4>;
-		using Lines = std::vector<Line>;
+		using Lines = ArenaVector<Line>;
 
 		// The delay lines use interleaved samples, with the lengths being powers
 		// of 2 to allow the use of bit-masking instead of a modulus for wrapping.
@@ -6206,25 +11610,19 @@ private:
 			return (mask_ > 0 ? mask_ + 1 : 0);
 		}
 
+		// Note: The memory is kept to recycle the line.
 		void reset()
 		{
 			mask_ = 0;
-			lines_ = Lines{};
+			lines_.clear();
 		}
 
 		void initialize(
 			const int sample_count)
 		{
-			if (sample_count == get_sample_count())
-			{
-				lines_.clear();
-				lines_.resize(sample_count);
-				return;
-			}
-
-			reset();
-
 			mask_ = sample_count - 1;
+
+			lines_.clear();
 			lines_.resize(sample_count);
 		}
 	}; // DelayLineI
@@ -6280,6 +11678,9 @@ private:
 		float depth_;
 		float coeff_;
 		float filter_;
+
+		// Generates the sinus (steps once per index).
+		QuadratureOscillator oscillator_;
 	}; // Mod
 
 	struct Late
@@ -6331,6 +11732,9 @@ private:
 
 	bool is_eax_;
 
+	// Whether the 4-line frames are processed as vectors.
+	bool is_vectorized_;
+
 	// Master effect filters
 	Filters filters_;
 
@@ -6366,6 +11770,7 @@ private:
 	Samples a_format_samples_;
 	Samples reverb_samples_;
 	Samples early_samples_;
+	int tail_sample_count_;
 
 
 	// The B-Format to A-Format conversion matrix. The arrangement of rows is
@@ -7029,6 +12434,7 @@ private:
 
 		mod_.index_ = static_cast<int>(mod_.index_ * static_cast<int64_t>(range) / mod_.range_);
 		mod_.range_ = range;
+		mod_.oscillator_.set_step(Math::tau / range);
 
 		// The modulation depth effects the scale of the sinus, which changes how
 		// much extra delay is added to the delay line. This delay changing over
@@ -7363,48 +12769,30 @@ private:
 		return delay->lines_[offset & delay->mask_][c];
 	}
 
-	// Cross-faded delay line output routine.  Instead of interpolating the
-	// offsets, this interpolates (cross-fades) the outputs at each offset.
-	static float faded_delay_line_out(
-		const DelayLineI* delay,
-		const int off0,
-		const int off1,
-		const int c,
-		const float mu)
-	{
-		return Math::lerp(delay->lines_[off0 & delay->mask_][c], delay->lines_[off1 & delay->mask_][c], mu);
-	}
-
-	static float delay_out_faded(
+	// Cross-faded delay line output routine.  Instead of interpolating the
+	// offsets, this interpolates (cross-fades) the outputs at each offset.
+	static float faded_delay_line_out(
 		const DelayLineI* delay,
 		const int off0,
 		const int off1,
 		const int c,
 		const float mu)
 	{
-		return faded_delay_line_out(delay, off0, off1, c, mu);
+		return Math::lerp(delay->lines_[off0 & delay->mask_][c], delay->lines_[off1 & delay->mask_][c], mu);
 	}
 
-	static float delay_out_unfaded(
+	// Reads the line either cross-faded or at the first offset only.
+	template<bool TIsFaded>
+	static float delay_out(
 		const DelayLineI* delay,
 		const int off0,
 		const int off1,
 		const int c,
 		const float mu)
 	{
-		static_cast<void>(off1);
-		static_cast<void>(mu);
-
-		return delay_line_out(delay, off0, c);
+		return TIsFaded ? faded_delay_line_out(delay, off0, off1, c, mu) : delay_line_out(delay, off0, c);
 	}
 
-	using DelayOutFunc = float(*)(
-		const DelayLineI* delay,
-		const int off0,
-		const int off1,
-		const int c,
-		const float mu);
-
 	static void delay_line_in(
 		DelayLineI* delay,
 		const int offset,
@@ -7444,17 +12832,41 @@ private:
 		int* delays,
 		const int todo)
 	{
+		// Without any depth the read offsets are not modulated. Only keep the
+		// rhythm running.
+		if (mod_.depth_ == 0.0F && mod_.filter_ == 0.0F)
+		{
+			mod_.index_ = static_cast<int>((mod_.index_ + static_cast<int64_t>(todo)) % mod_.range_);
+
+			std::fill_n(delays, todo, 0);
+
+			return;
+		}
+
 		auto index = mod_.index_;
 		auto range = mod_.filter_;
+		auto& oscillator = mod_.oscillator_;
+
+		oscillator.set_phase(Math::tau * index / mod_.range_);
 
 		for (int i = 0; i < todo; ++i)
 		{
 			// Calculate the sinus rhythm (dependent on modulation time and the
 			// sampling rate).
-			const auto sinus = std::sin(Math::tau * index / mod_.range_);
+			const auto sinus = oscillator.get_sin();
 
 			// Step the modulation index forward, keeping it bound to its range.
-			index = (index + 1) % mod_.range_;
+			index += 1;
+
+			if (index == mod_.range_)
+			{
+				index = 0;
+				oscillator.reset();
+			}
+			else
+			{
+				oscillator.advance();
+			}
 
 			// The depth determines the range over which to read the input samples
 			// from, so it must be filtered to reduce the distortion caused by even
@@ -7527,11 +12939,11 @@ private:
 	// element with a scattering matrix (like the one above) and a diagonal
 	// matrix of delay elements.
 	//
-	// Two static specializations are used for transitional (cross-faded) delay
-	// line processing and non-transitional processing.
+	// Two specializations are used for transitional (cross-faded) delay line
+	// processing and non-transitional processing.
 	//
-	static void vector_allpass_x(
-		DelayOutFunc delay_out_func,
+	template<bool TIsFaded>
+	static void vector_allpass(
 		float* vec,
 		const int offset,
 		const float feed_coeff,
@@ -7546,7 +12958,7 @@ private:
 		{
 			auto input = vec[i];
 
-			vec[i] = delay_out_func(
+			vec[i] = delay_out<TIsFaded>(
 				&vap->delay_,
 				offset - vap->offsets_[i][0],
 				offset - vap->offsets_[i][1],
@@ -7561,30 +12973,6 @@ private:
 		delay_line_in4(&vap->delay_, offset, f);
 	}
 
-	static void vector_allpass_unfaded(
-		float* vec,
-		const int offset,
-		const float feed_coeff,
-		const float x_coeff,
-		const float y_coeff,
-		const float mu,
-		VecAllpass* vap)
-	{
-		vector_allpass_x(delay_out_unfaded, vec, offset, feed_coeff, x_coeff, y_coeff, mu, vap);
-	}
-
-	static void vector_allpass_faded(
-		float* vec,
-		const int offset,
-		const float feed_coeff,
-		const float x_coeff,
-		const float y_coeff,
-		const float mu,
-		VecAllpass* vap)
-	{
-		vector_allpass_x(delay_out_faded, vec, offset, feed_coeff, x_coeff, y_coeff, mu, vap);
-	}
-
 	// A helper to reverse vector components.
 	static void vector_reverse(
 		float vec[4])
@@ -7593,16 +12981,6 @@ private:
 		std::swap(vec[1], vec[2]);
 	}
 
-
-	using VectorAllpassFunc = void(*)(
-		float* vec,
-		const int offset,
-		const float feed_coeff,
-		const float x_coeff,
-		const float y_coeff,
-		const float mu,
-		VecAllpass* vap);
-
 	// This generates early reflections.
 	//
 	// This is done by obtaining the primary reflections (those arriving from the
@@ -7619,16 +12997,23 @@ private:
 	// Finally, the early response is reversed, scattered (based on diffusion),
 	// and fed into the late reverb section of the main delay line.
 	//
-	// Two static specializations are used for transitional (cross-faded) delay
-	// line processing and non-transitional processing.
+	// Two specializations are used for transitional (cross-faded) delay line
+	// processing and non-transitional processing.
 	//
-	void early_reflection_x(
-		VectorAllpassFunc vector_allpass_func,
-		DelayOutFunc delay_out_func,
+	template<bool TIsFaded>
+	void early_reflection(
 		const int todo,
 		float fade,
 		Samples& out)
 	{
+#ifdef OALSFXPP_X86_SIMD
+		if (is_vectorized_)
+		{
+			early_reflection4<TIsFaded>(todo, fade, out);
+			return;
+		}
+#endif
+
 		float f[4];
 		auto current_offset = offset_;
 
@@ -7636,20 +13021,20 @@ private:
 		{
 			for (int j = 0; j < 4; ++j)
 			{
-				f[j] = delay_out_func(
+				f[j] = delay_out<TIsFaded>(
 					&delay_,
 					current_offset - early_delay_taps_[j][0],
 					current_offset - early_delay_taps_[j][1],
 					j, fade) * early_delay_coeffs_[j];
 			}
 
-			vector_allpass_func(f, current_offset, ap_feed_coeff_, mix_x_, mix_y_, fade, &early_.vec_ap_);
+			vector_allpass<TIsFaded>(f, current_offset, ap_feed_coeff_, mix_x_, mix_y_, fade, &early_.vec_ap_);
 
 			delay_line_in4_rev(&early_.delay_, current_offset, f);
 
 			for (int j = 0; j < 4; ++j)
 			{
-				f[j] += delay_out_func(&early_.delay_,
+				f[j] += delay_out<TIsFaded>(&early_.delay_,
 					current_offset - early_.offsets_[j][0],
 					current_offset - early_.offsets_[j][1], j, fade
 				) * early_.coeffs_[j];
@@ -7671,22 +13056,6 @@ private:
 		}
 	}
 
-	void early_reflection_unfaded(
-		const int todo,
-		float fade,
-		Samples& out)
-	{
-		early_reflection_x(vector_allpass_unfaded, delay_out_unfaded, todo, fade, out);
-	}
-
-	void early_reflection_faded(
-		const int todo,
-		float fade,
-		Samples& out)
-	{
-		early_reflection_x(vector_allpass_faded, delay_out_faded, todo, fade, out);
-	}
-
 	// Applies a first order filter section.
 	static float first_order_filter(
 		const float in,
@@ -7729,16 +13098,23 @@ private:
 	// Finally, the lines are reversed (so they feed their opposite directions)
 	// and scattered with the FDN matrix before re-feeding the delay lines.
 	//
-	// Two static specializations are used for transitional (cross-faded) delay
-	// line processing and non-transitional processing.
+	// Two specializations are used for transitional (cross-faded) delay line
+	// processing and non-transitional processing.
 	//
-	void late_reverb_x(
-		VectorAllpassFunc vector_allpass_func,
-		DelayOutFunc delay_out_func,
+	template<bool TIsFaded>
+	void late_reverb(
 		const int todo,
 		float fade,
 		Samples& out)
 	{
+#ifdef OALSFXPP_X86_SIMD
+		if (is_vectorized_)
+		{
+			late_reverb4<TIsFaded>(todo, fade, out);
+			return;
+		}
+#endif
+
 		float f[4];
 		int moddelay[max_update_samples];
 
@@ -7750,7 +13126,7 @@ private:
 		{
 			for (int j = 0; j < 4; ++j)
 			{
-				f[j] = delay_out_func(
+				f[j] = delay_out<TIsFaded>(
 					&delay_,
 					current_offset - late_delay_taps_[j][0],
 					current_offset - late_delay_taps_[j][1],
@@ -7763,7 +13139,7 @@ private:
 
 			for (int j = 0; j < 4; ++j)
 			{
-				f[j] += delay_out_func(&late_.delay_,
+				f[j] += delay_out<TIsFaded>(&late_.delay_,
 					current_delay - late_.offsets_[j][0],
 					current_delay - late_.offsets_[j][1],
 					j,
@@ -7775,7 +13151,7 @@ private:
 				f[j] = late_t60_filter(j, f[j]);
 			}
 
-			vector_allpass_func(f, current_offset, ap_feed_coeff_, mix_x_, mix_y_, fade, &late_.vec_ap_);
+			vector_allpass<TIsFaded>(f, current_offset, ap_feed_coeff_, mix_x_, mix_y_, fade, &late_.vec_ap_);
 
 			for (int j = 0; j < 4; ++j)
 			{
@@ -7793,71 +13169,272 @@ private:
 		}
 	}
 
-	void late_reverb_unfaded(
-		const int todo,
-		float fade,
+#ifdef OALSFXPP_X86_SIMD
+	//
+	// Vector (4-line) Effect Processing
+	//
+	// The routines below mirror the ones above, but handle a frame of the four
+	// lines as one vector. The operations are evaluated in the same order, so
+	// the results are identical.
+	//
+
+	// Gathers a frame from the lines, each line read at its own tap.
+	OALSFXPP_TARGET("sse2")
+	static __m128 delay_line_out4(
+		const DelayLineI* delay,
+		const int offset,
+		const Taps& taps,
+		const int tap)
+	{
+		const auto& lines = delay->lines_;
+		const auto mask = delay->mask_;
+
+		return _mm_setr_ps(
+			lines[(offset - taps[0][tap]) & mask][0],
+			lines[(offset - taps[1][tap]) & mask][1],
+			lines[(offset - taps[2][tap]) & mask][2],
+			lines[(offset - taps[3][tap]) & mask][3]);
+	}
+
+	// See "delay_out".
+	template<bool TIsFaded>
+	OALSFXPP_TARGET("sse2")
+	static __m128 delay_out4(
+		const DelayLineI* delay,
+		const int offset,
+		const Taps& taps,
+		const __m128 mu)
+	{
+		const auto out0 = delay_line_out4(delay, offset, taps, 0);
+
+		if (!TIsFaded)
+		{
+			return out0;
+		}
+
+		const auto out1 = delay_line_out4(delay, offset, taps, 1);
+
+		return _mm_add_ps(out0, _mm_mul_ps(_mm_sub_ps(out1, out0), mu));
+	}
+
+	OALSFXPP_TARGET("sse2")
+	static void delay_line_in4(
+		DelayLineI* delay,
+		const int offset,
+		const __m128 in)
+	{
+		_mm_storeu_ps(delay->lines_[offset & delay->mask_].data(), in);
+	}
+
+	OALSFXPP_TARGET("sse2")
+	static __m128 vector_reverse4(
+		const __m128 vec)
+	{
+		return _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 1, 2, 3));
+	}
+
+	// See "vector_partial_scatter".
+	//
+	// The sums of the matrix rows are built from the shuffled and negated
+	// components, in the order of the scalar expressions.
+	OALSFXPP_TARGET("sse2")
+	static __m128 vector_partial_scatter4(
+		const __m128 vec,
+		const __m128 x_coeff,
+		const __m128 y_coeff)
+	{
+		const auto f0 = _mm_xor_ps(
+			_mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 1)),
+			_mm_setr_ps(0.0F, -0.0F, 0.0F, -0.0F));
+
+		const auto f1 = _mm_xor_ps(
+			_mm_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 2, 2)),
+			_mm_setr_ps(-0.0F, 0.0F, -0.0F, -0.0F));
+
+		const auto f2 = _mm_xor_ps(
+			_mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 3, 3, 3)),
+			_mm_setr_ps(0.0F, 0.0F, 0.0F, -0.0F));
+
+		return _mm_add_ps(_mm_mul_ps(x_coeff, vec), _mm_mul_ps(y_coeff, _mm_add_ps(_mm_add_ps(f0, f1), f2)));
+	}
+
+	// See "vector_allpass".
+	template<bool TIsFaded>
+	OALSFXPP_TARGET("sse2")
+	static __m128 vector_allpass4(
+		const __m128 vec,
+		const int offset,
+		const __m128 feed_coeff,
+		const __m128 x_coeff,
+		const __m128 y_coeff,
+		const __m128 mu,
+		VecAllpass* vap)
+	{
+		const auto out = _mm_sub_ps(
+			delay_out4<TIsFaded>(&vap->delay_, offset, vap->offsets_, mu),
+			_mm_mul_ps(feed_coeff, vec));
+
+		const auto f = _mm_add_ps(vec, _mm_mul_ps(feed_coeff, out));
+
+		delay_line_in4(&vap->delay_, offset, vector_partial_scatter4(f, x_coeff, y_coeff));
+
+		return out;
+	}
+
+	// Scatters a frame to the output lines.
+	OALSFXPP_TARGET("sse2")
+	static void store_frame(
+		const __m128 vec,
+		const int index,
 		Samples& out)
 	{
-		late_reverb_x(vector_allpass_unfaded, delay_out_unfaded, todo, fade, out);
+		float frame[4];
+
+		_mm_storeu_ps(frame, vec);
+
+		for (int j = 0; j < 4; ++j)
+		{
+			out[j][index] = frame[j];
+		}
 	}
 
-	void late_reverb_faded(
+	// See "early_reflection".
+	template<bool TIsFaded>
+	OALSFXPP_TARGET("sse2")
+	void early_reflection4(
 		const int todo,
 		float fade,
 		Samples& out)
 	{
-		late_reverb_x(vector_allpass_faded, delay_out_faded, todo, fade, out);
+		const auto early_delay_coeffs = _mm_loadu_ps(early_delay_coeffs_.data());
+		const auto early_coeffs = _mm_loadu_ps(early_.coeffs_.data());
+		const auto ap_feed_coeff = _mm_set1_ps(ap_feed_coeff_);
+		const auto mix_x = _mm_set1_ps(mix_x_);
+		const auto mix_y = _mm_set1_ps(mix_y_);
+
+		auto current_offset = offset_;
+
+		for (int i = 0; i < todo; ++i)
+		{
+			const auto mu = _mm_set1_ps(fade);
+
+			auto f = _mm_mul_ps(delay_out4<TIsFaded>(&delay_, current_offset, early_delay_taps_, mu), early_delay_coeffs);
+
+			f = vector_allpass4<TIsFaded>(f, current_offset, ap_feed_coeff, mix_x, mix_y, mu, &early_.vec_ap_);
+
+			delay_line_in4(&early_.delay_, current_offset, vector_reverse4(f));
+
+			f = _mm_add_ps(f, _mm_mul_ps(delay_out4<TIsFaded>(&early_.delay_, current_offset, early_.offsets_, mu), early_coeffs));
+
+			store_frame(f, i, out);
+
+			f = vector_partial_scatter4(vector_reverse4(f), mix_x, mix_y);
+
+			delay_line_in4(&delay_, current_offset - late_feed_tap_, f);
+
+			current_offset += 1;
+			fade += fade_step;
+		}
 	}
 
-	// Perform the non-EAX reverb pass on a given input sample, resulting in
-	// four-channel output.
-	float verb_pass(
+	// See "late_reverb".
+	//
+	// The states of the T60 filters are kept in vectors over the whole update.
+	template<bool TIsFaded>
+	OALSFXPP_TARGET("sse2")
+	void late_reverb4(
 		const int todo,
 		float fade,
-		const Samples& input,
-		Samples& early,
-		Samples& late)
+		Samples& out)
 	{
-		for (int c = 0; c < 4; ++c)
-		{
-			// Low-pass filter the incoming samples (use the early buffer as temp
-			// storage).
-			filters_[c].lp_.process(todo, input[c].data(), early[0].data());
+		int moddelay[max_update_samples];
 
-			// Feed the initial delay line.
-			for (int i = 0; i < todo; ++i)
-			{
-				delay_line_in(&delay_, offset_ + i, c, early[0][i]);
-			}
-		}
+		calc_modulation_delays(moddelay, todo);
 
-		if (fade < 1.0F)
-		{
-			// Generate early reflections.
-			early_reflection_faded(todo, fade, early);
+		const auto& filters = late_.filters_;
 
-			// Generate late reverb.
-			late_reverb_faded(todo, fade, late);
-			fade = std::min(1.0F, fade + (todo * fade_step));
-		}
-		else
+		const auto lf_coeff0 = _mm_setr_ps(filters[0].lf_coeffs_[0], filters[1].lf_coeffs_[0], filters[2].lf_coeffs_[0], filters[3].lf_coeffs_[0]);
+		const auto lf_coeff1 = _mm_setr_ps(filters[0].lf_coeffs_[1], filters[1].lf_coeffs_[1], filters[2].lf_coeffs_[1], filters[3].lf_coeffs_[1]);
+		const auto lf_coeff2 = _mm_setr_ps(filters[0].lf_coeffs_[2], filters[1].lf_coeffs_[2], filters[2].lf_coeffs_[2], filters[3].lf_coeffs_[2]);
+		const auto hf_coeff0 = _mm_setr_ps(filters[0].hf_coeffs_[0], filters[1].hf_coeffs_[0], filters[2].hf_coeffs_[0], filters[3].hf_coeffs_[0]);
+		const auto hf_coeff1 = _mm_setr_ps(filters[0].hf_coeffs_[1], filters[1].hf_coeffs_[1], filters[2].hf_coeffs_[1], filters[3].hf_coeffs_[1]);
+		const auto hf_coeff2 = _mm_setr_ps(filters[0].hf_coeffs_[2], filters[1].hf_coeffs_[2], filters[2].hf_coeffs_[2], filters[3].hf_coeffs_[2]);
+		const auto mid_coeff = _mm_setr_ps(filters[0].mid_coeff_, filters[1].mid_coeff_, filters[2].mid_coeff_, filters[3].mid_coeff_);
+
+		auto lf_in = _mm_setr_ps(filters[0].states_[0][0], filters[1].states_[0][0], filters[2].states_[0][0], filters[3].states_[0][0]);
+		auto lf_out = _mm_setr_ps(filters[0].states_[0][1], filters[1].states_[0][1], filters[2].states_[0][1], filters[3].states_[0][1]);
+		auto hf_in = _mm_setr_ps(filters[0].states_[1][0], filters[1].states_[1][0], filters[2].states_[1][0], filters[3].states_[1][0]);
+		auto hf_out = _mm_setr_ps(filters[0].states_[1][1], filters[1].states_[1][1], filters[2].states_[1][1], filters[3].states_[1][1]);
+
+		const auto density_gain = _mm_set1_ps(late_.density_gain_);
+		const auto ap_feed_coeff = _mm_set1_ps(ap_feed_coeff_);
+		const auto mix_x = _mm_set1_ps(mix_x_);
+		const auto mix_y = _mm_set1_ps(mix_y_);
+
+		auto current_offset = offset_;
+
+		for (int i = 0; i < todo; ++i)
 		{
-			// Generate early reflections.
-			early_reflection_unfaded(todo, fade, early);
+			const auto mu = _mm_set1_ps(fade);
 
-			// Generate late reverb.
-			late_reverb_unfaded(todo, fade, late);
+			auto f = _mm_mul_ps(delay_out4<TIsFaded>(&delay_, current_offset, late_delay_taps_, mu), density_gain);
+
+			const auto current_delay = current_offset - moddelay[i];
+
+			f = _mm_add_ps(f, delay_out4<TIsFaded>(&late_.delay_, current_delay, late_.offsets_, mu));
+
+			// The T60 damping filter sections (see "late_t60_filter").
+			const auto lf = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(lf_coeff0, f), _mm_mul_ps(lf_coeff1, lf_in)),
+				_mm_mul_ps(lf_coeff2, lf_out));
+
+			lf_in = f;
+			lf_out = lf;
+
+			const auto hf = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(hf_coeff0, lf), _mm_mul_ps(hf_coeff1, hf_in)),
+				_mm_mul_ps(hf_coeff2, hf_out));
+
+			hf_in = lf;
+			hf_out = hf;
+
+			f = _mm_mul_ps(mid_coeff, hf);
+
+			f = vector_allpass4<TIsFaded>(f, current_offset, ap_feed_coeff, mix_x, mix_y, mu, &late_.vec_ap_);
+
+			store_frame(f, i, out);
+
+			f = vector_partial_scatter4(vector_reverse4(f), mix_x, mix_y);
+
+			delay_line_in4(&late_.delay_, current_offset, f);
+
+			current_offset += 1;
+			fade += fade_step;
 		}
 
-		// Step all delays forward one sample.
-		offset_ += todo;
+		float states[4][4];
 
-		return fade;
+		_mm_storeu_ps(states[0], lf_in);
+		_mm_storeu_ps(states[1], lf_out);
+		_mm_storeu_ps(states[2], hf_in);
+		_mm_storeu_ps(states[3], hf_out);
+
+		for (int j = 0; j < 4; ++j)
+		{
+			late_.filters_[j].states_[0][0] = states[0][j];
+			late_.filters_[j].states_[0][1] = states[1][j];
+			late_.filters_[j].states_[1][0] = states[2][j];
+			late_.filters_[j].states_[1][1] = states[3][j];
+		}
 	}
+#endif // OALSFXPP_X86_SIMD
 
-	// Perform the EAX reverb pass on a given input sample, resulting in four-
-	// channel output.
-	float eax_verb_pass(
+	// Perform the reverb pass on a given input sample, resulting in four-channel
+	// output.
+	//
+	// The EAX reverb band-passes the incoming samples instead of low-passing them.
+	template<bool TIsEax>
+	float verb_pass(
 		const int todo,
 		float fade,
 		const Samples& input,
@@ -7866,34 +13443,40 @@ private:
 	{
 		for (int c = 0; c < 4; ++c)
 		{
-			// Band-pass the incoming samples. Use the early output lines for temp
+			// Filter the incoming samples. Use the early output lines for temp
 			// storage.
 			filters_[c].lp_.process(todo, input[c].data(), early[0].data());
-			filters_[c].hp_.process(todo, early[0].data(), early[1].data());
+
+			if (TIsEax)
+			{
+				filters_[c].hp_.process(todo, early[0].data(), early[1].data());
+			}
+
+			const auto& filtered = early[TIsEax ? 1 : 0];
 
 			// Feed the initial delay line.
-			for (int i = 0; i < todo; i++)
+			for (int i = 0; i < todo; ++i)
 			{
-				delay_line_in(&delay_, offset_ + i, c, early[1][i]);
+				delay_line_in(&delay_, offset_ + i, c, filtered[i]);
 			}
 		}
 
 		if (fade < 1.0F)
 		{
 			// Generate early reflections.
-			early_reflection_faded(todo, fade, early);
+			early_reflection<true>(todo, fade, early);
 
 			// Generate late reverb.
-			late_reverb_faded(todo, fade, late);
+			late_reverb<true>(todo, fade, late);
 			fade = std::min(1.0F, fade + (todo * fade_step));
 		}
 		else
 		{
 			// Generate early reflections.
-			early_reflection_unfaded(todo, fade, early);
+			early_reflection<false>(todo, fade, early);
 
 			// Generate late reverb.
-			late_reverb_unfaded(todo, fade, late);
+			late_reverb<false>(todo, fade, late);
 		}
 
 		// Step all delays forward.
@@ -7933,3 +13516,124 @@ EffectState* EffectStateFactory::create_reverb()
 
 
 } // oalsfxpp
+
+
+#ifdef OALSFXPP_RT_CHECKS
+
+// ==========================================================================
+// Global allocation functions
+//
+// Replaced to report the allocations made by the real-time safe calls.
+
+void* operator new(
+	std::size_t size)
+{
+	oalsfxpp::RtScope::check(oalsfxpp::RtChecks::ViolationType::allocation, size);
+
+	if (size == 0)
+	{
+		size = 1;
+	}
+
+	while (true)
+	{
+		const auto result = std::malloc(size);
+
+		if (result)
+		{
+			return result;
+		}
+
+		const auto new_handler = std::get_new_handler();
+
+		if (!new_handler)
+		{
+			throw std::bad_alloc{};
+		}
+
+		new_handler();
+	}
+}
+
+void* operator new[](
+	std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(
+	std::size_t size,
+	const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return operator new(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](
+	std::size_t size,
+	const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(
+	void* pointer) noexcept
+{
+	if (!pointer)
+	{
+		return;
+	}
+
+	oalsfxpp::RtScope::check(oalsfxpp::RtChecks::ViolationType::deallocation, 0);
+
+	std::free(pointer);
+}
+
+void operator delete[](
+	void* pointer) noexcept
+{
+	operator delete(pointer);
+}
+
+void operator delete(
+	void* pointer,
+	std::size_t size) noexcept
+{
+	static_cast<void>(size);
+
+	operator delete(pointer);
+}
+
+void operator delete[](
+	void* pointer,
+	std::size_t size) noexcept
+{
+	static_cast<void>(size);
+
+	operator delete(pointer);
+}
+
+void operator delete(
+	void* pointer,
+	const std::nothrow_t&) noexcept
+{
+	operator delete(pointer);
+}
+
+void operator delete[](
+	void* pointer,
+	const std::nothrow_t&) noexcept
+{
+	operator delete(pointer);
+}
+
+// Global allocation functions
+// ==========================================================================
+
+#endif // OALSFXPP_RT_CHECKS
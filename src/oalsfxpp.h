@@ -26,6 +26,8 @@ For a copy of the GNU General Public License see file COPYING.
 
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 
@@ -580,6 +582,157 @@ struct SendProps
 		const SendProps& b);
 }; // SendProps
 
+// A source of the memory for the instances.
+//
+// Implement it to place the memory of the instances into a custom heap
+// (e.g. a locked or a NUMA-local one).
+class MemoryResource
+{
+public:
+	virtual ~MemoryResource();
+
+
+	// Allocates a block of memory.
+	//
+	// The alignment is a power of two.
+	//
+	// Returns a block or null on error.
+	void* allocate(
+		const std::size_t size,
+		const std::size_t alignment);
+
+	// Frees a block of memory allocated by "allocate" with the same size and alignment.
+	void deallocate(
+		void* const pointer,
+		const std::size_t size,
+		const std::size_t alignment);
+
+
+	// Gets a resource of the global heap.
+	static MemoryResource* get_default();
+
+
+protected:
+	virtual void* do_allocate(
+		const std::size_t size,
+		const std::size_t alignment) = 0;
+
+	virtual void do_deallocate(
+		void* const pointer,
+		const std::size_t size,
+		const std::size_t alignment) = 0;
+}; // MemoryResource
+
+// Real-time safety checks of the mixing.
+//
+// If the library is built with OALSFXPP_RT_CHECKS defined, any memory allocation,
+// deallocation or blocking call made while mixing or applying the changes is reported
+// to the violation handler. Otherwise the checks are compiled out.
+//
+// Note: The worker threads (InitParams::worker_count_) are synchronized with a lock,
+// so the mixing with them is reported as a blocking call.
+//
+// Note: Without the pooled effect states (InitParams::are_effect_states_pooled_),
+// applying a change of the effect type allocates the new state, which is reported too.
+// Initialize the instances with the pooled states to run with the checks.
+class RtChecks
+{
+public:
+	enum class ViolationType
+	{
+		allocation,
+		deallocation,
+		blocking_call,
+	}; // ViolationType
+
+	struct Violation
+	{
+		ViolationType type_;
+
+		// The innermost checked call (e.g. "Api::mix" or "EffectState::process").
+		const char* call_site_;
+
+		// The class of the effect state involved or null.
+		const char* effect_state_;
+
+		// A size of the memory block (in bytes) or zero if not known.
+		std::size_t size_;
+	}; // Violation
+
+	using ViolationHandler = void (*)(
+		const Violation& violation,
+		void* user_data);
+
+
+	// Returns true if the checks are compiled in or false otherwise.
+	static bool is_enabled();
+
+	// Sets the violation handler.
+	//
+	// A null handler restores the default one, which writes the violation
+	// to the standard error and aborts the program.
+	//
+	// Note: The handler is global. Set it up before mixing.
+	static void set_violation_handler(
+		const ViolationHandler handler,
+		void* const user_data);
+}; // RtChecks
+
+// Initialization parameters.
+struct InitParams
+{
+	static constexpr auto default_channel_format = ChannelFormat::stereo;
+	static constexpr auto default_sampling_rate = 44'100;
+	static constexpr auto default_effect_count = 1;
+	static constexpr auto default_source_count = 1;
+	static constexpr auto default_block_size = 2'048;
+	static constexpr auto default_worker_count = 0;
+	static constexpr auto default_are_effect_states_pooled = false;
+	static constexpr auto default_distortion_oversampling_factor = 4;
+
+
+	ChannelFormat channel_format_;
+	int sampling_rate_;
+	int effect_count_;
+	int source_count_;
+
+	// A maximum number of samples processed at once (in sample frames).
+	//
+	// Small values reduce the working set, large ones reduce
+	// the per-block overhead.
+	int block_size_;
+
+	// A number of worker threads to process the effect slots in parallel
+	// with the mixing thread.
+	//
+	// Zero processes the effect slots on the mixing thread only.
+	int worker_count_;
+
+	// If set, the states of all effect types are created for each slot
+	// on initialization, so changing the effect type doesn't allocate memory.
+	// Otherwise, "Api::apply_changes" allocates the state of a new effect type.
+	bool are_effect_states_pooled_;
+
+	// An oversampling factor of the distortion effect (1, 2, 4 or 8).
+	//
+	// High factors reduce the aliasing of the distorted signal
+	// at the cost of CPU time. Factors above one delay the distorted signal
+	// by up to 20 samples.
+	int distortion_oversampling_factor_;
+
+	// A source of the memory for the instance (null for the global heap).
+	//
+	// The instance takes two blocks of it on initialization: a small one for the instance
+	// itself, and one for its buffers and effect states (see "Api::get_memory_size").
+	// Without the pooled effect states, the states of the effect types set later
+	// are allocated from it separately by "Api::apply_changes".
+	// The worker threads use the global heap. The resource should outlive the instance.
+	MemoryResource* memory_resource_;
+
+
+	void set_defaults();
+}; // InitParams
+
 struct ReverbPresets
 {
 	struct Default
@@ -779,6 +932,12 @@ public:
 		const int sampling_rate,
 		const int effect_count);
 
+	// Initializes the instance.
+	//
+	// Returns true on success or false otherwise.
+	bool initialize(
+		const InitParams& init_params);
+
 	// Gets instance's initialization flag.
 	//
 	// Returns true if the instance is initialized or false otherwise.
@@ -804,6 +963,31 @@ public:
 	// Returns an effect count or zero on error.
 	int get_effect_count() const;
 
+	// Gets a source count.
+	//
+	// Returns a source count or zero on error.
+	int get_source_count() const;
+
+	// Gets a block size.
+	//
+	// Returns a block size or zero on error.
+	int get_block_size() const;
+
+	// Gets a worker thread count.
+	//
+	// Returns a worker thread count or zero on error.
+	int get_worker_count() const;
+
+	// Gets an oversampling factor of the distortion effect.
+	//
+	// Returns an oversampling factor or zero on error.
+	int get_distortion_oversampling_factor() const;
+
+	// Gets a size of the memory block with the buffers and effect states of the instance (in bytes).
+	//
+	// Returns a size of the memory block or zero on error.
+	std::size_t get_memory_size() const;
+
 	// Gets the active effect's properties.
 	//
 	// Returns true on success or false otherwise.
@@ -839,33 +1023,138 @@ public:
 		const int effect_index,
 		const Effect& effect);
 
-	// Gets the active send's properties.
+	// Gets the active send's properties of the first source.
 	//
 	// Returns true on success or false otherwise.
 	bool get_send_props(
 		const int effect_index,
 		SendProps& send_props) const;
 
-	// Gets the deferred send's properties.
+	// Gets the deferred send's properties of the first source.
 	//
 	// Returns true on success or false otherwise.
 	bool get_deferred_send_props(
 		const int effect_index,
 		SendProps& send_props) const;
 
-	// Sets the deferred send's properties.
+	// Sets the deferred send's properties of the first source.
 	//
 	// Returns true on success or false otherwise.
 	bool set_send_props(
 		const int effect_index,
 		const SendProps& send_props);
 
+	// Gets the active send's properties of the source.
+	// A negative effect index selects the direct send.
+	//
+	// Returns true on success or false otherwise.
+	bool get_source_send_props(
+		const int source_index,
+		const int effect_index,
+		SendProps& send_props) const;
+
+	// Gets the deferred send's properties of the source.
+	// A negative effect index selects the direct send.
+	//
+	// Returns true on success or false otherwise.
+	bool get_deferred_source_send_props(
+		const int source_index,
+		const int effect_index,
+		SendProps& send_props) const;
+
+	// Sets the deferred send's properties of the source.
+	// A negative effect index selects the direct send.
+	//
+	// Returns true on success or false otherwise.
+	bool set_source_send_props(
+		const int source_index,
+		const int effect_index,
+		const SendProps& send_props);
+
 	// Applies all deferred changes.
 	//
+	// The changes are handed over to the mixing without blocking. They take effect
+	// at the next block boundary of "mix". So, one control thread may set up
+	// and apply the changes while another thread is mixing.
+	//
+	// Without the pooled effect states (InitParams::are_effect_states_pooled_),
+	// the state of a new effect type is created here, and the replaced one is destroyed
+	// by one of the next calls. A change of the effect type stays deferred
+	// if the state can't be created, or if too many of them are waiting for "mix".
+	//
 	// Returns true on success or false otherwise.
 	bool apply_changes();
 
+	// Suspends the effect.
+	//
+	// The suspended effect is muted and not processed, but keeps its state.
+	// Takes effect at the next block boundary of "mix".
+	//
+	// Returns true on success or false otherwise.
+	bool suspend_effect(
+		const int effect_index);
+
+	// Resumes the suspended effect.
+	//
+	// Takes effect at the next block boundary of "mix".
+	//
+	// Returns true on success or false otherwise.
+	bool resume_effect(
+		const int effect_index);
+
+	// Gets the effect's suspension flag.
+	//
+	// Returns true on success or false otherwise.
+	bool is_effect_suspended(
+		const int effect_index,
+		bool& is_suspended) const;
+
+	// Schedules the effect's properties to apply at the sample offset
+	// relative to the start of the next "mix" call.
+	//
+	// The properties are for the effect type applied at the moment,
+	// and they are ignored if the type is changed before the offset.
+	// The mixing splits the block at the offset, so the change is sample-accurate.
+	// Offsets beyond the next "mix" call are carried over to the following ones.
+	// The applied properties are updated immediately, and so are the deferred ones
+	// unless a change of the effect type is deferred.
+	//
+	// Returns true on success or false otherwise.
+	bool schedule_effect_props(
+		const int sample_offset,
+		const int effect_index,
+		const EffectProps& effect_props);
+
+	// Schedules the send's properties of the first source to apply at the sample offset
+	// relative to the start of the next "mix" call.
+	//
+	// See "schedule_source_send_props" for details.
+	//
+	// Returns true on success or false otherwise.
+	bool schedule_send_props(
+		const int sample_offset,
+		const int effect_index,
+		const SendProps& send_props);
+
+	// Schedules the send's properties of the source to apply at the sample offset
+	// relative to the start of the next "mix" call.
+	// A negative effect index selects the direct send.
+	//
+	// The mixing splits the block at the offset, so the change is sample-accurate.
+	// Offsets beyond the next "mix" call are carried over to the following ones.
+	// The applied and the deferred properties are updated immediately.
+	//
+	// Returns true on success or false otherwise.
+	bool schedule_source_send_props(
+		const int sample_offset,
+		const int source_index,
+		const int effect_index,
+		const SendProps& send_props);
+
 	// Mixes samples from the source buffer into the target one.
+	// Samples are fed into the first source, the rest of the sources are silent.
+	// The source and the target may be the same buffer (in-place mixing),
+	// otherwise they should not overlap.
 	// !!!WARNING!!! Mixed samples are NOT CLIPPED.
 	//
 	// Returns true on success or false otherwise.
@@ -874,6 +1163,59 @@ public:
 		const float* src_samples,
 		float* dst_samples);
 
+	// Mixes samples from the source buffers into the target one.
+	// There is one source buffer per source, and a null buffer denotes
+	// a silent source, which is skipped.
+	// The target may be one of the source buffers (in-place mixing),
+	// otherwise buffers should not overlap.
+	// !!!WARNING!!! Mixed samples are NOT CLIPPED.
+	//
+	// Returns true on success or false otherwise.
+	bool mix_sources(
+		const int sample_count,
+		const float* const* src_samples,
+		float* dst_samples);
+
+	// Mixes 16-bit integer samples from the source buffer into the target one.
+	// Samples are fed into the first source, the rest of the sources are silent.
+	// The source and the target may be the same buffer (in-place mixing),
+	// otherwise they should not overlap.
+	// Mixed samples are clipped. If "is_dithered" is true, a triangular
+	// dither is added before the quantization.
+	//
+	// Returns true on success or false otherwise.
+	bool mix_s16(
+		const int sample_count,
+		const std::int16_t* src_samples,
+		std::int16_t* dst_samples,
+		const bool is_dithered);
+
+	// Mixes 32-bit integer samples from the source buffer into the target one.
+	// Samples are fed into the first source, the rest of the sources are silent.
+	// The source and the target may be the same buffer (in-place mixing),
+	// otherwise they should not overlap.
+	// Mixed samples are clipped.
+	//
+	// Returns true on success or false otherwise.
+	bool mix_s32(
+		const int sample_count,
+		const std::int32_t* src_samples,
+		std::int32_t* dst_samples);
+
+	// Mixes samples from the source planes into the target ones.
+	// Each plane holds "sample_count" samples of one channel; plane count
+	// is equal to the channel count.
+	// Samples are fed into the first source, the rest of the sources are silent.
+	// A target plane may be the same as the source plane of the same channel
+	// (in-place mixing), otherwise planes should not overlap.
+	// !!!WARNING!!! Mixed samples are NOT CLIPPED.
+	//
+	// Returns true on success or false otherwise.
+	bool mix_planar(
+		const int sample_count,
+		const float* const* src_channels,
+		float* const* dst_channels);
+
 	// Uninitializes the instance.
 	void uninitialize();
 
@@ -899,6 +1241,27 @@ public:
 	// Gets the maximum allowed effect count.
 	static int get_max_effects();
 
+	// Gets the minimum allowed source count.
+	static int get_min_sources();
+
+	// Gets the maximum allowed source count.
+	static int get_max_sources();
+
+	// Gets the minimum allowed block size.
+	static int get_min_block_size();
+
+	// Gets the maximum allowed block size.
+	static int get_max_block_size();
+
+	// Gets the minimum allowed worker thread count.
+	static int get_min_workers();
+
+	// Gets the maximum allowed worker thread count.
+	static int get_max_workers();
+
+	// Gets the maximum number of the scheduled events which are not applied yet.
+	static int get_max_scheduled_events();
+
 	// Converts the channel count into the channel format.
 	//
 	// Returns a channel format or "none" on error.
@@ -921,6 +1284,140 @@ private:
 	mutable const char* error_message_;
 }; // Api
 
+// Throughput statistics of the scheduler.
+struct SchedulerStats
+{
+	// A number of "render" calls.
+	int render_count_;
+
+	// A number of rendered blocks.
+	long long block_count_;
+
+	// A number of rendered sample frames summed over all instances.
+	long long sample_count_;
+
+	// A wall-clock time spent in "render" (in seconds).
+	double wall_time_;
+
+	// A time spent in the instances' mixing summed over all threads (in seconds).
+	double busy_time_;
+
+
+	// Gets a number of rendered sample frames per second of the wall-clock time.
+	double get_throughput() const;
+
+	// Gets an average number of busy threads while rendering.
+	double get_parallelism() const;
+}; // SchedulerStats
+
+// Renders blocks of several independent instances in parallel.
+//
+// Each thread starts with the instances assigned to it by their estimated cost,
+// and takes the instances of another thread when it runs out of its own.
+class Scheduler
+{
+public:
+	Scheduler();
+
+	Scheduler(
+		const Scheduler& that) = delete;
+
+	Scheduler& operator=(
+		const Scheduler& that) = delete;
+
+	~Scheduler();
+
+
+	// Initializes the scheduler.
+	//
+	// Worker threads render in parallel with the thread which calls "render".
+	// So, "std::thread::hardware_concurrency() - 1" workers saturate all cores.
+	//
+	// Returns true on success or false otherwise.
+	bool initialize(
+		const int worker_count);
+
+	// Gets scheduler's initialization flag.
+	//
+	// Returns true if the scheduler is initialized or false otherwise.
+	bool is_initialized() const;
+
+	// Uninitializes the scheduler and destroys the instances.
+	void uninitialize();
+
+	// Gets a last error message.
+	const char* get_error_message() const;
+
+	// Creates an instance owned by the scheduler.
+	//
+	// Returns an index of the instance or a negative value on error.
+	int add_instance(
+		const InitParams& init_params);
+
+	// Gets an instance count.
+	//
+	// Returns an instance count or zero on error.
+	int get_instance_count() const;
+
+	// Gets an instance to set up.
+	//
+	// Note: The instances should not be accessed while rendering.
+	//
+	// Returns an instance or nullptr on error.
+	Api* get_instance(
+		const int instance_index);
+
+	// Queues a block of the instance to render by the next "render" call.
+	//
+	// The samples are the same as for Api::mix.
+	// The instances without a queued block are not rendered.
+	//
+	// Returns true on success or false otherwise.
+	bool set_block(
+		const int instance_index,
+		const int sample_count,
+		const float* const src_samples,
+		float* const dst_samples);
+
+	// Renders the queued blocks and waits for their completion.
+	//
+	// Returns true on success or false otherwise.
+	bool render();
+
+	// Gets an estimated cost of the instance (in seconds per sample frame).
+	//
+	// Returns an estimated cost, or zero if the instance has not been rendered yet or on error.
+	double get_instance_cost(
+		const int instance_index) const;
+
+	// Gets the throughput statistics.
+	//
+	// Returns true on success or false otherwise.
+	bool get_stats(
+		SchedulerStats& stats) const;
+
+	// Resets the throughput statistics.
+	//
+	// Returns true on success or false otherwise.
+	bool reset_stats();
+
+
+	// Gets the minimum allowed worker thread count.
+	static int get_min_workers();
+
+	// Gets the maximum allowed worker thread count.
+	static int get_max_workers();
+
+
+private:
+	class Impl;
+	using SchedulerImplUPtr = std::unique_ptr<Impl>;
+
+
+	SchedulerImplUPtr pimpl_;
+	mutable const char* error_message_;
+}; // Scheduler
+
 
 } // oalsfxpp
 
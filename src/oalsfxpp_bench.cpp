@@ -0,0 +1,256 @@
+/*
+A standalone OpenAL Soft effects for C++.
+
+Copyright (C) 2017 Boris I. Bendovsky (bibendovsky@hotmail.com)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+For a copy of the GNU General Public License see file COPYING.
+*/
+
+
+//
+// Measures the mixing time per sample frame of the effects.
+//
+// The steady reverb cases run the non-transitional (unfaded) path. The
+// cross-fading cases switch between two presets on every block, so the delay
+// lines are always cross-faded. The modulated effects use the sinusoid.
+//
+
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "oalsfxpp.h"
+
+
+struct BenchCase
+{
+	const char* name_;
+	oalsfxpp::EffectType effect_type_;
+	bool is_cross_fading_;
+	int distortion_oversampling_factor_;
+}; // BenchCase
+
+
+class Bench
+{
+public:
+	static constexpr int sampling_rate = 44100;
+	static constexpr int channel_count = 2;
+
+	// Matches the cross-fade length of the reverb.
+	static constexpr int block_size = 128;
+
+
+	Bench(
+		const int duration)
+		:
+		frame_count_{duration * sampling_rate},
+		src_samples_(frame_count_ * channel_count),
+		dst_samples_(frame_count_ * channel_count)
+	{
+		auto seed = std::uint32_t{1};
+
+		for (auto& sample : src_samples_)
+		{
+			seed = (seed * 1664525U) + 1013904223U;
+			sample = (static_cast<int>(seed >> 16) - 32768) / 65536.0F;
+		}
+	}
+
+	// Runs the case.
+	//
+	// Returns the mixing time in nanoseconds per sample frame or a negative value on error.
+	double run(
+		const BenchCase& bench_case)
+	{
+		auto init_params = oalsfxpp::InitParams{};
+		init_params.set_defaults();
+		init_params.channel_format_ = oalsfxpp::ChannelFormat::stereo;
+		init_params.sampling_rate_ = sampling_rate;
+		init_params.distortion_oversampling_factor_ = bench_case.distortion_oversampling_factor_;
+
+		// Changing the effect type doesn't allocate memory (see oalsfxpp::RtChecks).
+		init_params.are_effect_states_pooled_ = true;
+
+		oalsfxpp::Api api;
+
+		if (!api.initialize(init_params))
+		{
+			std::cout << api.get_error_message() << std::endl;
+			return -1.0;
+		}
+
+		auto effect = oalsfxpp::Effect{};
+		effect.set_type_and_defaults(bench_case.effect_type_);
+
+		const oalsfxpp::EffectProps::Reverb* presets[] =
+		{
+			&oalsfxpp::ReverbPresets::Default::room,
+			&oalsfxpp::ReverbPresets::Default::cave,
+		};
+
+		switch (bench_case.effect_type_)
+		{
+		case oalsfxpp::EffectType::reverb:
+		case oalsfxpp::EffectType::eax_reverb:
+			effect.props_.reverb_ = *presets[0];
+			break;
+
+		case oalsfxpp::EffectType::chorus:
+			effect.props_.chorus_.waveform_ = oalsfxpp::EffectProps::Chorus::waveform_sinusoid;
+			break;
+
+		case oalsfxpp::EffectType::equalizer:
+			// Non-unity gains to filter through all the bands.
+			effect.props_.equalizer_.low_gain_ = 2.0F;
+			effect.props_.equalizer_.mid1_gain_ = 0.5F;
+			effect.props_.equalizer_.mid2_gain_ = 1.5F;
+			effect.props_.equalizer_.high_gain_ = 0.7F;
+			break;
+
+		case oalsfxpp::EffectType::flanger:
+			effect.props_.flanger_.waveform_ = oalsfxpp::EffectProps::Flanger::waveform_sinusoid;
+			break;
+
+		case oalsfxpp::EffectType::ring_modulator:
+			effect.props_.ring_modulator_.waveform_ = oalsfxpp::EffectProps::RingModulator::waveform_sinusoid;
+			break;
+
+		default:
+			break;
+		}
+
+		api.set_effect_type(0, bench_case.effect_type_);
+		api.set_effect_props(0, effect.props_);
+		api.apply_changes();
+
+		const auto begin_time = std::chrono::steady_clock::now();
+
+		for (int i = 0, block_index = 0; i < frame_count_; i += block_size, ++block_index)
+		{
+			if (bench_case.is_cross_fading_)
+			{
+				effect.props_.reverb_ = *presets[(block_index + 1) % 2];
+				api.set_effect_props(0, effect.props_);
+				api.apply_changes();
+			}
+
+			const auto frame_count = std::min(block_size, frame_count_ - i);
+			const auto offset = i * channel_count;
+
+			api.mix(frame_count, &src_samples_[offset], &dst_samples_[offset]);
+		}
+
+		const auto end_time = std::chrono::steady_clock::now();
+		const auto duration = std::chrono::duration<double, std::nano>(end_time - begin_time);
+
+		return duration.count() / frame_count_;
+	}
+
+
+private:
+	using Samples = std::vector<float>;
+
+
+	int frame_count_;
+	Samples src_samples_;
+	Samples dst_samples_;
+}; // Bench
+
+
+constexpr int Bench::sampling_rate;
+constexpr int Bench::channel_count;
+constexpr int Bench::block_size;
+
+
+int main(
+	int argc,
+	char* argv[])
+{
+	if (argc > 2)
+	{
+		std::cout << "Usage:" << std::endl;
+		std::cout << "program [duration_in_seconds]" << std::endl;
+		return 1;
+	}
+
+	auto duration = 20;
+
+	if (argc == 2)
+	{
+		try
+		{
+			duration = std::stoi(argv[1]);
+		}
+		catch (const std::exception&)
+		{
+			duration = 0;
+		}
+
+		if (duration <= 0)
+		{
+			std::cout << "Invalid duration." << std::endl;
+			return 1;
+		}
+	}
+
+	constexpr auto default_factor = oalsfxpp::InitParams::default_distortion_oversampling_factor;
+
+	const BenchCase bench_cases[] =
+	{
+		{"Reverb (steady)", oalsfxpp::EffectType::reverb, false, default_factor},
+		{"Reverb (cross-fading)", oalsfxpp::EffectType::reverb, true, default_factor},
+		{"EAX Reverb (steady)", oalsfxpp::EffectType::eax_reverb, false, default_factor},
+		{"EAX Reverb (cross-fading)", oalsfxpp::EffectType::eax_reverb, true, default_factor},
+		{"Chorus", oalsfxpp::EffectType::chorus, false, default_factor},
+		{"Distortion (1x)", oalsfxpp::EffectType::distortion, false, 1},
+		{"Distortion (2x)", oalsfxpp::EffectType::distortion, false, 2},
+		{"Distortion (4x)", oalsfxpp::EffectType::distortion, false, 4},
+		{"Distortion (8x)", oalsfxpp::EffectType::distortion, false, 8},
+		{"Echo", oalsfxpp::EffectType::echo, false, default_factor},
+		{"Equalizer", oalsfxpp::EffectType::equalizer, false, default_factor},
+		{"Flanger", oalsfxpp::EffectType::flanger, false, default_factor},
+		{"Ring modulator", oalsfxpp::EffectType::ring_modulator, false, default_factor},
+	};
+
+	auto bench = Bench{duration};
+
+	std::cout << "Stereo, " << Bench::sampling_rate << " Hz, " << duration << " s per case." << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+
+	for (const auto& bench_case : bench_cases)
+	{
+		const auto ns_per_frame = bench.run(bench_case);
+
+		if (ns_per_frame < 0.0)
+		{
+			return 2;
+		}
+
+		const auto real_time_factor = 1.0E9 / (ns_per_frame * Bench::sampling_rate);
+
+		std::cout <<
+			std::setw(28) << std::left << bench_case.name_ <<
+			std::setw(8) << std::right << ns_per_frame << " ns/frame" <<
+			std::setw(10) << real_time_factor << "x real time" << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,378 @@
+/*
+A standalone OpenAL Soft effects for C++.
+
+Copyright (C) 2017 Boris I. Bendovsky (bibendovsky@hotmail.com)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+For a copy of the GNU General Public License see file COPYING.
+*/
+
+
+//
+// Checks the behavior of the API.
+//
+// Each case prints its name and the result. The program returns zero
+// if all cases pass. Build it with OALSFXPP_RT_CHECKS defined
+// to check the real-time safety too (see oalsfxpp_rt_check).
+//
+
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "oalsfxpp.h"
+
+
+struct CheckCase
+{
+	const char* name_;
+	bool (*func_)();
+}; // CheckCase
+
+
+class Check
+{
+public:
+	static constexpr int sampling_rate = 44100;
+	static constexpr int channel_count = 2;
+	static constexpr int frame_count = 256;
+
+
+	// Initializes the instance with one effect.
+	//
+	// Returns true on success or false otherwise.
+	static bool initialize(
+		oalsfxpp::Api& api,
+		const bool are_effect_states_pooled = false)
+	{
+		auto init_params = oalsfxpp::InitParams{};
+		init_params.set_defaults();
+		init_params.channel_format_ = oalsfxpp::ChannelFormat::stereo;
+		init_params.sampling_rate_ = sampling_rate;
+		init_params.are_effect_states_pooled_ = are_effect_states_pooled;
+
+		if (!api.initialize(init_params))
+		{
+			std::cout << api.get_error_message() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	// Mixes a block of noise.
+	//
+	// Returns true on success or false otherwise.
+	static bool mix(
+		oalsfxpp::Api& api)
+	{
+		auto samples = std::vector<float>(frame_count * channel_count);
+		auto seed = std::uint32_t{1};
+
+		for (auto& sample : samples)
+		{
+			seed = (seed * 1664525U) + 1013904223U;
+			sample = (static_cast<int>(seed >> 16) - 32768) / 65536.0F;
+		}
+
+		is_mixing_ = true;
+
+		const auto is_mixed = api.mix(frame_count, samples.data(), samples.data());
+
+		is_mixing_ = false;
+
+		if (!is_mixed)
+		{
+			std::cout << api.get_error_message() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	// Changes the effect type to every one in turn and mixes a block with each.
+	//
+	// Returns true on success or false otherwise.
+	static bool mix_effect_types(
+		oalsfxpp::Api& api)
+	{
+		const oalsfxpp::EffectType effect_types[] =
+		{
+			oalsfxpp::EffectType::eax_reverb,
+			oalsfxpp::EffectType::reverb,
+			oalsfxpp::EffectType::chorus,
+			oalsfxpp::EffectType::compressor,
+			oalsfxpp::EffectType::dedicated_dialog,
+			oalsfxpp::EffectType::dedicated_low_frequency,
+			oalsfxpp::EffectType::distortion,
+			oalsfxpp::EffectType::echo,
+			oalsfxpp::EffectType::equalizer,
+			oalsfxpp::EffectType::flanger,
+			oalsfxpp::EffectType::ring_modulator,
+			oalsfxpp::EffectType::null,
+		};
+
+		for (const auto effect_type : effect_types)
+		{
+			api.set_effect_type(0, effect_type);
+
+			if (!api.apply_changes())
+			{
+				std::cout << api.get_error_message() << std::endl;
+				return false;
+			}
+
+			if (!mix(api))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Counts the real-time safety violations while mixing and the rest of them.
+	static void count_rt_violation(
+		const oalsfxpp::RtChecks::Violation& violation,
+		void* const user_data)
+	{
+		static_cast<void>(user_data);
+
+		if (is_mixing_)
+		{
+			mix_rt_violation_count_ += 1;
+
+			std::cout << "Violation in " << violation.call_site_ << " (effect state: " <<
+				(violation.effect_state_ ? violation.effect_state_ : "none") << ")." << std::endl;
+		}
+		else
+		{
+			other_rt_violation_count_ += 1;
+		}
+	}
+
+	// With the pooled effect states, neither mixing nor applying changes
+	// of the effect type allocates memory or blocks.
+	//
+	// Note: Without the real-time safety checks compiled in it only changes the types.
+	static bool pooled_effect_types_are_rt_safe()
+	{
+		oalsfxpp::Api api;
+
+		if (!initialize(api, true))
+		{
+			return false;
+		}
+
+		reset_rt_violations();
+
+		const auto is_mixed = mix_effect_types(api);
+
+		return is_mixed && mix_rt_violation_count_ == 0 && other_rt_violation_count_ == 0;
+	}
+
+	// Without the pooled effect states, the states are created and destroyed
+	// by applying the changes, but not while mixing.
+	static bool unpooled_effect_types_mix_rt_safe()
+	{
+		oalsfxpp::Api api;
+
+		if (!initialize(api))
+		{
+			return false;
+		}
+
+		reset_rt_violations();
+
+		const auto is_mixed = mix_effect_types(api);
+
+		return is_mixed && mix_rt_violation_count_ == 0;
+	}
+
+	// Scheduled effect properties are not reverted by applying an unrelated change.
+	static bool scheduled_effect_props_survive_apply()
+	{
+		oalsfxpp::Api api;
+
+		if (!initialize(api))
+		{
+			return false;
+		}
+
+		api.set_effect_type(0, oalsfxpp::EffectType::reverb);
+		api.apply_changes();
+
+		if (!mix(api))
+		{
+			return false;
+		}
+
+		auto effect = oalsfxpp::Effect{};
+		api.get_effect(0, effect);
+
+		effect.props_.reverb_.gain_ = 0.9F;
+
+		if (!api.schedule_effect_props(frame_count / 2, 0, effect.props_))
+		{
+			std::cout << api.get_error_message() << std::endl;
+			return false;
+		}
+
+		auto send_props = oalsfxpp::SendProps{};
+		send_props.set_defaults();
+		send_props.gain_ = 0.5F;
+
+		api.set_source_send_props(0, -1, send_props);
+		api.apply_changes();
+
+		if (!mix(api))
+		{
+			return false;
+		}
+
+		auto deferred_effect = oalsfxpp::Effect{};
+		api.get_effect(0, effect);
+		api.get_deferred_effect(0, deferred_effect);
+
+		return effect.props_.reverb_.gain_ == 0.9F && deferred_effect.props_.reverb_.gain_ == 0.9F;
+	}
+
+	// Scheduled send properties are not reverted by applying without changes.
+	static bool scheduled_send_props_survive_apply()
+	{
+		oalsfxpp::Api api;
+
+		if (!initialize(api))
+		{
+			return false;
+		}
+
+		auto send_props = oalsfxpp::SendProps{};
+		send_props.set_defaults();
+		send_props.gain_ = 0.25F;
+
+		if (!api.schedule_source_send_props(0, 0, 0, send_props))
+		{
+			std::cout << api.get_error_message() << std::endl;
+			return false;
+		}
+
+		api.apply_changes();
+
+		if (!mix(api))
+		{
+			return false;
+		}
+
+		auto deferred_send_props = oalsfxpp::SendProps{};
+		api.get_source_send_props(0, 0, send_props);
+		api.get_deferred_source_send_props(0, 0, deferred_send_props);
+
+		return send_props.gain_ == 0.25F && deferred_send_props.gain_ == 0.25F;
+	}
+
+	// A failed initialization reports the error message.
+	static bool failed_initialization_is_reported()
+	{
+		auto init_params = oalsfxpp::InitParams{};
+		init_params.set_defaults();
+		init_params.sampling_rate_ = 0;
+
+		oalsfxpp::Api api;
+
+		if (api.initialize(init_params))
+		{
+			return false;
+		}
+
+		return std::string{api.get_error_message()} == "Sampling rate is out of range.";
+	}
+
+	// Scheduling at a negative offset fails with the error message.
+	static bool scheduled_offset_out_of_range_is_reported()
+	{
+		oalsfxpp::Api api;
+
+		if (!initialize(api))
+		{
+			return false;
+		}
+
+		auto send_props = oalsfxpp::SendProps{};
+		send_props.set_defaults();
+
+		if (api.schedule_source_send_props(-1, 0, 0, send_props))
+		{
+			return false;
+		}
+
+		return std::string{api.get_error_message()} == "Sample offset is out of range.";
+	}
+
+
+private:
+	static bool is_mixing_;
+	static int mix_rt_violation_count_;
+	static int other_rt_violation_count_;
+
+
+	static void reset_rt_violations()
+	{
+		mix_rt_violation_count_ = 0;
+		other_rt_violation_count_ = 0;
+	}
+}; // Check
+
+bool Check::is_mixing_ = false;
+int Check::mix_rt_violation_count_ = 0;
+int Check::other_rt_violation_count_ = 0;
+
+
+int main()
+{
+	const CheckCase check_cases[] =
+	{
+		{"Failed initialization is reported", Check::failed_initialization_is_reported},
+		{"Scheduled effect properties survive applying", Check::scheduled_effect_props_survive_apply},
+		{"Scheduled send properties survive applying", Check::scheduled_send_props_survive_apply},
+		{"Scheduled offset out of range is reported", Check::scheduled_offset_out_of_range_is_reported},
+		{"Pooled effect type changes are real-time safe", Check::pooled_effect_types_are_rt_safe},
+		{"Unpooled effect type changes mix real-time safe", Check::unpooled_effect_types_mix_rt_safe},
+	};
+
+	// The cases count the violations they expect.
+	oalsfxpp::RtChecks::set_violation_handler(Check::count_rt_violation, nullptr);
+
+	std::cout << "Real-time safety checks are " <<
+		(oalsfxpp::RtChecks::is_enabled() ? "enabled." : "disabled.") << std::endl;
+
+	auto failed_count = 0;
+
+	for (const auto& check_case : check_cases)
+	{
+		const auto is_passed = check_case.func_();
+
+		if (!is_passed)
+		{
+			failed_count += 1;
+		}
+
+		std::cout << (is_passed ? "PASSED: " : "FAILED: ") << check_case.name_ << std::endl;
+	}
+
+	return (failed_count == 0 ? 0 : 1);
+}
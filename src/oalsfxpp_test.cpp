@@ -658,6 +658,11 @@ public:
 		return samples_;
 	}
 
+	SampleBuffer& get_samples()
+	{
+		return samples_;
+	}
+
 	int get_channel_count() const
 	{
 		return channel_count_;
@@ -775,9 +780,15 @@ int main(
 
 	if (is_succeed)
 	{
-		const auto channel_format = oalsfxpp::Api::channel_count_to_channel_format(wav_file.get_channel_count());
+		auto init_params = oalsfxpp::InitParams{};
+		init_params.set_defaults();
+		init_params.channel_format_ = oalsfxpp::Api::channel_count_to_channel_format(wav_file.get_channel_count());
+		init_params.sampling_rate_ = wav_file.get_sampling_rate();
+
+		// Changing the effect type doesn't allocate memory (see oalsfxpp::RtChecks).
+		init_params.are_effect_states_pooled_ = true;
 
-		is_succeed = api.initialize(channel_format, wav_file.get_sampling_rate(), 1);
+		is_succeed = api.initialize(init_params);
 
 		if (!is_succeed)
 		{
@@ -884,13 +895,11 @@ int main(
 
 	if (is_succeed)
 	{
-		const auto& src_samples = wav_file.get_samples();
-		auto dst_samples = WavFile::SampleBuffer{};
-		dst_samples.resize(src_samples.size());
+		auto& samples = wav_file.get_samples();
 
-		api.mix(wav_file.get_sample_count(), src_samples.data(), dst_samples.data());
+		api.mix(wav_file.get_sample_count(), samples.data(), samples.data());
 
-		if (!wav_file.write_pcm_s16_le(dst_file_name, dst_samples))
+		if (!wav_file.write_pcm_s16_le(dst_file_name, samples))
 		{
 			is_succeed = false;
 			std::cout << wav_file.get_error_message() << std::endl;